@@ -28,6 +28,26 @@
 
 #include <QByteArray>
 
+#if (defined(HAVE_ZSTD))
+
+    #include <zstd.h>
+    #include <zdict.h>
+
+#endif
+
+#if (defined(HAVE_LZ4))
+
+    #include <lz4.h>
+    #include <lz4hc.h>
+
+#endif
+
+#if (defined(HAVE_LZMA))
+
+    #include <lzma.h>
+
+#endif
+
 #include <string>
 #include <vector>
 #include <iostream>
@@ -36,102 +56,8889 @@
 #include <ios>
 #include <iomanip>
 #include <algorithm>
+#include <unordered_map>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
 #include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "deflate_encoder.h"
+
+/**
+ * Enumeration of supported codecs.
+ */
+enum class Codec {
+    /**
+     * Indicates the payload is stored without compression.
+     */
+    NONE,
+
+    /**
+     * Indicates the payload is compressed using Qt's variant of zlib.  The payload can be decompressed using
+     * qUncompress.
+     */
+    QT_ZLIB,
+
+    /**
+     * Indicates the payload is compressed as a single Zstandard frame.
+     */
+    ZSTD,
+
+    /**
+     * Indicates the payload is compressed as a single raw LZ4 block.
+     */
+    LZ4,
+
+    /**
+     * Indicates the payload is compressed as a single .xz stream.
+     */
+    XZ
+};
+
+/**
+ * Enumeration of branch/call/jump filters that can be applied ahead of the xz codec.
+ */
+enum class BranchFilter {
+    /**
+     * Indicates no branch filter.
+     */
+    NONE,
+
+    /**
+     * Indicates the x86 and x86-64 branch filter.
+     */
+    X86,
+
+    /**
+     * Indicates the 32-bit ARM branch filter.
+     */
+    ARM,
+
+    /**
+     * Indicates the ARM Thumb branch filter.
+     */
+    ARM_THUMB,
+
+    /**
+     * Indicates the ARM64 branch filter.
+     */
+    ARM64,
+
+    /**
+     * Indicates the PowerPC branch filter.
+     */
+    POWERPC,
+
+    /**
+     * Indicates the SPARC branch filter.
+     */
+    SPARC
+};
+
+/**
+ * Enumeration of transform filters that can be applied ahead of any codec.
+ */
+enum class FilterType {
+    /**
+     * Indicates a byte shuffle that groups byte N of every element together.  The parameter is the element size.
+     */
+    SHUFFLE,
+
+    /**
+     * Indicates byte wise delta coding.  The parameter is the distance, in bytes.
+     */
+    DELTA,
+
+    /**
+     * Indicates the x86 and x86-64 call/jump filter.
+     */
+    X86,
+
+    /**
+     * Indicates the 32-bit ARM branch and link filter.
+     */
+    ARM,
+
+    /**
+     * Indicates the ARM64 branch and link filter.
+     */
+    ARM64
+};
+
+/**
+ * Structure holding a single transform filter.
+ */
+struct Filter {
+    /**
+     * The filter type.
+     */
+    FilterType type;
+
+    /**
+     * The filter parameter.  Unused by the branch filters.
+     */
+    unsigned parameter;
+};
+
+/**
+ * Structure holding the settings used to compress each payload.
+ */
+struct CompressionSettings {
+    /**
+     * The codec used to compress the payload.
+     */
+    Codec codec;
+
+    /**
+     * The codec specific compression level.  A negative value selects the default level for the codec.
+     */
+    int level;
+
+    /**
+     * The number of worker threads the codec may use.  A value of 0 indicates that the codec should run on the
+     * calling thread.
+     */
+    unsigned numberThreads;
+
+    /**
+     * The number of optimal parse iterations used by the exhaustive deflate encoder.  A value of 0 indicates that the
+     * qt codec should use qCompress rather than the exhaustive encoder.
+     */
+    unsigned numberIterations;
+
+    /**
+     * The base 2 logarithm of the long distance matching window.  A value of 0 disables long distance matching.
+     */
+    unsigned longWindowLog;
+
+    /**
+     * Flag indicating if codec and size metadata should be emitted even when using one of the legacy codecs.
+     */
+    bool includeMetadata;
+
+    /**
+     * Flag indicating if the xz codec should use its slower, extreme, variant of the selected preset.
+     */
+    bool extreme;
+
+    /**
+     * The xz dictionary size, in bytes.  A value of 0 selects the dictionary size implied by the preset.
+     */
+    unsigned long long dictionarySize;
+
+    /**
+     * The branch filter to apply ahead of the xz codec.
+     */
+    BranchFilter branchFilter;
+
+    /**
+     * The size of the dictionary to train and share across every payload, in bytes.  A value of 0 disables the shared
+     * dictionary.
+     */
+    unsigned long long sharedDictionarySize;
+
+    /**
+     * Flag indicating that the codec and level should be chosen separately for each payload by trial compression.
+     */
+    bool autoCodec;
+
+    /**
+     * Flag indicating that the codec choice should weigh the measured compression time rather than the nominal
+     * compression rate.  Measured times vary from run to run so the choice is no longer reproducible.
+     */
+    bool measureTime;
+
+    /**
+     * Flag indicating that payloads that appear incompressible should be stored uncompressed.
+     */
+    bool storeIncompressible;
+
+    /**
+     * The transform filters applied, in order, ahead of the codec.
+     */
+    std::vector<Filter> filters;
+};
+
+/**
+ * Structure holding a single input and the name it will be emitted under.
+ */
+struct Payload {
+    /**
+     * The input filename.  An empty string indicates stdin.
+     */
+    std::string filename;
+
+    /**
+     * The prefix placed in front of each variable name generated for this payload.
+     */
+    std::string prefix;
+
+    /**
+     * The uncompressed payload contents.
+     */
+    std::vector<unsigned char> data;
+
+    /**
+     * The compression settings applied to this payload.
+     */
+    CompressionSettings compressionSettings;
+
+    /**
+     * The index of the first payload with identical contents.  Payloads that are not duplicates hold their own index.
+     * The contents of a duplicate are released once it has been identified.
+     */
+    std::size_t originalIndex;
+
+    /**
+     * The size of the baseline the payload was delta encoded against, in bytes.  Unused unless a baseline was
+     * supplied.
+     */
+    unsigned long long baselineSize;
+
+    /**
+     * The 64-bit FNV-1a hash of the baseline the payload was delta encoded against.
+     */
+    std::uint64_t baselineHash;
+
+    /**
+     * The size of the payload rebuilt from the baseline and the delta, in bytes.
+     */
+    unsigned long long targetSize;
+};
+
+/**
+ * Structure holding the compressed form of a payload.
+ */
+struct CompressedPayload {
+    /**
+     * The compressed data.  Chunked payloads hold every compressed chunk, back to back.
+     */
+    std::vector<unsigned char> data;
+
+    /**
+     * The offset of each compressed chunk followed by the size of the compressed data.  Empty unless the payload is
+     * chunked.
+     */
+    std::vector<unsigned long long> chunkOffsets;
+};
+
+/**
+ * Structure holding settings that control how payloads are laid out in the generated source.
+ */
+struct OutputSettings {
+    /**
+     * Flag indicating that all inputs should be concatenated and compressed as a single solid payload with a table
+     * locating each input.
+     */
+    bool solid;
+
+    /**
+     * Flag indicating that every payload should be compressed independently and packed, along with the payload names,
+     * into a single blob located through an index of 32-bit offsets.
+     */
+    bool packed;
+
+    /**
+     * Flag indicating that packed payloads should be located through a minimal perfect hash of their names rather
+     * than a binary search.  Requires packed.
+     */
+    bool perfectHash;
+
+    /**
+     * The size of the independently compressed chunks each payload is divided into, in bytes.  A value of 0 indicates
+     * that each payload should be compressed as a single stream.
+     */
+    unsigned long long chunkSize;
+
+    /**
+     * The average size of the content defined chunks shared across payloads, in bytes.  A value of 0 disables chunk
+     * deduplication.
+     */
+    unsigned long long cdcAverageSize;
+
+    /**
+     * Flag indicating that a lazy, thread safe, accessor returning the decompressed contents should be emitted for
+     * each payload.
+     */
+    bool accessors;
+
+    /**
+     * Flag indicating that a function decompressing directly into caller owned memory should be emitted for each
+     * payload, along with a constexpr uncompressed size.
+     */
+    bool decompressInto;
+
+    /**
+     * Flag indicating that a function opening each payload for streaming decompression should be emitted.
+     */
+    bool stream;
+
+    /**
+     * Flag indicating that a registry of every payload's accessor should be emitted along with a function that
+     * decompresses the payloads on background threads.  Requires accessors.
+     */
+    bool prefetch;
+
+    /**
+     * Flag indicating that a function acquiring each payload through the memory bounded payload cache should be
+     * emitted.
+     */
+    bool cache;
+
+    /**
+     * The alignment, and padding granularity, of each payload array in bytes.  A value of 0 leaves payloads
+     * unaligned.
+     */
+    unsigned long long alignment;
+
+    /**
+     * Flag indicating that each payload and size variable should be placed in its own section so the linker can
+     * discard unreferenced payloads.
+     */
+    bool sections;
+
+    /**
+     * Flag indicating that each payload should record its first access in an access profile.
+     */
+    bool recordProfile;
+
+    /**
+     * The payload names read from an access profile, in first access order.  Listed payloads are emitted first, in
+     * profile order, and the remaining payloads are placed in the cold section.  An empty list disables profile guided
+     * placement.
+     */
+    std::vector<std::string> profile;
+};
+
+/**
+ * Function that converts a codec name to a codec.
+ *
+ * \param[in]  name  The codec name to be converted.
+ *
+ * \param[out] codec The resulting codec.
+ *
+ * \return Returns true on success.  Returns false if the codec name is not recognized.
+ */
+bool toCodec(const std::string& name, Codec& codec) {
+    bool success = true;
+
+    if (name == "none") {
+        codec = Codec::NONE;
+    } else if (name == "qt" || name == "zlib") {
+        codec = Codec::QT_ZLIB;
+    } else if (name == "zstd") {
+        codec = Codec::ZSTD;
+    } else if (name == "lz4") {
+        codec = Codec::LZ4;
+    } else if (name == "xz") {
+        codec = Codec::XZ;
+    } else {
+        success = false;
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that converts a codec to the name reported in the generated metadata.
+ *
+ * \param[in] codec The codec to be converted.
+ *
+ * \return Returns the codec name.
+ */
+std::string toString(Codec codec) {
+    std::string result;
+
+    switch (codec) {
+        case Codec::NONE:    { result = "none";   break; }
+        case Codec::QT_ZLIB: { result = "qt";     break; }
+        case Codec::ZSTD:    { result = "zstd";   break; }
+        case Codec::LZ4:     { result = "lz4";    break; }
+        case Codec::XZ:      { result = "xz";     break; }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that converts a branch filter name to a branch filter.
+ *
+ * \param[in]  name         The branch filter name to be converted.
+ *
+ * \param[out] branchFilter The resulting branch filter.
+ *
+ * \return Returns true on success.  Returns false if the branch filter name is not recognized.
+ */
+bool toBranchFilter(const std::string& name, BranchFilter& branchFilter) {
+    bool success = true;
+
+    if (name == "none") {
+        branchFilter = BranchFilter::NONE;
+    } else if (name == "x86") {
+        branchFilter = BranchFilter::X86;
+    } else if (name == "arm") {
+        branchFilter = BranchFilter::ARM;
+    } else if (name == "armthumb") {
+        branchFilter = BranchFilter::ARM_THUMB;
+    } else if (name == "arm64") {
+        branchFilter = BranchFilter::ARM64;
+    } else if (name == "powerpc") {
+        branchFilter = BranchFilter::POWERPC;
+    } else if (name == "sparc") {
+        branchFilter = BranchFilter::SPARC;
+    } else {
+        success = false;
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that converts a comma separated filter list, such as "shuffle:4,delta:1", to a list of filters.
+ *
+ * \param[in]  text    The filter list to be converted.
+ *
+ * \param[out] filters The list to receive the filters.  Filters are appended to the list.
+ *
+ * \return Returns true on success.  Returns false if a filter is not recognized or has an invalid parameter.
+ */
+bool toFilters(const std::string& text, std::vector<Filter>& filters) {
+    bool success = true;
+
+    std::istringstream textStream(text);
+    std::string        filterText;
+    while (success && std::getline(textStream, filterText, ',')) {
+        std::size_t colonPosition  = filterText.find(':');
+        std::string name           = filterText.substr(0, colonPosition);
+        unsigned    parameter      = 0;
+        bool        validParameter = false;
+
+        if (colonPosition != std::string::npos) {
+            const char* parameterText = filterText.c_str() + colonPosition + 1;
+            char*       end;
+
+            parameter      = static_cast<unsigned>(strtoul(parameterText, &end, 10));
+            validParameter = (*end == '\0' && end != parameterText);
+        }
+
+        Filter filter;
+        filter.parameter = parameter;
+
+        if (name == "shuffle" && validParameter && parameter >= 2 && parameter <= 256) {
+            filter.type = FilterType::SHUFFLE;
+        } else if (name == "delta" && validParameter && parameter >= 1 && parameter <= 256) {
+            filter.type = FilterType::DELTA;
+        } else if (name == "x86" && colonPosition == std::string::npos) {
+            filter.type = FilterType::X86;
+        } else if (name == "arm" && colonPosition == std::string::npos) {
+            filter.type = FilterType::ARM;
+        } else if (name == "arm64" && colonPosition == std::string::npos) {
+            filter.type = FilterType::ARM64;
+        } else {
+            success = false;
+        }
+
+        if (success) {
+            filters.push_back(filter);
+        }
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that converts a list of filters to the comma separated form reported in the generated metadata.
+ *
+ * \param[in] filters The filters to be converted.
+ *
+ * \return Returns the filter list.
+ */
+std::string toString(const std::vector<Filter>& filters) {
+    std::string result;
+
+    for (const Filter& filter : filters) {
+        if (!result.empty()) {
+            result += ",";
+        }
+
+        switch (filter.type) {
+            case FilterType::SHUFFLE: { result += "shuffle:" + std::to_string(filter.parameter);   break; }
+            case FilterType::DELTA:   { result += "delta:" + std::to_string(filter.parameter);     break; }
+            case FilterType::X86:     { result += "x86";                                           break; }
+            case FilterType::ARM:     { result += "arm";                                           break; }
+            case FilterType::ARM64:   { result += "arm64";                                         break; }
+        }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that parses a size in bytes.  The size may be followed by a K, M, or G suffix to indicate kibibytes,
+ * mebibytes, or gibibytes.
+ *
+ * \param[in]  text The text to be parsed.
+ *
+ * \param[out] size The resulting size, in bytes.
+ *
+ * \return Returns true on success.  Returns false if the text is not a valid size.
+ */
+bool parseSize(const char* text, unsigned long long& size) {
+    char* end;
+    size = strtoull(text, &end, 10);
+
+    bool success = (end != text);
+    if (success) {
+        if (*end == 'K' || *end == 'k') {
+            size <<= 10;
+            ++end;
+        } else if (*end == 'M' || *end == 'm') {
+            size <<= 20;
+            ++end;
+        } else if (*end == 'G' || *end == 'g') {
+            size <<= 30;
+            ++end;
+        }
+
+        success = (*end == '\0');
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that determines if this build of the tool includes support for a codec.
+ *
+ * \param[in] codec The codec to be checked.
+ *
+ * \return Returns true if the codec is supported.  Returns false if the codec is not supported.
+ */
+bool isSupported(Codec codec) {
+    bool result;
+
+    switch (codec) {
+        case Codec::NONE:
+        case Codec::QT_ZLIB: {
+            result = true;
+            break;
+        }
+
+        case Codec::ZSTD: {
+            #if (defined(HAVE_ZSTD))
+
+                result = true;
+
+            #else
+
+                result = false;
+
+            #endif
+
+            break;
+        }
+
+        case Codec::LZ4: {
+            #if (defined(HAVE_LZ4))
+
+                result = true;
+
+            #else
+
+                result = false;
+
+            #endif
+
+            break;
+        }
+
+        case Codec::XZ: {
+            #if (defined(HAVE_LZMA))
+
+                result = true;
+
+            #else
+
+                result = false;
+
+            #endif
+
+            break;
+        }
+
+        default: {
+            result = false;
+            break;
+        }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that reads the entire contents of an input stream.
+ *
+ * \param[in]  inputStream The input stream to be read.
+ *
+ * \param[out] inputBuffer The buffer to receive the stream contents.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool readInput(std::istream& inputStream, std::vector<unsigned char>& inputBuffer) {
+    inputBuffer.clear();
+
+    char readBuffer[65536];
+    while (inputStream) {
+        inputStream.read(readBuffer, sizeof(readBuffer));
+        std::streamsize bytesRead = inputStream.gcount();
+        inputBuffer.insert(inputBuffer.end(), readBuffer, readBuffer + bytesRead);
+    }
+
+    return inputStream.eof();
+}
+
+#if (defined(HAVE_ZSTD))
+
+    /**
+     * Function that compresses a payload as a single Zstandard frame.  The frame header records the decompressed
+     * size.
+     *
+     * \param[in]  inputBuffer         The uncompressed payload.
+     *
+     * \param[in]  compressionSettings The compression settings to apply.
+     *
+     * \param[in]  dictionary          The shared dictionary to compress against.  An empty dictionary indicates none.
+     *
+     * \param[out] outputBuffer        The buffer to receive the compressed payload.
+     *
+     * \return Returns true on success.  Returns false on error.
+     */
+    bool compressZstd(
+            const std::vector<unsigned char>& inputBuffer,
+            const CompressionSettings&        compressionSettings,
+            const std::vector<unsigned char>& dictionary,
+            std::vector<unsigned char>&       outputBuffer
+        ) {
+        bool success = true;
+
+        ZSTD_CCtx* context = ZSTD_createCCtx();
+        int        level   = compressionSettings.level < 0 ? 19 : compressionSettings.level;
+
+        std::size_t result = ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level);
+        if (ZSTD_isError(result)) {
+            std::cerr << "*** Invalid zstd level " << level << ": " << ZSTD_getErrorName(result) << std::endl;
+            success = false;
+        }
+
+        if (success) {
+            result = ZSTD_CCtx_setParameter(context, ZSTD_c_checksumFlag, 1);
+            if (ZSTD_isError(result)) {
+                std::cerr << "*** Could not enable the zstd checksum: " << ZSTD_getErrorName(result) << std::endl;
+                success = false;
+            }
+        }
+
+        // A libzstd built without multithreading support only accepts 0 workers so we stay single threaded.
+        if (success                                              &&
+            compressionSettings.numberThreads > 0                &&
+            ZSTD_cParam_getBounds(ZSTD_c_nbWorkers).upperBound > 0  ) {
+            result = ZSTD_CCtx_setParameter(
+                context,
+                ZSTD_c_nbWorkers,
+                static_cast<int>(compressionSettings.numberThreads)
+            );
+
+            if (ZSTD_isError(result)) {
+                std::cerr << "*** Could not use " << compressionSettings.numberThreads << " zstd worker threads: "
+                          << ZSTD_getErrorName(result) << std::endl;
+                success = false;
+            }
+        }
+
+        if (success && compressionSettings.longWindowLog > 0) {
+            result = ZSTD_CCtx_setParameter(context, ZSTD_c_enableLongDistanceMatching, 1);
+            if (!ZSTD_isError(result)) {
+                result = ZSTD_CCtx_setParameter(
+                    context,
+                    ZSTD_c_windowLog,
+                    static_cast<int>(compressionSettings.longWindowLog)
+                );
+            }
+
+            if (ZSTD_isError(result)) {
+                std::cerr << "*** Invalid long window " << compressionSettings.longWindowLog << ": "
+                          << ZSTD_getErrorName(result) << std::endl;
+                success = false;
+            }
+        }
+
+        if (success && !dictionary.empty()) {
+            result = ZSTD_CCtx_loadDictionary(context, dictionary.data(), dictionary.size());
+            if (ZSTD_isError(result)) {
+                std::cerr << "*** Could not load zstd dictionary: " << ZSTD_getErrorName(result) << std::endl;
+                success = false;
+            }
+        }
+
+        if (success) {
+            ZSTD_CCtx_setPledgedSrcSize(context, inputBuffer.size());
+
+            outputBuffer.resize(ZSTD_compressBound(inputBuffer.size()));
+            result = ZSTD_compress2(
+                context,
+                outputBuffer.data(),
+                outputBuffer.size(),
+                inputBuffer.data(),
+                inputBuffer.size()
+            );
+
+            if (ZSTD_isError(result)) {
+                std::cerr << "*** Zstandard compression failed: " << ZSTD_getErrorName(result) << std::endl;
+                success = false;
+            } else {
+                outputBuffer.resize(result);
+            }
+        }
+
+        ZSTD_freeCCtx(context);
+        return success;
+    }
+
+#endif
+
+#if (defined(HAVE_LZ4))
+
+    /**
+     * Function that compresses a payload as a single raw LZ4 block.  Levels of 3 and above use the LZ4-HC compressor,
+     * lower levels use the fast compressor.
+     *
+     * \param[in]  inputBuffer         The uncompressed payload.
+     *
+     * \param[in]  compressionSettings The compression settings to apply.
+     *
+     * \param[out] outputBuffer        The buffer to receive the compressed payload.
+     *
+     * \return Returns true on success.  Returns false on error.
+     */
+    bool compressLz4(
+            const std::vector<unsigned char>& inputBuffer,
+            const CompressionSettings&        compressionSettings,
+            std::vector<unsigned char>&       outputBuffer
+        ) {
+        bool success = true;
+
+        if (inputBuffer.size() > LZ4_MAX_INPUT_SIZE) {
+            std::cerr << "*** Payload is too large for a single LZ4 block." << std::endl;
+            success = false;
+        } else {
+            int level     = compressionSettings.level < 0 ? LZ4HC_CLEVEL_MAX : compressionSettings.level;
+            int inputSize = static_cast<int>(inputBuffer.size());
+
+            // The high compression encoder reads its source even when empty so never hand it a null pointer.
+            static const unsigned char emptyInput = 0;
+            const unsigned char*       input      = inputBuffer.empty() ? &emptyInput : inputBuffer.data();
+
+            outputBuffer.resize(static_cast<std::size_t>(LZ4_compressBound(inputSize)));
+
+            int result;
+            if (level >= LZ4HC_CLEVEL_MIN) {
+                result = LZ4_compress_HC(
+                    reinterpret_cast<const char*>(input),
+                    reinterpret_cast<char*>(outputBuffer.data()),
+                    inputSize,
+                    static_cast<int>(outputBuffer.size()),
+                    level
+                );
+            } else {
+                result = LZ4_compress_default(
+                    reinterpret_cast<const char*>(input),
+                    reinterpret_cast<char*>(outputBuffer.data()),
+                    inputSize,
+                    static_cast<int>(outputBuffer.size())
+                );
+            }
+
+            if (result <= 0 && inputSize > 0) {
+                std::cerr << "*** LZ4 compression failed." << std::endl;
+                success = false;
+            } else {
+                outputBuffer.resize(static_cast<std::size_t>(result));
+            }
+        }
+
+        return success;
+    }
+
+#endif
+
+#if (defined(HAVE_LZMA))
+
+    /**
+     * Function that compresses a payload as a single .xz stream using LZMA2, optionally preceded by a branch filter.
+     *
+     * \param[in]  inputBuffer         The uncompressed payload.
+     *
+     * \param[in]  compressionSettings The compression settings to apply.
+     *
+     * \param[out] outputBuffer        The buffer to receive the compressed payload.
+     *
+     * \return Returns true on success.  Returns false on error.
+     */
+    bool compressXz(
+            const std::vector<unsigned char>& inputBuffer,
+            const CompressionSettings&        compressionSettings,
+            std::vector<unsigned char>&       outputBuffer
+        ) {
+        bool success = true;
+
+        std::uint32_t preset = compressionSettings.level < 0 ? 9 : static_cast<std::uint32_t>(compressionSettings.level);
+        if (compressionSettings.extreme) {
+            preset |= LZMA_PRESET_EXTREME;
+        }
+
+        lzma_options_lzma lzmaOptions;
+        if (lzma_lzma_preset(&lzmaOptions, preset)) {
+            std::cerr << "*** Invalid xz preset " << compressionSettings.level << std::endl;
+            success = false;
+        } else {
+            if (compressionSettings.dictionarySize > 0) {
+                lzmaOptions.dict_size = static_cast<std::uint32_t>(compressionSettings.dictionarySize);
+            }
+
+            lzma_filter filters[3];
+            unsigned    numberFilters = 0;
+
+            lzma_vli branchFilterId = LZMA_VLI_UNKNOWN;
+            switch (compressionSettings.branchFilter) {
+                case BranchFilter::NONE:      {                                           break; }
+                case BranchFilter::X86:       { branchFilterId = LZMA_FILTER_X86;         break; }
+                case BranchFilter::ARM:       { branchFilterId = LZMA_FILTER_ARM;         break; }
+                case BranchFilter::ARM_THUMB: { branchFilterId = LZMA_FILTER_ARMTHUMB;    break; }
+                case BranchFilter::POWERPC:   { branchFilterId = LZMA_FILTER_POWERPC;     break; }
+                case BranchFilter::SPARC:     { branchFilterId = LZMA_FILTER_SPARC;       break; }
+
+                case BranchFilter::ARM64: {
+                    #if (defined(LZMA_FILTER_ARM64))
+
+                        branchFilterId = LZMA_FILTER_ARM64;
+
+                    #else
+
+                        std::cerr << "*** The installed liblzma does not support the arm64 filter." << std::endl;
+                        success = false;
+
+                    #endif
+
+                    break;
+                }
+            }
+
+            if (branchFilterId != LZMA_VLI_UNKNOWN) {
+                filters[numberFilters].id      = branchFilterId;
+                filters[numberFilters].options = nullptr;
+                ++numberFilters;
+            }
+
+            filters[numberFilters].id      = LZMA_FILTER_LZMA2;
+            filters[numberFilters].options = &lzmaOptions;
+            ++numberFilters;
+
+            filters[numberFilters].id      = LZMA_VLI_UNKNOWN;
+            filters[numberFilters].options = nullptr;
+
+            if (success) {
+                outputBuffer.resize(lzma_stream_buffer_bound(inputBuffer.size()));
+
+                std::size_t outputPosition = 0;
+                lzma_ret    result         = lzma_stream_buffer_encode(
+                    filters,
+                    LZMA_CHECK_CRC64,
+                    nullptr,
+                    inputBuffer.data(),
+                    inputBuffer.size(),
+                    outputBuffer.data(),
+                    &outputPosition,
+                    outputBuffer.size()
+                );
+
+                if (result != LZMA_OK) {
+                    std::cerr << "*** xz compression failed, error " << static_cast<int>(result) << "." << std::endl;
+                    success = false;
+                } else {
+                    outputBuffer.resize(outputPosition);
+                }
+            }
+        }
+
+        return success;
+    }
+
+#endif
+
+/**
+ * Function that applies a list of transform filters to a buffer.  The generated BuildPayload::unfilter function
+ * reverses the filters.
+ *
+ * \param[in]     filters The filters to apply, in order.
+ *
+ * \param[in,out] data    The data to be filtered.
+ */
+void applyFilters(const std::vector<Filter>& filters, std::vector<unsigned char>& data) {
+    std::size_t size = data.size();
+
+    for (const Filter& filter : filters) {
+        switch (filter.type) {
+            case FilterType::SHUFFLE: {
+                // Blocks are shuffled independently so they can be restored through a small fixed buffer.  Must match
+                // BuildPayload::shuffleBlockSize.
+                const std::size_t          shuffleBlockSize = 16384;
+                std::size_t                elementSize      = filter.parameter;
+                std::size_t                blockSize        = (shuffleBlockSize / elementSize) * elementSize;
+                std::vector<unsigned char> source           = data;
+
+                for (std::size_t offset=0 ; offset<size ; offset += blockSize) {
+                    std::size_t numberElements = std::min(blockSize, size - offset) / elementSize;
+                    for (std::size_t element=0 ; element<numberElements ; ++element) {
+                        for (std::size_t byte=0 ; byte<elementSize ; ++byte) {
+                            data[offset + byte * numberElements + element] = (
+                                source[offset + element * elementSize + byte]
+                            );
+                        }
+                    }
+                }
+
+                break;
+            }
+
+            case FilterType::DELTA: {
+                for (std::size_t i=size ; i>filter.parameter ; --i) {
+                    data[i - 1] = static_cast<unsigned char>(data[i - 1] - data[i - 1 - filter.parameter]);
+                }
+
+                break;
+            }
+
+            case FilterType::X86: {
+                // Relative call and jump targets are made absolute so repeated calls to a function become identical.
+                // Only displacements that are a sign extended 25 bit value are converted, keeping the transform
+                // reversible.
+                std::size_t i = 0;
+                while (i + 5 <= size) {
+                    if ((data[i] & 0xFE) == 0xE8 && (data[i + 4] == 0x00 || data[i + 4] == 0xFF)) {
+                        std::uint32_t value = (
+                              static_cast<std::uint32_t>(data[i + 1])
+                            | (static_cast<std::uint32_t>(data[i + 2]) << 8)
+                            | (static_cast<std::uint32_t>(data[i + 3]) << 16)
+                            | (static_cast<std::uint32_t>(data[i + 4]) << 24)
+                        );
+
+                        value = (value + static_cast<std::uint32_t>(i + 5)) & 0x01FFFFFF;
+                        if ((value & 0x01000000) != 0) {
+                            value |= 0xFF000000;
+                        }
+
+                        data[i + 1] = static_cast<unsigned char>(value);
+                        data[i + 2] = static_cast<unsigned char>(value >> 8);
+                        data[i + 3] = static_cast<unsigned char>(value >> 16);
+                        data[i + 4] = static_cast<unsigned char>(value >> 24);
+
+                        i += 5;
+                    } else {
+                        ++i;
+                    }
+                }
+
+                break;
+            }
+
+            case FilterType::ARM: {
+                for (std::size_t i=0 ; i + 4 <= size ; i += 4) {
+                    if (data[i + 3] == 0xEB) {
+                        std::uint32_t offset = (
+                              static_cast<std::uint32_t>(data[i])
+                            | (static_cast<std::uint32_t>(data[i + 1]) << 8)
+                            | (static_cast<std::uint32_t>(data[i + 2]) << 16)
+                        );
+
+                        offset = (offset + static_cast<std::uint32_t>((i + 8) >> 2)) & 0x00FFFFFF;
+
+                        data[i]     = static_cast<unsigned char>(offset);
+                        data[i + 1] = static_cast<unsigned char>(offset >> 8);
+                        data[i + 2] = static_cast<unsigned char>(offset >> 16);
+                    }
+                }
+
+                break;
+            }
+
+            case FilterType::ARM64: {
+                for (std::size_t i=0 ; i + 4 <= size ; i += 4) {
+                    std::uint32_t instruction = (
+                          static_cast<std::uint32_t>(data[i])
+                        | (static_cast<std::uint32_t>(data[i + 1]) << 8)
+                        | (static_cast<std::uint32_t>(data[i + 2]) << 16)
+                        | (static_cast<std::uint32_t>(data[i + 3]) << 24)
+                    );
+
+                    if ((instruction >> 26) == 0x25) {
+                        std::uint32_t offset = (instruction + static_cast<std::uint32_t>(i >> 2)) & 0x03FFFFFF;
+                        instruction = (instruction & 0xFC000000) | offset;
+
+                        data[i]     = static_cast<unsigned char>(instruction);
+                        data[i + 1] = static_cast<unsigned char>(instruction >> 8);
+                        data[i + 2] = static_cast<unsigned char>(instruction >> 16);
+                        data[i + 3] = static_cast<unsigned char>(instruction >> 24);
+                    }
+                }
+
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * Function that compresses a payload using the requested codec, after applying any transform filters.
+ *
+ * \param[in]  inputBuffer         The uncompressed payload.
+ *
+ * \param[in]  compressionSettings The compression settings to apply.
+ *
+ * \param[in]  dictionary          The shared dictionary to compress against.  An empty dictionary indicates none.
+ *
+ * \param[out] outputBuffer        The buffer to receive the compressed payload.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool compressPayload(
+        const std::vector<unsigned char>& inputBuffer,
+        const CompressionSettings&        compressionSettings,
+        const std::vector<unsigned char>& dictionary,
+        std::vector<unsigned char>&       outputBuffer
+    ) {
+    bool success = true;
+
+    std::vector<unsigned char> filteredBuffer;
+    if (!compressionSettings.filters.empty()) {
+        filteredBuffer = inputBuffer;
+        applyFilters(compressionSettings.filters, filteredBuffer);
+    }
+
+    const std::vector<unsigned char>& sourceBuffer = (
+        compressionSettings.filters.empty() ? inputBuffer : filteredBuffer
+    );
+
+    switch (compressionSettings.codec) {
+        case Codec::NONE: {
+            outputBuffer = sourceBuffer;
+            break;
+        }
+
+        case Codec::QT_ZLIB: {
+            bool encoded = false;
+            if (compressionSettings.numberIterations > 0 || !dictionary.empty()) {
+                // qCompress can not use a preset dictionary so dictionary compression always uses our own encoder.
+                DeflateEncoder encoder(compressionSettings.numberIterations, compressionSettings.numberThreads);
+                outputBuffer = encoder.compressQt(sourceBuffer, dictionary);
+                encoded      = true;
+            }
+
+            // The optimal parse can lose to zlib on highly redundant data so the smaller of the two streams is kept.
+            if (dictionary.empty()) {
+                QByteArray compressed = qCompress(
+                    sourceBuffer.data(),
+                    static_cast<int>(sourceBuffer.size()),
+                    (compressionSettings.level < 0 || encoded) ? 9 : compressionSettings.level
+                );
+
+                if (!encoded || static_cast<std::size_t>(compressed.size()) < outputBuffer.size()) {
+                    const unsigned char* compressedData = reinterpret_cast<const unsigned char*>(
+                        compressed.constData()
+                    );
+
+                    outputBuffer.assign(compressedData, compressedData + compressed.size());
+                }
+            }
+
+            break;
+        }
+
+        case Codec::ZSTD: {
+            #if (defined(HAVE_ZSTD))
+
+                success = compressZstd(sourceBuffer, compressionSettings, dictionary, outputBuffer);
+
+            #else
+
+                std::cerr << "*** Zstandard support was not included in this build." << std::endl;
+                success = false;
+
+            #endif
+
+            break;
+        }
+
+        case Codec::LZ4: {
+            #if (defined(HAVE_LZ4))
+
+                success = compressLz4(sourceBuffer, compressionSettings, outputBuffer);
+
+            #else
+
+                std::cerr << "*** LZ4 support was not included in this build." << std::endl;
+                success = false;
+
+            #endif
+
+            break;
+        }
+
+        case Codec::XZ: {
+            #if (defined(HAVE_LZMA))
+
+                success = compressXz(sourceBuffer, compressionSettings, outputBuffer);
+
+            #else
+
+                std::cerr << "*** xz support was not included in this build." << std::endl;
+                success = false;
+
+            #endif
+
+            break;
+        }
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that divides a payload into fixed size chunks and compresses each chunk independently.  Chunks are
+ * compressed in parallel, each on a single thread.
+ *
+ * \param[in]  inputBuffer         The uncompressed payload.
+ *
+ * \param[in]  compressionSettings The compression settings to apply to each chunk.
+ *
+ * \param[in]  chunkSize           The uncompressed size of each chunk, in bytes.  The last chunk may be shorter.
+ *
+ * \param[out] outputBuffer        The buffer to receive the compressed chunks, back to back.
+ *
+ * \param[out] chunkOffsets        The offset of each compressed chunk within the output buffer followed by the size
+ *                                 of the output buffer.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool compressChunks(
+        const std::vector<unsigned char>& inputBuffer,
+        const CompressionSettings&        compressionSettings,
+        unsigned long long                chunkSize,
+        std::vector<unsigned char>&       outputBuffer,
+        std::vector<unsigned long long>&  chunkOffsets
+    ) {
+    std::size_t numberChunks = static_cast<std::size_t>((inputBuffer.size() + chunkSize - 1) / chunkSize);
+
+    CompressionSettings chunkCompressionSettings = compressionSettings;
+    chunkCompressionSettings.numberThreads = 0;
+
+    std::vector<std::vector<unsigned char>> compressedChunks(numberChunks);
+    std::atomic<std::size_t>                nextChunk(0);
+    std::atomic<bool>                       success(true);
+
+    auto worker = [&]() {
+        std::size_t chunkIndex = nextChunk++;
+        while (success && chunkIndex < numberChunks) {
+            std::size_t start = static_cast<std::size_t>(chunkIndex * chunkSize);
+            std::size_t end   = std::min(inputBuffer.size(), static_cast<std::size_t>(start + chunkSize));
+
+            std::vector<unsigned char> chunk(inputBuffer.begin() + start, inputBuffer.begin() + end);
+            std::vector<unsigned char> noDictionary;
+            if (!compressPayload(chunk, chunkCompressionSettings, noDictionary, compressedChunks[chunkIndex])) {
+                success = false;
+            }
+
+            chunkIndex = nextChunk++;
+        }
+    };
+
+    std::size_t              numberThreads = std::min<std::size_t>(compressionSettings.numberThreads, numberChunks);
+    std::vector<std::thread> threads;
+    for (std::size_t i=1 ; i<numberThreads ; ++i) {
+        threads.push_back(std::thread(worker));
+    }
+
+    worker();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    outputBuffer.clear();
+    chunkOffsets.clear();
+    for (const std::vector<unsigned char>& compressedChunk : compressedChunks) {
+        chunkOffsets.push_back(outputBuffer.size());
+        outputBuffer.insert(outputBuffer.end(), compressedChunk.begin(), compressedChunk.end());
+    }
+
+    chunkOffsets.push_back(outputBuffer.size());
+
+    return success;
+}
+
+
+/**
+ * Function that estimates if a payload is incompressible, such as JPEG, PNG or zip data.  The estimate is based on
+ * up to 16 evenly spaced 4 KiB samples.  Samples with a low order 0 entropy are compressible.  Samples with a high
+ * entropy are checked by a fast deflate pass that catches repeated content.
+ *
+ * \param[in] inputBuffer The uncompressed payload.
+ *
+ * \return Returns true if the payload is not worth compressing.  Returns false if the payload should be compressed.
+ */
+bool isIncompressible(const std::vector<unsigned char>& inputBuffer) {
+    const std::size_t sampleSize     = 4096;
+    const std::size_t maximumSamples = 16;
+
+    std::vector<unsigned char> samples;
+    if (inputBuffer.size() <= sampleSize * maximumSamples) {
+        samples = inputBuffer;
+    } else {
+        std::size_t stride = (inputBuffer.size() - sampleSize) / (maximumSamples - 1);
+        for (std::size_t i=0 ; i<maximumSamples ; ++i) {
+            std::vector<unsigned char>::const_iterator sampleStart = inputBuffer.begin() + i * stride;
+            samples.insert(samples.end(), sampleStart, sampleStart + sampleSize);
+        }
+    }
+
+    bool result = false;
+    if (samples.size() >= 256) {
+        std::size_t counts[256] = { 0 };
+        for (unsigned char v : samples) {
+            ++counts[v];
+        }
+
+        double entropy = 0;
+        for (unsigned i=0 ; i<256 ; ++i) {
+            if (counts[i] > 0) {
+                double probability = static_cast<double>(counts[i]) / samples.size();
+                entropy -= probability * std::log2(probability);
+            }
+        }
+
+        if (entropy >= 7.5) {
+            QByteArray compressed = qCompress(samples.data(), static_cast<int>(samples.size()), 1);
+            result = (static_cast<double>(compressed.size()) >= 0.97 * samples.size());
+        }
+    }
+
+    return result;
+}
+
+
+/**
+ * Structure holding the outcome of a trial compression of a payload with one candidate codec and level.
+ */
+struct CodecTrial {
+    /**
+     * The candidate compression settings.
+     */
+    CompressionSettings compressionSettings;
+
+    /**
+     * Flag indicating if the trial compression succeeded.
+     */
+    bool success;
+
+    /**
+     * The compressed size, in bytes.
+     */
+    unsigned long long compressedSize;
+
+    /**
+     * The time spent compressing, in seconds.  The time is estimated from the nominal compression rate unless
+     * measured times were requested.
+     */
+    double compressionSeconds;
+
+    /**
+     * The estimated time a consumer will spend decompressing, in seconds.
+     */
+    double decompressionSeconds;
+
+    /**
+     * The overall cost of the candidate, expressed in bytes.
+     */
+    double cost;
+};
+
+/**
+ * Function that returns the nominal single core rate at which consumers can decompress a codec.  The rates only need
+ * to be right relative to each other.
+ *
+ * \param[in] codec The codec of interest.
+ *
+ * \return Returns the decompression rate, in bytes per second.
+ */
+double decompressionRate(Codec codec) {
+    double result = 0;
+
+    switch (codec) {
+        case Codec::NONE:    { result = 8.0e9;  break; }
+        case Codec::QT_ZLIB: { result = 3.0e8;  break; }
+        case Codec::ZSTD:    { result = 1.0e9;  break; }
+        case Codec::LZ4:     { result = 3.0e9;  break; }
+        case Codec::XZ:      { result = 8.0e7;  break; }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that returns the nominal single core rate at which a codec compresses at a given level.  Like the
+ * decompression rates, the rates only need to be right relative to each other.
+ *
+ * \param[in] codec The codec of interest.
+ *
+ * \param[in] level The compression level.
+ *
+ * \return Returns the compression rate, in bytes per second.
+ */
+double compressionRate(Codec codec, int level) {
+    double result = 0;
+
+    switch (codec) {
+        case Codec::NONE:    { result = 8.0e9;                                                     break; }
+        case Codec::QT_ZLIB: { result = level <= 1 ? 9.0e7 : level <= 6 ? 3.0e7 : 1.0e7;          break; }
+        case Codec::ZSTD:    { result = level <= 3 ? 3.5e8 : level <= 9 ? 8.0e7 : 5.0e6;          break; }
+        case Codec::LZ4:     { result = level <= 2 ? 7.0e8 : 3.0e7;                                break; }
+        case Codec::XZ:      { result = level <= 6 ? 3.0e6 : 2.5e6;                                break; }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that chooses the codec and level for a payload by compressing it with a set of candidates, in parallel, and
+ * selecting the candidate with the lowest cost.  The cost is the compressed size plus penalties, expressed in bytes,
+ * for the decompression and compression times estimated from nominal rates, so the same input always yields the same
+ * choice.  The measured compression time replaces the estimate when requested.  A report of every candidate is
+ * written to stderr.
+ *
+ * \param[in]  label               The name used for the payload in the report.
+ *
+ * \param[in]  inputBuffer         The uncompressed payload.
+ *
+ * \param[in]  compressionSettings The compression settings to start from.  Settings other than the codec and level
+ *                                 are preserved.
+ *
+ * \param[out] chosenSettings      The compression settings of the selected candidate.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool chooseCompressionSettings(
+        const std::string&                label,
+        const std::vector<unsigned char>& inputBuffer,
+        const CompressionSettings&        compressionSettings,
+        CompressionSettings&              chosenSettings
+    ) {
+    // One second of decompression costs as much as 16 MiB of payload, one second of compression as much as 256 KiB.
+    const double decompressionCostPerSecond = 16.0 * 1024 * 1024;
+    const double compressionCostPerSecond   = 256.0 * 1024;
+
+    struct Candidate {
+        Codec codec;
+        int   level;
+    };
+
+    static const Candidate candidates[] = {
+        { Codec::NONE,    0  },
+        { Codec::QT_ZLIB, 1  },
+        { Codec::QT_ZLIB, 6  },
+        { Codec::QT_ZLIB, 9  },
+        { Codec::ZSTD,    3  },
+        { Codec::ZSTD,    9  },
+        { Codec::ZSTD,    19 },
+        { Codec::LZ4,     1  },
+        { Codec::LZ4,     12 },
+        { Codec::XZ,      6  },
+        { Codec::XZ,      9  }
+    };
+
+    std::vector<CodecTrial> trials;
+    for (const Candidate& candidate : candidates) {
+        if (isSupported(candidate.codec)) {
+            CodecTrial trial;
+            trial.compressionSettings                  = compressionSettings;
+            trial.compressionSettings.codec            = candidate.codec;
+            trial.compressionSettings.level            = candidate.level;
+            trial.compressionSettings.numberThreads    = 0;
+            trial.compressionSettings.numberIterations = 0;
+            trial.success                              = false;
+
+            trials.push_back(trial);
+        }
+    }
+
+    std::atomic<std::size_t> nextTrial(0);
+    auto worker = [&]() {
+        std::size_t trialIndex = nextTrial++;
+        while (trialIndex < trials.size()) {
+            CodecTrial&                trial = trials[trialIndex];
+            std::vector<unsigned char> noDictionary;
+            std::vector<unsigned char> outputBuffer;
+
+            std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+            trial.success = compressPayload(inputBuffer, trial.compressionSettings, noDictionary, outputBuffer);
+            std::chrono::steady_clock::time_point endTime = std::chrono::steady_clock::now();
+
+            const CompressionSettings& settings = trial.compressionSettings;
+
+            trial.compressedSize       = outputBuffer.size();
+            trial.compressionSeconds   = (
+                  compressionSettings.measureTime
+                ? std::chrono::duration<double>(endTime - startTime).count()
+                : inputBuffer.size() / compressionRate(settings.codec, settings.level)
+            );
+            trial.decompressionSeconds = inputBuffer.size() / decompressionRate(trial.compressionSettings.codec);
+            trial.cost                 = (
+                  trial.compressedSize
+                + trial.decompressionSeconds * decompressionCostPerSecond
+                + trial.compressionSeconds * compressionCostPerSecond
+            );
+
+            trialIndex = nextTrial++;
+        }
+    };
+
+    std::size_t              numberThreads = std::min<std::size_t>(compressionSettings.numberThreads, trials.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i=1 ; i<numberThreads ; ++i) {
+        threads.push_back(std::thread(worker));
+    }
+
+    worker();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    const CodecTrial* best = nullptr;
+    for (const CodecTrial& trial : trials) {
+        if (trial.success && (best == nullptr || trial.cost < best->cost)) {
+            best = &trial;
+        }
+    }
+
+    bool success = (best != nullptr);
+    if (success) {
+        chosenSettings                  = best->compressionSettings;
+        chosenSettings.numberThreads    = compressionSettings.numberThreads;
+        chosenSettings.numberIterations = compressionSettings.numberIterations;
+
+        std::cerr << label << " (" << inputBuffer.size() << " bytes):" << std::endl;
+        for (const CodecTrial& trial : trials) {
+            if (trial.success) {
+                double ratio = inputBuffer.empty() ? 100.0 : 100.0 * trial.compressedSize / inputBuffer.size();
+
+                std::cerr << (&trial == best ? "  * " : "    ")
+                          << std::left << std::setw(6) << toString(trial.compressionSettings.codec) << std::right
+                          << std::setw(3) << trial.compressionSettings.level
+                          << std::setw(14) << trial.compressedSize
+                          << std::fixed << std::setprecision(1) << std::setw(7) << ratio << "%"
+                          << std::setprecision(2) << std::setw(11) << trial.compressionSeconds * 1000.0
+                          << " ms compress"
+                          << std::setw(10) << trial.decompressionSeconds * 1000.0 << " ms decompress"
+                          << std::defaultfloat << std::endl;
+            }
+        }
+    } else {
+        std::cerr << "*** No codec could compress " << label << std::endl;
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that rounds a size up to a multiple of an alignment.
+ *
+ * \param[in] size      The size to round.
+ *
+ * \param[in] alignment The alignment, a power of two.  A value of 0 indicates no alignment.
+ *
+ * \return Returns the rounded size.
+ */
+unsigned long long toAlignedSize(unsigned long long size, unsigned long long alignment) {
+    return alignment > 0 ? (size + alignment - 1) & ~(alignment - 1) : size;
+}
+
+
+/**
+ * Function that returns the section a payload variable is placed in.  Payloads missing from the access profile are
+ * placed in the cold section.  Cold size variables get a cold section of their own because the size type may lack a
+ * const qualifier and GCC rejects mixing writable and read-only variables in one section.
+ *
+ * \param[in] outputSettings Settings controlling how the payloads are laid out.
+ *
+ * \param[in] payloadName    The name of the payload the variable belongs to.  An empty name indicates a variable
+ *                           that is never cold, such as a chunk store or packed blob shared by every payload, which
+ *                           is needed as soon as any one payload is.
+ *
+ * \param[in] identifier     The variable name.
+ *
+ * \param[in] isSize         If true, the variable holds a size rather than payload data.
+ *
+ * \return Returns the section name.  An empty string is returned if the variable uses the default section.
+ */
+std::string toSectionName(
+        const OutputSettings& outputSettings,
+        const std::string&    payloadName,
+        const std::string&    identifier,
+        bool                  isSize
+    ) {
+    bool isCold = (
+           !payloadName.empty()
+        && !outputSettings.profile.empty()
+        && std::find(outputSettings.profile.begin(), outputSettings.profile.end(), payloadName)
+           == outputSettings.profile.end()
+    );
+
+    std::string result;
+    if (isCold) {
+        if (outputSettings.sections) {
+            result = ".rodata.cold." + identifier;
+        } else {
+            result = isSize ? ".rodata.cold.sizes" : ".rodata.cold";
+        }
+    } else if (outputSettings.sections) {
+        result = ".rodata.payload." + identifier;
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that builds the attribute placing a variable in a section.  Variables with external linkage are also given
+ * hidden visibility so the section is not kept alive by the dynamic symbol table.  Writable variables are moved from
+ * .rodata sections to the matching .data section so the assembler keeps the section writable.
+ *
+ * \param[in] type    The variable type.
+ *
+ * \param[in] section The section name.  An empty name indicates the default section.
+ *
+ * \return Returns the attribute, including a leading space.  An empty string is returned for the default section.
+ */
+std::string toSectionAttribute(const std::string& type, const std::string& section) {
+    std::string result;
+
+    if (!section.empty()) {
+        bool               isStatic = false;
+        bool               isExtern = false;
+        bool               isConst  = false;
+        std::istringstream typeStream(type);
+        std::string        token;
+        while (typeStream >> token) {
+            isStatic = isStatic || token == "static";
+            isExtern = isExtern || token == "extern";
+            isConst  = isConst  || token == "const" || token == "constexpr";
+        }
+
+        std::string sectionName = section;
+        if (!isConst && sectionName.compare(0, 7, ".rodata") == 0) {
+            sectionName = ".data" + sectionName.substr(7);
+        }
+
+        // Namespace scope const variables have internal linkage unless declared extern.
+        bool externalLinkage = isExtern || (!isStatic && !isConst);
+        result = std::string(" ") + (externalLinkage ? "BUILD_PAYLOAD_HIDDEN_SECTION" : "BUILD_PAYLOAD_SECTION")
+                 + "(\"" + sectionName + "\")";
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that dumps a byte array as a C++ array declaration.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] width           The desired maximum line width.
+ *
+ * \param[in] declaration     The declaration placed in front of the array initializer, excluding the array bounds.
+ *
+ * \param[in] data            The data to be dumped.
+ *
+ * \param[in] alignment       The required alignment of the array in bytes.  The array bounds are padded to a multiple
+ *                            of the alignment, the compiler zero filling the padding.  A value of 0 indicates no
+ *                            alignment.
+ *
+ * \param[in] attributes      Attributes placed after the array bounds.  An empty string indicates none.
+ */
+void dumpByteArray(
+        std::ostream&                     outputStream,
+        unsigned                          leftIndentation,
+        unsigned                          indentation,
+        unsigned                          width,
+        const std::string&                declaration,
+        const std::vector<unsigned char>& data,
+        unsigned long long                alignment,
+        const std::string&                attributes
+    ) {
+    std::string leftIndentationString(leftIndentation, ' ');
+    std::string contentsIndentationString(leftIndentation + indentation, ' ');
+
+    unsigned long numberBytes = data.size();
+
+    outputStream << leftIndentationString;
+    if (alignment > 0) {
+        outputStream << "alignas(" << alignment << ") ";
+    }
+
+    outputStream << declaration << "[" << toAlignedSize(numberBytes, alignment) << "]" << attributes << " = {";
+
+    unsigned valuesPerLine  = (width - indentation - leftIndentation + 1) / 6;
+    unsigned valuesThisLine = valuesPerLine;
+    for (unsigned long i=0 ; i<numberBytes ; ++i) {
+        if (valuesThisLine >= valuesPerLine) {
+            outputStream << std::endl << contentsIndentationString;
+            valuesThisLine = 1;
+        } else {
+            ++valuesThisLine;
+        }
+
+        unsigned char v = data[i];
+
+        char buffer[6];
+        sprintf(buffer, "0x%02X", static_cast<unsigned>(v));
+        outputStream << buffer;
+
+        if (i < (numberBytes - 1)) {
+            outputStream << ", ";
+        }
+    }
+
+    outputStream << std::endl
+                 << leftIndentationString << "};" << std::endl
+                 << std::endl;
+}
+
+/**
+ * Function that dumps an array of unsigned long values as a C++ array declaration.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] width           The desired maximum line width.
+ *
+ * \param[in] declaration     The declaration placed in front of the array initializer, excluding the array bounds.
+ *
+ * \param[in] values          The values to be dumped.
+ */
+void dumpValueArray(
+        std::ostream&                          outputStream,
+        unsigned                               leftIndentation,
+        unsigned                               indentation,
+        unsigned                               width,
+        const std::string&                     declaration,
+        const std::vector<unsigned long long>& values
+    ) {
+    std::string leftIndentationString(leftIndentation, ' ');
+    std::string contentsIndentationString(leftIndentation + indentation, ' ');
+
+    outputStream << leftIndentationString << declaration << "[" << values.size() << "] = {";
+
+    unsigned long lineLength = width;
+    for (std::size_t i=0 ; i<values.size() ; ++i) {
+        std::string value = std::to_string(values[i]) + "UL";
+        if (i < values.size() - 1) {
+            value += ",";
+        }
+
+        if (lineLength + value.size() + 1 > width) {
+            outputStream << std::endl << contentsIndentationString << value;
+            lineLength = contentsIndentationString.size() + value.size();
+        } else {
+            outputStream << " " << value;
+            lineLength += value.size() + 1;
+        }
+    }
+
+    outputStream << std::endl
+                 << leftIndentationString << "};" << std::endl
+                 << std::endl;
+}
+
+/**
+ * Function that dumps a block of generated source code.  The code is written using 4 space indentation, each leading
+ * group of 4 spaces is replaced by the requested indentation.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] code            The code to be dumped.
+ */
+void dumpCode(std::ostream& outputStream, unsigned leftIndentation, unsigned indentation, const char* code) {
+    std::istringstream codeStream(code);
+    std::string        codeLine;
+    while (std::getline(codeStream, codeLine)) {
+        if (codeLine.empty()) {
+            outputStream << std::endl;
+        } else {
+            std::size_t leadingSpaces = codeLine.find_first_not_of(' ');
+            std::size_t level         = leadingSpaces / 4;
+
+            outputStream << std::string(leftIndentation + level * indentation, ' ')
+                         << codeLine.substr(level * 4) << std::endl;
+        }
+    }
+}
+
+
+/**
+ * Function that dumps a small, dependency free, LZ4 block decoder used to decompress payloads generated with the lz4
+ * codec.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpLz4Runtime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+
+#ifndef BUILD_PAYLOAD_LZ4_RUNTIME
+#define BUILD_PAYLOAD_LZ4_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that decompresses a raw LZ4 block.
+     *
+     * \param[in] source          The compressed payload.
+     *
+     * \param[in] sourceSize      The size of the compressed payload, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the decompressed payload.
+     *
+     * \param[in] destinationSize The exact size of the decompressed payload, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt.
+     */
+    inline bool lz4Decompress(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize
+        ) {
+        const unsigned char* sourceEnd      = source + sourceSize;
+        unsigned char*       out            = destination;
+        unsigned char*       destinationEnd = destination + destinationSize;
+
+        while (source < sourceEnd) {
+            unsigned      token         = *source++;
+            unsigned long literalLength = token >> 4;
+            if (literalLength == 15) {
+                unsigned char extension;
+                do {
+                    if (source >= sourceEnd) {
+                        return false;
+                    }
+
+                    extension      = *source++;
+                    literalLength += extension;
+                } while (extension == 255);
+            }
+
+            if (literalLength > static_cast<unsigned long>(sourceEnd - source)      ||
+                literalLength > static_cast<unsigned long>(destinationEnd - out)    ) {
+                return false;
+            }
+
+            std::memcpy(out, source, literalLength);
+            out    += literalLength;
+            source += literalLength;
+
+            if (source == sourceEnd) {
+                break;
+            }
+
+            if (sourceEnd - source < 2) {
+                return false;
+            }
+
+            unsigned long offset = source[0] | (static_cast<unsigned long>(source[1]) << 8);
+            source += 2;
+
+            if (offset == 0 || offset > static_cast<unsigned long>(out - destination)) {
+                return false;
+            }
+
+            unsigned long matchLength = token & 15;
+            if (matchLength == 15) {
+                unsigned char extension;
+                do {
+                    if (source >= sourceEnd) {
+                        return false;
+                    }
+
+                    extension    = *source++;
+                    matchLength += extension;
+                } while (extension == 255);
+            }
+
+            matchLength += 4;
+            if (matchLength > static_cast<unsigned long>(destinationEnd - out)) {
+                return false;
+            }
+
+            const unsigned char* match = out - offset;
+            if (offset >= matchLength) {
+                std::memcpy(out, match, matchLength);
+                out += matchLength;
+            } else {
+                unsigned char* matchEnd = out + matchLength;
+                while (out < matchEnd) {
+                    *out++ = *match++;
+                }
+            }
+        }
+
+        return out == destinationEnd;
+    }
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the structure used to describe the contents of a solid payload.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpSolidRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_SOLID_RUNTIME
+#define BUILD_PAYLOAD_SOLID_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Structure that locates one input within a decompressed solid payload.
+     */
+    struct SolidEntry {
+        /**
+         * The input filename, without any directory.
+         */
+        const char* name;
+
+        /**
+         * The offset of the input within the decompressed payload, in bytes.
+         */
+        unsigned long offset;
+
+        /**
+         * The length of the input, in bytes.
+         */
+        unsigned long length;
+    };
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the structures and functions used to locate payloads packed into a single blob.  The index
+ * holds 32-bit offsets rather than pointers so it needs no dynamic relocations in position independent executables.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpPackedRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstdint>
+#include <cstring>
+
+#if (__cplusplus >= 201703L)
+    #include <string_view>
+#endif
+
+#ifndef BUILD_PAYLOAD_PACKED_RUNTIME
+#define BUILD_PAYLOAD_PACKED_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Enumeration of the codecs a packed payload may be compressed with.
+     */
+    enum class PackedCodec : std::uint8_t {
+        NONE,
+        QT_ZLIB,
+        ZSTD,
+        LZ4,
+        XZ
+    };
+
+    /**
+     * Structure that locates one payload, and its name, within a packed blob.
+     */
+    struct PackedEntry {
+        /**
+         * The offset of the compressed payload within the blob, in bytes.
+         */
+        std::uint32_t offset;
+
+        /**
+         * The size of the compressed payload, in bytes.
+         */
+        std::uint32_t size;
+
+        /**
+         * The size of the decompressed payload, in bytes.
+         */
+        std::uint32_t uncompressedSize;
+
+        /**
+         * The offset of the payload's nul terminated name within the blob, in bytes.
+         */
+        std::uint32_t nameOffset;
+
+        /**
+         * The length of the payload's name, in bytes, excluding the terminator.
+         */
+        std::uint32_t nameLength;
+
+        /**
+         * The codec the payload was compressed with.
+         */
+        PackedCodec codec;
+
+        /**
+         * A value of 1 if the payload's filters must be undone after decompression.
+         */
+        std::uint8_t filtered;
+    };
+
+    /**
+     * Function that obtains the name of a packed payload.
+     *
+     * \param[in] blob  The packed blob.
+     *
+     * \param[in] entry The index entry of the payload.
+     *
+     * \return Returns the nul terminated payload name.
+     */
+    inline const char* packedName(const unsigned char* blob, const PackedEntry& entry) {
+        return reinterpret_cast<const char*>(blob + entry.nameOffset);
+    }
+
+    /**
+     * Function that locates a payload by name through a binary search of an index sorted by name.
+     *
+     * \param[in] blob          The packed blob.
+     *
+     * \param[in] index         The index, sorted by name.
+     *
+     * \param[in] numberEntries The number of entries in the index.
+     *
+     * \param[in] name          The name of the payload.  The name need not be nul terminated.
+     *
+     * \param[in] nameLength    The length of the name, in bytes.
+     *
+     * \return Returns the index entry of the payload.  A null pointer is returned if no payload has the name.
+     */
+    inline const PackedEntry* findPacked(
+            const unsigned char* blob,
+            const PackedEntry*   index,
+            unsigned long        numberEntries,
+            const char*          name,
+            unsigned long        nameLength
+        ) {
+        unsigned long low  = 0;
+        unsigned long high = numberEntries;
+        while (low < high) {
+            unsigned long      middle       = low + (high - low) / 2;
+            const PackedEntry& entry        = index[middle];
+            unsigned long      commonLength = entry.nameLength < nameLength ? entry.nameLength : nameLength;
+
+            int comparison = std::memcmp(blob + entry.nameOffset, name, commonLength);
+            if (comparison == 0) {
+                comparison = (entry.nameLength < nameLength) ? -1 : (entry.nameLength > nameLength ? 1 : 0);
+            }
+
+            if (comparison == 0) {
+                return &entry;
+            } else if (comparison < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+
+        return nullptr;
+    }
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the functions used to locate packed payloads through a minimal perfect hash of their names.
+ * The hash must match \ref perfectHash.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpPerfectHashRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstdint>
+#include <cstring>
+
+#ifndef BUILD_PAYLOAD_PERFECT_HASH_RUNTIME
+#define BUILD_PAYLOAD_PERFECT_HASH_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that calculates the seeded hash of a payload name.  The name is hashed using 64-bit FNV-1a and the
+     * result is finished with the MurmurHash3 mixer so that every seed yields an independent hash.
+     *
+     * \param[in] name       The name to be hashed.
+     *
+     * \param[in] nameLength The length of the name, in bytes.
+     *
+     * \param[in] seed       The seed.
+     *
+     * \return Returns the hash.
+     */
+    constexpr std::uint32_t perfectHash(const char* name, unsigned long nameLength, std::uint32_t seed) {
+        std::uint64_t hash = 0xCBF29CE484222325ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+        for (unsigned long i=0 ; i<nameLength ; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(name[i])) * 0x100000001B3ULL;
+        }
+
+        hash = (hash ^ (hash >> 33)) * 0xFF51AFD7ED558CCDULL;
+        hash = (hash ^ (hash >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+
+        return static_cast<std::uint32_t>(hash ^ (hash >> 33));
+    }
+
+    /**
+     * Function that locates a payload by name through a compress, hash and displace minimal perfect hash.  The name
+     * selects a bucket, the bucket's displacement selects the index entry and a single comparison rejects names that
+     * are not in the index.
+     *
+     * \param[in] blob          The packed blob.
+     *
+     * \param[in] index         The index, in hash order.
+     *
+     * \param[in] numberEntries The number of entries in the index.
+     *
+     * \param[in] displacements The displacement of each bucket.
+     *
+     * \param[in] numberBuckets The number of buckets.
+     *
+     * \param[in] name          The name of the payload.  The name need not be nul terminated.
+     *
+     * \param[in] nameLength    The length of the name, in bytes.
+     *
+     * \return Returns the index entry of the payload.  A null pointer is returned if no payload has the name.
+     */
+    inline const PackedEntry* findHashed(
+            const unsigned char* blob,
+            const PackedEntry*   index,
+            unsigned long        numberEntries,
+            const std::uint32_t* displacements,
+            unsigned long        numberBuckets,
+            const char*          name,
+            unsigned long        nameLength
+        ) {
+        std::uint32_t      displacement = displacements[perfectHash(name, nameLength, 0) % numberBuckets];
+        const PackedEntry& entry        = index[perfectHash(name, nameLength, displacement) % numberEntries];
+
+        bool matches = (
+               entry.nameLength == nameLength
+            && (nameLength == 0 || std::memcmp(blob + entry.nameOffset, name, nameLength) == 0)
+        );
+
+        return matches ? &entry : nullptr;
+    }
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the inverse transform filters.  Filters are undone in place by BuildPayload::unfilter using the
+ * filter steps emitted with each payload.  The byte shuffle, delta and x86 filters use SSE2 where available.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpFilterRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+#include <cstdint>
+
+#ifndef BUILD_PAYLOAD_FILTER_RUNTIME
+#define BUILD_PAYLOAD_FILTER_RUNTIME
+
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define BUILD_PAYLOAD_SSE2
+#endif
+
+namespace BuildPayload {
+    /**
+     * Enumeration of the transform filters.
+     */
+    enum class FilterType {
+        SHUFFLE,
+        DELTA,
+        X86,
+        ARM,
+        ARM64
+    };
+
+    /**
+     * Structure describing one transform filter applied to a payload.
+     */
+    struct FilterStep {
+        /**
+         * The filter type.
+         */
+        FilterType type;
+
+        /**
+         * The element size for a byte shuffle or the distance for delta coding.  Unused by the branch filters.
+         */
+        unsigned long parameter;
+    };
+
+    /**
+     * The size of the blocks that are byte shuffled independently, in bytes.  Blocks are rounded down to a whole
+     * number of elements.
+     */
+    constexpr unsigned long shuffleBlockSize = 16384;
+
+    #if (defined(BUILD_PAYLOAD_SSE2))
+
+        /**
+         * Function that undoes a byte shuffle 16 elements at a time.  Adjacent byte planes are interleaved at doubling
+         * widths which leaves the vectors in bit reversed order.
+         *
+         * \param[in] source         The shuffled data.
+         *
+         * \param[in] destination    The buffer to receive the original data.
+         *
+         * \param[in] numberElements The number of elements in the shuffled data.
+         *
+         * \return Returns the number of elements restored.
+         */
+        template<unsigned elementSize> inline unsigned long unshuffleVectors(
+                const unsigned char* source,
+                unsigned char*       destination,
+                unsigned long        numberElements
+            ) {
+            unsigned long element = 0;
+            for ( ; element + 16 <= numberElements ; element += 16) {
+                __m128i planes[elementSize];
+                __m128i interleaved[elementSize];
+
+                for (unsigned plane=0 ; plane<elementSize ; ++plane) {
+                    planes[plane] = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(source + plane * numberElements + element)
+                    );
+                }
+
+                for (unsigned width=1 ; width<elementSize ; width *= 2) {
+                    for (unsigned pair=0 ; pair<elementSize / 2 ; ++pair) {
+                        __m128i even = planes[2 * pair];
+                        __m128i odd  = planes[2 * pair + 1];
+                        __m128i low;
+                        __m128i high;
+
+                        if (width == 1) {
+                            low  = _mm_unpacklo_epi8(even, odd);
+                            high = _mm_unpackhi_epi8(even, odd);
+                        } else if (width == 2) {
+                            low  = _mm_unpacklo_epi16(even, odd);
+                            high = _mm_unpackhi_epi16(even, odd);
+                        } else if (width == 4) {
+                            low  = _mm_unpacklo_epi32(even, odd);
+                            high = _mm_unpackhi_epi32(even, odd);
+                        } else {
+                            low  = _mm_unpacklo_epi64(even, odd);
+                            high = _mm_unpackhi_epi64(even, odd);
+                        }
+
+                        interleaved[pair]                   = low;
+                        interleaved[elementSize / 2 + pair] = high;
+                    }
+
+                    for (unsigned plane=0 ; plane<elementSize ; ++plane) {
+                        planes[plane] = interleaved[plane];
+                    }
+                }
+
+                __m128i* out = reinterpret_cast<__m128i*>(destination + elementSize * element);
+                for (unsigned vector=0 ; vector<elementSize ; ++vector) {
+                    unsigned reversed = 0;
+                    for (unsigned bit=1 ; bit<elementSize ; bit *= 2) {
+                        reversed = (reversed << 1) | ((vector & bit) != 0 ? 1 : 0);
+                    }
+
+                    _mm_storeu_si128(out + reversed, planes[vector]);
+                }
+            }
+
+            return element;
+        }
+
+    #endif
+
+    /**
+     * Function that undoes a byte shuffle.
+     *
+     * \param[in] source      The shuffled data.
+     *
+     * \param[in] destination The buffer to receive the original data.  The buffer must not overlap the source.
+     *
+     * \param[in] size        The size of the data, in bytes.
+     *
+     * \param[in] elementSize The element size, in bytes.
+     */
+    inline void unshuffle(
+            const unsigned char* source,
+            unsigned char*       destination,
+            unsigned long        size,
+            unsigned long        elementSize
+        ) {
+        unsigned long numberElements = size / elementSize;
+        unsigned long element        = 0;
+
+        #if (defined(BUILD_PAYLOAD_SSE2))
+            switch (elementSize) {
+                case 2:  { element = unshuffleVectors<2>(source, destination, numberElements);    break; }
+                case 4:  { element = unshuffleVectors<4>(source, destination, numberElements);    break; }
+                case 8:  { element = unshuffleVectors<8>(source, destination, numberElements);    break; }
+                case 16: { element = unshuffleVectors<16>(source, destination, numberElements);   break; }
+                default: {                                                                        break; }
+            }
+        #endif
+
+        for ( ; element<numberElements ; ++element) {
+            for (unsigned long byte=0 ; byte<elementSize ; ++byte) {
+                destination[element * elementSize + byte] = source[byte * numberElements + element];
+            }
+        }
+
+        unsigned long shuffledSize = numberElements * elementSize;
+        std::memcpy(destination + shuffledSize, source + shuffledSize, size - shuffledSize);
+    }
+
+    /**
+     * Function that undoes a blockwise byte shuffle, in place, one block at a time through a buffer on the stack.
+     *
+     * \param[in,out] data        The data to be decoded.
+     *
+     * \param[in]     size        The size of the data, in bytes.
+     *
+     * \param[in]     elementSize The element size, in bytes.
+     */
+    inline void unshuffleBlocks(unsigned char* data, unsigned long size, unsigned long elementSize) {
+        unsigned char scratch[shuffleBlockSize];
+        unsigned long blockSize = (shuffleBlockSize / elementSize) * elementSize;
+
+        for (unsigned long offset=0 ; offset<size ; offset += blockSize) {
+            unsigned long length = size - offset < blockSize ? size - offset : blockSize;
+            std::memcpy(scratch, data + offset, length);
+            unshuffle(scratch, data + offset, length, elementSize);
+        }
+    }
+
+    /**
+     * Function that undoes byte wise delta coding, in place.
+     *
+     * \param[in,out] data     The data to be decoded.
+     *
+     * \param[in]     size     The size of the data, in bytes.
+     *
+     * \param[in]     distance The delta distance, in bytes.
+     */
+    inline void undelta(unsigned char* data, unsigned long size, unsigned long distance) {
+        unsigned long i = distance;
+
+        #if (defined(BUILD_PAYLOAD_SSE2))
+            if (distance >= 16) {
+                // Every byte a vector depends on is at least 16 bytes back and so already decoded.
+                for ( ; i + 16 <= size ; i += 16) {
+                    __m128i previous = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i - distance));
+                    __m128i current  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_add_epi8(current, previous));
+                }
+            } else if (distance == 1 && size >= 16) {
+                // A distance of 1 is a running sum, computed 16 bytes at a time with a log step prefix sum.
+                __m128i carry = _mm_setzero_si128();
+                for (i=0 ; i + 16 <= size ; i += 16) {
+                    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    x = _mm_add_epi8(x, _mm_slli_si128(x, 1));
+                    x = _mm_add_epi8(x, _mm_slli_si128(x, 2));
+                    x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+                    x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+                    x = _mm_add_epi8(x, carry);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), x);
+
+                    __m128i last = _mm_srli_si128(x, 15);
+                    last  = _mm_unpacklo_epi8(last, last);
+                    last  = _mm_unpacklo_epi16(last, last);
+                    carry = _mm_shuffle_epi32(last, 0);
+                }
+            }
+        #endif
+
+        for ( ; i<size ; ++i) {
+            data[i] = static_cast<unsigned char>(data[i] + data[i - distance]);
+        }
+    }
+
+    /**
+     * Function that undoes the x86 call/jump filter, in place.
+     *
+     * \param[in,out] data The data to be decoded.
+     *
+     * \param[in]     size The size of the data, in bytes.
+     */
+    inline void unfilterX86(unsigned char* data, unsigned long size) {
+        unsigned long i = 0;
+        while (i + 5 <= size) {
+            #if (defined(BUILD_PAYLOAD_SSE2))
+                // Skip quickly over runs of 16 bytes holding no call or jump opcodes.
+                if (i + 16 <= size) {
+                    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                    __m128i calls = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(0xE8)));
+                    __m128i jumps = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(0xE9)));
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(calls, jumps)));
+                    if (mask == 0) {
+                        i += 16;
+                        continue;
+                    }
+
+                    while ((mask & 1) == 0) {
+                        mask >>= 1;
+                        ++i;
+                    }
+
+                    if (i + 5 > size) {
+                        break;
+                    }
+                }
+            #endif
+
+            if ((data[i] & 0xFE) == 0xE8 && (data[i + 4] == 0x00 || data[i + 4] == 0xFF)) {
+                std::uint32_t value = (
+                      static_cast<std::uint32_t>(data[i + 1])
+                    | (static_cast<std::uint32_t>(data[i + 2]) << 8)
+                    | (static_cast<std::uint32_t>(data[i + 3]) << 16)
+                    | (static_cast<std::uint32_t>(data[i + 4]) << 24)
+                );
+
+                value = (value - static_cast<std::uint32_t>(i + 5)) & 0x01FFFFFF;
+                if ((value & 0x01000000) != 0) {
+                    value |= 0xFF000000;
+                }
+
+                data[i + 1] = static_cast<unsigned char>(value);
+                data[i + 2] = static_cast<unsigned char>(value >> 8);
+                data[i + 3] = static_cast<unsigned char>(value >> 16);
+                data[i + 4] = static_cast<unsigned char>(value >> 24);
+
+                i += 5;
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    /**
+     * Function that undoes the 32-bit ARM branch and link filter, in place.
+     *
+     * \param[in,out] data The data to be decoded.
+     *
+     * \param[in]     size The size of the data, in bytes.
+     */
+    inline void unfilterArm(unsigned char* data, unsigned long size) {
+        for (unsigned long i=0 ; i + 4 <= size ; i += 4) {
+            if (data[i + 3] == 0xEB) {
+                std::uint32_t offset = (
+                      static_cast<std::uint32_t>(data[i])
+                    | (static_cast<std::uint32_t>(data[i + 1]) << 8)
+                    | (static_cast<std::uint32_t>(data[i + 2]) << 16)
+                );
+
+                offset = (offset - static_cast<std::uint32_t>((i + 8) >> 2)) & 0x00FFFFFF;
+
+                data[i]     = static_cast<unsigned char>(offset);
+                data[i + 1] = static_cast<unsigned char>(offset >> 8);
+                data[i + 2] = static_cast<unsigned char>(offset >> 16);
+            }
+        }
+    }
+
+    /**
+     * Function that undoes the ARM64 branch and link filter, in place.
+     *
+     * \param[in,out] data The data to be decoded.
+     *
+     * \param[in]     size The size of the data, in bytes.
+     */
+    inline void unfilterArm64(unsigned char* data, unsigned long size) {
+        for (unsigned long i=0 ; i + 4 <= size ; i += 4) {
+            std::uint32_t instruction = (
+                  static_cast<std::uint32_t>(data[i])
+                | (static_cast<std::uint32_t>(data[i + 1]) << 8)
+                | (static_cast<std::uint32_t>(data[i + 2]) << 16)
+                | (static_cast<std::uint32_t>(data[i + 3]) << 24)
+            );
+
+            if ((instruction >> 26) == 0x25) {
+                std::uint32_t offset = (instruction - static_cast<std::uint32_t>(i >> 2)) & 0x03FFFFFF;
+                instruction = (instruction & 0xFC000000) | offset;
+
+                data[i]     = static_cast<unsigned char>(instruction);
+                data[i + 1] = static_cast<unsigned char>(instruction >> 8);
+                data[i + 2] = static_cast<unsigned char>(instruction >> 16);
+                data[i + 3] = static_cast<unsigned char>(instruction >> 24);
+            }
+        }
+    }
+
+    /**
+     * Function that undoes a chain of transform filters, in place.
+     *
+     * \param[in]     steps       The filters applied to the payload, in the order they were applied.
+     *
+     * \param[in]     numberSteps The number of filters.
+     *
+     * \param[in,out] data        The decompressed data.
+     *
+     * \param[in]     size        The size of the data, in bytes.
+     *
+     * \return Returns true on success.  Returns false if a filter has an invalid parameter.
+     */
+    inline bool unfilter(const FilterStep* steps, unsigned long numberSteps, unsigned char* data, unsigned long size) {
+        bool success = true;
+
+        for (unsigned long index=numberSteps ; success && index>0 ; --index) {
+            const FilterStep& step = steps[index - 1];
+            switch (step.type) {
+                case FilterType::SHUFFLE: {
+                    success = (step.parameter > 0 && step.parameter <= shuffleBlockSize);
+                    if (success) {
+                        unshuffleBlocks(data, size, step.parameter);
+                    }
+
+                    break;
+                }
+
+                case FilterType::DELTA: {
+                    success = (step.parameter > 0);
+                    if (success) {
+                        undelta(data, size, step.parameter);
+                    }
+
+                    break;
+                }
+
+                case FilterType::X86: {
+                    unfilterX86(data, size);
+                    break;
+                }
+
+                case FilterType::ARM: {
+                    unfilterArm(data, size);
+                    break;
+                }
+
+                case FilterType::ARM64: {
+                    unfilterArm64(data, size);
+                    break;
+                }
+            }
+        }
+
+        return success;
+    }
+
+    /**
+     * Function that undoes a chain of transform filters, in place.
+     *
+     * \param[in]     steps The filters applied to the payload, such as the generated <variable>FilterSteps array.
+     *
+     * \param[in,out] data  The decompressed data.
+     *
+     * \param[in]     size  The size of the data, in bytes.
+     *
+     * \return Returns true on success.  Returns false if a filter has an invalid parameter.
+     */
+    template<unsigned long numberSteps> inline bool unfilter(
+            const FilterStep (&steps)[numberSteps],
+            unsigned char*   data,
+            unsigned long    size
+        ) {
+        return unfilter(steps, numberSteps, data, size);
+    }
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that returns the name of the generated function used to decompress a single chunk compressed with a codec.
+ *
+ * \param[in] codec The codec of interest.
+ *
+ * \return Returns the fully qualified function name.
+ */
+std::string chunkDecoderName(Codec codec) {
+    std::string result;
+
+    switch (codec) {
+        case Codec::NONE:    { result = "BuildPayload::storedChunkDecompress";   break; }
+        case Codec::QT_ZLIB: { result = "BuildPayload::qtChunkDecompress";       break; }
+        case Codec::ZSTD:    { result = "BuildPayload::zstdChunkDecompress";     break; }
+        case Codec::LZ4:     { result = "BuildPayload::lz4Decompress";           break; }
+        case Codec::XZ:      { result = "BuildPayload::xzChunkDecompress";       break; }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that returns the generated enumerator identifying a codec within a packed index.
+ *
+ * \param[in] codec The codec of interest.
+ *
+ * \return Returns the fully qualified enumerator.
+ */
+std::string packedCodecName(Codec codec) {
+    std::string result;
+
+    switch (codec) {
+        case Codec::NONE:    { result = "BuildPayload::PackedCodec::NONE";    break; }
+        case Codec::QT_ZLIB: { result = "BuildPayload::PackedCodec::QT_ZLIB"; break; }
+        case Codec::ZSTD:    { result = "BuildPayload::PackedCodec::ZSTD";    break; }
+        case Codec::LZ4:     { result = "BuildPayload::PackedCodec::LZ4";     break; }
+        case Codec::XZ:      { result = "BuildPayload::PackedCodec::XZ";      break; }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that dumps the inflater used to decompress payloads generated in the qCompress format.  The inflater is
+ * self contained so consumers decompress qt payloads straight into their own memory without allocating and without
+ * linking against zlib.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpInflateRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+#include <cstdint>
+
+#ifndef BUILD_PAYLOAD_INFLATE_RUNTIME
+#define BUILD_PAYLOAD_INFLATE_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that updates an Adler-32 checksum.
+     *
+     * \param[in] adler The checksum of the preceding data.
+     *
+     * \param[in] data  The data to add to the checksum.
+     *
+     * \param[in] size  The size of the data, in bytes.
+     *
+     * \return Returns the updated checksum.
+     */
+    inline std::uint32_t adler32(std::uint32_t adler, const unsigned char* data, unsigned long size) {
+        // 5552 is the largest run that cannot overflow the 32-bit sums before the modulo is applied.
+        std::uint32_t a = adler & 0xFFFF;
+        std::uint32_t b = adler >> 16;
+
+        while (size > 0) {
+            unsigned long runLength = size < 5552 ? size : 5552;
+            for (unsigned long i=0 ; i<runLength ; ++i) {
+                a += data[i];
+                b += a;
+            }
+
+            a    %= 65521;
+            b    %= 65521;
+            data += runLength;
+            size -= runLength;
+        }
+
+        return (b << 16) | a;
+    }
+
+    /**
+     * Class that inflates a payload generated in the qCompress format, a 4 byte big endian size followed by a zlib
+     * stream.  The inflater never allocates.  It stops whenever its output buffer fills and resumes on the next call
+     * so payloads can be inflated straight into caller owned memory or incrementally through a sliding window.
+     */
+    class Inflater {
+        public:
+            /**
+             * Enumeration of the outcomes of a call to \ref Inflater::run.
+             */
+            enum class Status {
+                /**
+                 * The output buffer filled before the end of the stream.
+                 */
+                MORE_OUTPUT,
+
+                /**
+                 * The stream ended and its checksum matched.
+                 */
+                DONE,
+
+                /**
+                 * The stream is corrupt.
+                 */
+                CORRUPT
+            };
+
+            /**
+             * Constructor.
+             *
+             * \param[in] source     The compressed payload, including the 4 byte size header.
+             *
+             * \param[in] sourceSize The size of the compressed payload, in bytes.
+             */
+            Inflater(
+                    const unsigned char* source,
+                    unsigned long        sourceSize
+                ):currentNext(
+                    source + (sourceSize >= 4 ? 4 : sourceSize)
+                ),currentEnd(
+                    source + sourceSize
+                ),currentBits(
+                    0
+                ),currentBitCount(
+                    0
+                ),currentPaddingBytes(
+                    0
+                ),currentMode(
+                    sourceSize >= 4 ? Mode::STREAM_HEADER : Mode::CORRUPT
+                ),currentFinalBlock(
+                    false
+                ),currentRemaining(
+                    0
+                ),currentDistance(
+                    0
+                ),currentAdler(
+                    1
+                ),currentSize(
+                    sourceSize >= 4
+                    ? (  (static_cast<unsigned long>(source[0]) << 24)
+                       | (static_cast<unsigned long>(source[1]) << 16)
+                       | (static_cast<unsigned long>(source[2]) << 8)
+                       | static_cast<unsigned long>(source[3])
+                      )
+                    : 0
+                ) {}
+
+            /**
+             * Method you can use to obtain the uncompressed size recorded in the size header.
+             *
+             * \return Returns the uncompressed size, in bytes, modulo 2^32.
+             */
+            unsigned long recordedSize() const {
+                return currentSize;
+            }
+
+            /**
+             * Method that inflates into a buffer until the buffer fills or the stream ends.
+             *
+             * \param[in]     buffer      The buffer to receive the output.  Bytes in front of the position hold
+             *                            earlier output which matches may reference.
+             *
+             * \param[in,out] position    The position in the buffer of the next byte of output.  Updated to the
+             *                            position just past the last byte of output.
+             *
+             * \param[in]     limit       The size of the buffer, in bytes.
+             *
+             * \param[in]     history     Data logically preceding the start of the buffer, such as a preset
+             *                            dictionary, that matches may reference.  A null pointer indicates none.
+             *
+             * \param[in]     historySize The size of the history, in bytes.
+             *
+             * \return Returns the status of the stream.
+             */
+            Status run(
+                    unsigned char*       buffer,
+                    unsigned long&       position,
+                    unsigned long        limit,
+                    const unsigned char* history = nullptr,
+                    unsigned long        historySize = 0
+                ) {
+                unsigned long start   = position;
+                bool          blocked = false;
+
+                while (!blocked) {
+                    switch (currentMode) {
+                        case Mode::STREAM_HEADER: {
+                            refill();
+                            unsigned long header = take(8) << 8;
+                            header |= take(8);
+
+                            // Compression method 8 with a window of at most 32K.  A preset dictionary is announced by
+                            // its checksum, which is skipped since the caller supplies the dictionary.
+                            if (((header >> 8) & 0x0F) != 8 || (header >> 12) > 7 || header % 31 != 0) {
+                                currentMode = Mode::CORRUPT;
+                            } else {
+                                if ((header & 0x20) != 0) {
+                                    take(32);
+                                }
+
+                                currentMode = Mode::BLOCK_HEADER;
+                            }
+
+                            break;
+                        }
+
+                        case Mode::BLOCK_HEADER: {
+                            currentMode = currentFinalBlock ? Mode::CHECKSUM : readBlockHeader();
+                            break;
+                        }
+
+                        case Mode::STORED: {
+                            while (currentRemaining > 0 && position < limit && currentBitCount >= 8) {
+                                buffer[position++] = static_cast<unsigned char>(take(8));
+                                --currentRemaining;
+                            }
+
+                            unsigned long available = static_cast<unsigned long>(currentEnd - currentNext);
+                            unsigned long count     = currentRemaining < limit - position ? currentRemaining
+                                                                                          : limit - position;
+                            if (count > available) {
+                                currentMode = Mode::CORRUPT;
+                            } else {
+                                std::memcpy(buffer + position, currentNext, count);
+                                currentNext      += count;
+                                position         += count;
+                                currentRemaining -= count;
+
+                                if (currentRemaining == 0) {
+                                    currentMode = Mode::BLOCK_HEADER;
+                                } else {
+                                    blocked = true;
+                                }
+                            }
+
+                            break;
+                        }
+
+                        case Mode::HUFFMAN: {
+                            // The block only stops short of its end when the buffer is full.
+                            inflateBlock(buffer, position, limit, history, historySize);
+                            blocked = (currentMode == Mode::HUFFMAN);
+                            break;
+                        }
+
+                        case Mode::CHECKSUM: {
+                            currentAdler = adler32(currentAdler, buffer + start, position - start);
+                            start        = position;
+
+                            refill();
+                            take(currentBitCount % 8);
+
+                            std::uint32_t expected = 0;
+                            for (unsigned byte=0 ; byte<4 ; ++byte) {
+                                expected = (expected << 8) | static_cast<std::uint32_t>(take(8));
+                            }
+
+                            currentMode = (expected == currentAdler && !overrun()) ? Mode::DONE : Mode::CORRUPT;
+                            break;
+                        }
+
+                        case Mode::DONE:
+                        case Mode::CORRUPT: {
+                            blocked = true;
+                            break;
+                        }
+                    }
+                }
+
+                currentAdler = adler32(currentAdler, buffer + start, position - start);
+
+                Status status = Status::MORE_OUTPUT;
+                if (currentMode == Mode::DONE) {
+                    status = Status::DONE;
+                } else if (currentMode == Mode::CORRUPT) {
+                    status = Status::CORRUPT;
+                }
+
+                return status;
+            }
+
+        private:
+            /**
+             * The number of code bits resolved by a single table lookup.  Longer codes are decoded bit by bit.
+             */
+            static constexpr unsigned fastBits = 9;
+
+            /**
+             * Enumeration of the decoder states.
+             */
+            enum class Mode {
+                STREAM_HEADER,
+                BLOCK_HEADER,
+                STORED,
+                HUFFMAN,
+                CHECKSUM,
+                DONE,
+                CORRUPT
+            };
+
+            /**
+             * Structure holding a canonical Huffman code.
+             */
+            struct Huffman {
+                /**
+                 * Table indexed by the next fastBits bits of input holding the symbol shifted left by 4 and the code
+                 * length.  Entries of 0 indicate a longer code.
+                 */
+                std::uint16_t fast[1 << fastBits];
+
+                /**
+                 * The number of codes of each length.
+                 */
+                std::uint16_t counts[16];
+
+                /**
+                 * The symbols ordered by code length then value.
+                 */
+                std::uint16_t symbols[288];
+            };
+
+            /**
+             * Method that tops up the bit buffer to at least 56 bits.  Reads past the end of the input supply zero
+             * bytes which are counted so the overrun can be detected.
+             */
+            void refill() {
+                while (currentBitCount <= 56) {
+                    std::uint64_t byte = 0;
+                    if (currentNext < currentEnd) {
+                        byte = *currentNext++;
+                    } else {
+                        ++currentPaddingBytes;
+                    }
+
+                    currentBits     |= byte << currentBitCount;
+                    currentBitCount += 8;
+                }
+            }
+
+            /**
+             * Method that determines if bits past the end of the input were consumed.
+             *
+             * \return Returns true if the input was overrun.
+             */
+            bool overrun() const {
+                return currentPaddingBytes * 8 > currentBitCount;
+            }
+
+            /**
+             * Method that removes bits from the bit buffer.  The buffer must hold at least the requested bits.
+             *
+             * \param[in] count The number of bits, at most 32.
+             *
+             * \return Returns the bits.
+             */
+            unsigned long take(unsigned count) {
+                unsigned long result = static_cast<unsigned long>(currentBits & ((std::uint64_t(1) << count) - 1));
+                currentBits    >>= count;
+                currentBitCount -= count;
+                return result;
+            }
+
+            /**
+             * Method that builds a canonical Huffman code from a list of code lengths.
+             *
+             * \param[out] huffman       The code to build.
+             *
+             * \param[in]  lengths       The code length of each symbol.  A length of 0 indicates an unused symbol.
+             *
+             * \param[in]  numberSymbols The number of symbols.
+             *
+             * \return Returns true on success.  Returns false if the lengths are over subscribed.
+             */
+            static bool build(Huffman& huffman, const unsigned char* lengths, unsigned numberSymbols) {
+                std::memset(huffman.counts, 0, sizeof(huffman.counts));
+                for (unsigned symbol=0 ; symbol<numberSymbols ; ++symbol) {
+                    ++huffman.counts[lengths[symbol]];
+                }
+
+                huffman.counts[0] = 0;
+
+                int  left    = 1;
+                bool success = true;
+                for (unsigned length=1 ; success && length<16 ; ++length) {
+                    left    = 2 * left - huffman.counts[length];
+                    success = (left >= 0);
+                }
+
+                if (success) {
+                    std::uint16_t offsets[16];
+                    std::uint16_t codes[16];
+                    unsigned      code = 0;
+
+                    offsets[1] = 0;
+                    for (unsigned length=1 ; length<15 ; ++length) {
+                        offsets[length + 1] = offsets[length] + huffman.counts[length];
+                    }
+
+                    for (unsigned length=1 ; length<16 ; ++length) {
+                        code          = (code + huffman.counts[length - 1]) << 1;
+                        codes[length] = static_cast<std::uint16_t>(code);
+                    }
+
+                    std::memset(huffman.fast, 0, sizeof(huffman.fast));
+                    for (unsigned symbol=0 ; symbol<numberSymbols ; ++symbol) {
+                        unsigned length = lengths[symbol];
+                        if (length > 0) {
+                            huffman.symbols[offsets[length]++] = static_cast<std::uint16_t>(symbol);
+
+                            // Codes are sent most significant bit first so the lookup index holds the code reversed.
+                            unsigned symbolCode = codes[length]++;
+                            if (length <= fastBits) {
+                                unsigned reversed = 0;
+                                for (unsigned bit=0 ; bit<length ; ++bit) {
+                                    reversed = (reversed << 1) | ((symbolCode >> bit) & 1);
+                                }
+
+                                std::uint16_t entry = static_cast<std::uint16_t>((symbol << 4) | length);
+                                for (unsigned index=reversed ; index<(1U << fastBits) ; index += 1U << length) {
+                                    huffman.fast[index] = entry;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                return success;
+            }
+
+            /**
+             * Method that decodes one symbol.  The bit buffer must hold at least 15 bits.
+             *
+             * \param[in] huffman The code to decode with.
+             *
+             * \return Returns the symbol.  Returns -1 if the input is not a valid code.
+             */
+            int decode(const Huffman& huffman) {
+                int           result = -1;
+                std::uint16_t entry  = huffman.fast[currentBits & ((1U << fastBits) - 1)];
+
+                if (entry != 0) {
+                    take(entry & 15);
+                    result = entry >> 4;
+                } else {
+                    int code  = 0;
+                    int first = 0;
+                    int index = 0;
+                    for (unsigned length=1 ; result < 0 && length<16 ; ++length) {
+                        code |= static_cast<int>(take(1));
+
+                        int count = huffman.counts[length];
+                        if (code - count < first) {
+                            result = huffman.symbols[index + code - first];
+                        } else {
+                            index += count;
+                            first  = (first + count) << 1;
+                            code <<= 1;
+                        }
+                    }
+                }
+
+                return result;
+            }
+
+            /**
+             * Method that reads the header of the next block and prepares to decode it.
+             *
+             * \return Returns the mode used to decode the block.
+             */
+            Mode readBlockHeader() {
+                static const unsigned char order[19] = {
+                    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+                };
+
+                Mode result = Mode::CORRUPT;
+
+                refill();
+                currentFinalBlock = (take(1) != 0);
+
+                unsigned type = static_cast<unsigned>(take(2));
+                if (type == 0) {
+                    take(currentBitCount % 8);
+                    unsigned long length   = take(16);
+                    unsigned long inverted = take(16);
+                    if ((length ^ 0xFFFF) == inverted) {
+                        currentRemaining = length;
+                        result           = Mode::STORED;
+                    }
+                } else if (type == 1) {
+                    unsigned char lengths[320];
+                    std::memset(lengths, 8, 144);
+                    std::memset(lengths + 144, 9, 112);
+                    std::memset(lengths + 256, 7, 24);
+                    std::memset(lengths + 280, 8, 8);
+                    std::memset(lengths + 288, 5, 30);
+
+                    if (build(currentLengthCode, lengths, 288) && build(currentDistanceCode, lengths + 288, 30)) {
+                        result = Mode::HUFFMAN;
+                    }
+                } else if (type == 2) {
+                    unsigned numberLengths   = static_cast<unsigned>(take(5)) + 257;
+                    unsigned numberDistances = static_cast<unsigned>(take(5)) + 1;
+                    unsigned numberCodes     = static_cast<unsigned>(take(4)) + 4;
+
+                    unsigned char codeLengths[19] = {};
+                    for (unsigned index=0 ; index<numberCodes ; ++index) {
+                        refill();
+                        codeLengths[order[index]] = static_cast<unsigned char>(take(3));
+                    }
+
+                    // The code length code is decoded with the distance code's storage, which is rebuilt below.
+                    unsigned char lengths[320];
+                    unsigned      total   = numberLengths + numberDistances;
+                    unsigned      index   = 0;
+                    bool          success = (
+                           numberLengths <= 286
+                        && numberDistances <= 30
+                        && build(currentDistanceCode, codeLengths, 19)
+                    );
+
+                    while (success && index < total) {
+                        refill();
+                        int symbol = decode(currentDistanceCode);
+                        if (symbol >= 0 && symbol < 16) {
+                            lengths[index++] = static_cast<unsigned char>(symbol);
+                        } else if (symbol == 16 && index > 0) {
+                            unsigned      repeat = 3 + static_cast<unsigned>(take(2));
+                            unsigned char value  = lengths[index - 1];
+                            success = (index + repeat <= total);
+                            while (success && repeat-- > 0) {
+                                lengths[index++] = value;
+                            }
+                        } else if (symbol == 17 || symbol == 18) {
+                            unsigned repeat = symbol == 17 ? 3 + static_cast<unsigned>(take(3))
+                                                           : 11 + static_cast<unsigned>(take(7));
+                            success = (index + repeat <= total);
+                            while (success && repeat-- > 0) {
+                                lengths[index++] = 0;
+                            }
+                        } else {
+                            success = false;
+                        }
+                    }
+
+                    if (success                                                          &&
+                        lengths[256] != 0                                                &&
+                        build(currentLengthCode, lengths, numberLengths)                 &&
+                        build(currentDistanceCode, lengths + numberLengths, numberDistances)) {
+                        result = Mode::HUFFMAN;
+                    }
+                }
+
+                return overrun() ? Mode::CORRUPT : result;
+            }
+
+            /**
+             * Method that copies the pending match into the buffer, stopping if the buffer fills.
+             *
+             * \param[in]     buffer      The buffer receiving the output.
+             *
+             * \param[in,out] position    The position of the next byte of output.
+             *
+             * \param[in]     limit       The size of the buffer, in bytes.
+             *
+             * \param[in]     history     Data logically preceding the start of the buffer.
+             *
+             * \param[in]     historySize The size of the history, in bytes.
+             *
+             * \return Returns true on success.  Returns false if the match reaches past the available history.
+             */
+            bool copyMatch(
+                    unsigned char*       buffer,
+                    unsigned long&       position,
+                    unsigned long        limit,
+                    const unsigned char* history,
+                    unsigned long        historySize
+                ) {
+                bool success = true;
+                while (success && currentRemaining > 0 && position < limit) {
+                    if (currentDistance <= position) {
+                        unsigned long        count = currentRemaining < limit - position ? currentRemaining
+                                                                                         : limit - position;
+                        unsigned char*       out   = buffer + position;
+                        const unsigned char* match = out - currentDistance;
+                        if (currentDistance >= count) {
+                            std::memcpy(out, match, count);
+                        } else {
+                            for (unsigned long i=0 ; i<count ; ++i) {
+                                out[i] = match[i];
+                            }
+                        }
+
+                        position         += count;
+                        currentRemaining -= count;
+                    } else {
+                        unsigned long back = currentDistance - position;
+                        success = (back <= historySize);
+                        if (success) {
+                            buffer[position++] = history[historySize - back];
+                            --currentRemaining;
+                        }
+                    }
+                }
+
+                return success;
+            }
+
+            /**
+             * Method that decodes the current Huffman block until it ends or the buffer fills.
+             *
+             * \param[in]     buffer      The buffer receiving the output.
+             *
+             * \param[in,out] position    The position of the next byte of output.
+             *
+             * \param[in]     limit       The size of the buffer, in bytes.
+             *
+             * \param[in]     history     Data logically preceding the start of the buffer.
+             *
+             * \param[in]     historySize The size of the history, in bytes.
+             */
+            void inflateBlock(
+                    unsigned char*       buffer,
+                    unsigned long&       position,
+                    unsigned long        limit,
+                    const unsigned char* history,
+                    unsigned long        historySize
+                ) {
+                static const std::uint16_t lengthBase[29] = {
+                    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+                };
+
+                static const unsigned char lengthExtra[29] = {
+                    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+                };
+
+                static const std::uint16_t distanceBase[30] = {
+                    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+                };
+
+                static const unsigned char distanceExtra[30] = {
+                    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+                };
+
+                bool success = copyMatch(buffer, position, limit, history, historySize);
+                bool inBlock = true;
+                bool full    = (currentRemaining > 0);
+                while (success && inBlock && !full) {
+                    refill();
+
+                    std::uint64_t bits     = currentBits;
+                    unsigned      bitCount = currentBitCount;
+                    int           symbol   = decode(currentLengthCode);
+                    if (symbol == 256) {
+                        inBlock = false;
+                    } else if (position == limit) {
+                        // Only the end of block symbol can be consumed once the buffer is full.
+                        currentBits     = bits;
+                        currentBitCount = bitCount;
+                        full            = true;
+                    } else if (symbol >= 0 && symbol < 256) {
+                        buffer[position++] = static_cast<unsigned char>(symbol);
+                    } else if (symbol > 256 && symbol < 286) {
+                        unsigned code = static_cast<unsigned>(symbol - 257);
+                        currentRemaining = lengthBase[code] + take(lengthExtra[code]);
+
+                        int distanceCode = decode(currentDistanceCode);
+                        success = (distanceCode >= 0 && distanceCode < 30);
+                        if (success) {
+                            currentDistance = distanceBase[distanceCode] + take(distanceExtra[distanceCode]);
+                            success         = copyMatch(buffer, position, limit, history, historySize);
+                            full            = (currentRemaining > 0);
+                        }
+                    } else {
+                        success = false;
+                    }
+
+                    success = success && !overrun();
+                }
+
+                if (!success) {
+                    currentMode = Mode::CORRUPT;
+                } else if (!inBlock) {
+                    currentMode = Mode::BLOCK_HEADER;
+                }
+            }
+
+            const unsigned char* currentNext;
+            const unsigned char* currentEnd;
+            std::uint64_t        currentBits;
+            unsigned             currentBitCount;
+            unsigned long        currentPaddingBytes;
+            Mode                 currentMode;
+            bool                 currentFinalBlock;
+            unsigned long        currentRemaining;
+            unsigned long        currentDistance;
+            std::uint32_t        currentAdler;
+            unsigned long        currentSize;
+            Huffman              currentLengthCode;
+            Huffman              currentDistanceCode;
+    };
+
+    /**
+     * Function that inflates an entire payload generated in the qCompress format.
+     *
+     * \param[in] source          The compressed payload, including the 4 byte size header.
+     *
+     * \param[in] sourceSize      The size of the compressed payload, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the decompressed payload.
+     *
+     * \param[in] destinationSize The exact size of the decompressed payload, in bytes.
+     *
+     * \param[in] dictionary      The preset dictionary.  A null pointer indicates none.
+     *
+     * \param[in] dictionarySize  The size of the preset dictionary, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt.
+     */
+    inline bool inflateQt(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize,
+            const unsigned char* dictionary = nullptr,
+            unsigned long        dictionarySize = 0
+        ) {
+        // qCompress stores an empty payload as a bare size header.
+        bool success = (sourceSize >= 4);
+        if (success && destinationSize > 0) {
+            Inflater      inflater(source, sourceSize);
+            unsigned long position = 0;
+
+            success = (
+                   inflater.recordedSize() == (destinationSize & 0xFFFFFFFFUL)
+                && inflater.run(destination, position, destinationSize, dictionary, dictionarySize)
+                   == Inflater::Status::DONE
+                && position == destinationSize
+            );
+        }
+
+        return success;
+    }
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the function used to decompress a single chunk compressed with a codec.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ *
+ * \param[in] codec        The codec used to compress the chunk.
+ */
+void dumpChunkDecoder(std::ostream& outputStream, unsigned indentation, Codec codec) {
+    switch (codec) {
+        case Codec::NONE: {
+            dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+
+#ifndef BUILD_PAYLOAD_STORED_CHUNK_RUNTIME
+#define BUILD_PAYLOAD_STORED_CHUNK_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that copies a stored, uncompressed, chunk.
+     *
+     * \param[in] source          The stored chunk.
+     *
+     * \param[in] sourceSize      The size of the stored chunk, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the chunk.
+     *
+     * \param[in] destinationSize The exact size of the chunk, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the sizes do not match.
+     */
+    inline bool storedChunkDecompress(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize
+        ) {
+        bool success = (sourceSize == destinationSize);
+        if (success) {
+            std::memcpy(destination, source, destinationSize);
+        }
+
+        return success;
+    }
+}
+
+#endif
+
+)");
+            break;
+        }
+
+        case Codec::QT_ZLIB: {
+            dumpInflateRuntime(outputStream, indentation);
+            dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_QT_CHUNK_RUNTIME
+#define BUILD_PAYLOAD_QT_CHUNK_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that decompresses a chunk generated by qCompress, inflating straight into the destination.
+     *
+     * \param[in] source          The compressed chunk.
+     *
+     * \param[in] sourceSize      The size of the compressed chunk, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the decompressed chunk.
+     *
+     * \param[in] destinationSize The exact size of the decompressed chunk, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the chunk is corrupt.
+     */
+    inline bool qtChunkDecompress(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize
+        ) {
+        return inflateQt(source, sourceSize, destination, destinationSize);
+    }
+}
+
+#endif
+
+)");
+            break;
+        }
+
+        case Codec::ZSTD: {
+            dumpCode(outputStream, 0, indentation, R"(#include <memory>
+#include <zstd.h>
+
+#ifndef BUILD_PAYLOAD_ZSTD_CHUNK_RUNTIME
+#define BUILD_PAYLOAD_ZSTD_CHUNK_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Deleter that releases a Zstandard decompression context.
+     */
+    struct ZstdContextDeleter {
+        void operator()(ZSTD_DCtx* context) const {
+            ZSTD_freeDCtx(context);
+        }
+    };
+
+    /**
+     * Function that decompresses a chunk holding a single Zstandard frame.
+     *
+     * \param[in] source          The compressed chunk.
+     *
+     * \param[in] sourceSize      The size of the compressed chunk, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the decompressed chunk.
+     *
+     * \param[in] destinationSize The exact size of the decompressed chunk, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the chunk is corrupt.
+     */
+    inline bool zstdChunkDecompress(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize
+        ) {
+        // Each thread keeps its own context so that decompressing a chunk does not allocate.
+        static thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> context(ZSTD_createDCtx());
+
+        bool success = false;
+        if (context) {
+            std::size_t result = ZSTD_decompressDCtx(context.get(), destination, destinationSize, source, sourceSize);
+            success = (!ZSTD_isError(result) && result == destinationSize);
+        }
+
+        return success;
+    }
+}
+
+#endif
+
+)");
+            break;
+        }
+
+        case Codec::LZ4: {
+            break;
+        }
+
+        case Codec::XZ: {
+            dumpCode(outputStream, 0, indentation, R"(#include <cstdint>
+#include <lzma.h>
+
+#ifndef BUILD_PAYLOAD_XZ_CHUNK_RUNTIME
+#define BUILD_PAYLOAD_XZ_CHUNK_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that decompresses a chunk holding a single .xz stream.
+     *
+     * \param[in] source          The compressed chunk.
+     *
+     * \param[in] sourceSize      The size of the compressed chunk, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the decompressed chunk.
+     *
+     * \param[in] destinationSize The exact size of the decompressed chunk, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the chunk is corrupt.
+     */
+    inline bool xzChunkDecompress(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize
+        ) {
+        std::uint64_t memoryLimit    = UINT64_MAX;
+        std::size_t   sourcePosition = 0;
+        std::size_t   outputPosition = 0;
+        lzma_ret      result         = lzma_stream_buffer_decode(
+            &memoryLimit,
+            0,
+            nullptr,
+            source,
+            &sourcePosition,
+            sourceSize,
+            destination,
+            &outputPosition,
+            destinationSize
+        );
+
+        return result == LZMA_OK && outputPosition == destinationSize;
+    }
+}
+
+#endif
+
+)");
+            break;
+        }
+    }
+}
+
+
+/**
+ * Function that returns the name of the generated function used to decompress a payload compressed against the shared
+ * dictionary.
+ *
+ * \param[in] codec The codec of interest.  Only the qt and zstd codecs support a shared dictionary.
+ *
+ * \return Returns the fully qualified function name.  An empty string is returned for codecs without dictionary
+ *         support.
+ */
+std::string dictionaryDecoderName(Codec codec) {
+    std::string result;
+
+    switch (codec) {
+        case Codec::QT_ZLIB: { result = "BuildPayload::qtDictionaryDecompress";   break; }
+        case Codec::ZSTD:    { result = "BuildPayload::zstdDictionaryDecompress"; break; }
+
+        case Codec::NONE:
+        case Codec::LZ4:
+        case Codec::XZ: {
+            break;
+        }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that dumps the functions used to decompress payloads compressed against the shared dictionary.  Payloads
+ * compressed with the qt codec and a dictionary can not be decompressed by qUncompress and use the generated inflater.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ *
+ * \param[in] codecs       The codecs in use.
+ */
+void dumpDictionaryRuntime(std::ostream& outputStream, unsigned indentation, const std::vector<Codec>& codecs) {
+    for (Codec codec : codecs) {
+        switch (codec) {
+            case Codec::QT_ZLIB: {
+                dumpInflateRuntime(outputStream, indentation);
+                dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_QT_DICTIONARY_RUNTIME
+#define BUILD_PAYLOAD_QT_DICTIONARY_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that decompresses a payload generated in the qCompress format against a preset dictionary.
+     *
+     * \param[in] source          The compressed payload, including the 4 byte size header.
+     *
+     * \param[in] sourceSize      The size of the compressed payload, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the decompressed payload.
+     *
+     * \param[in] destinationSize The exact size of the decompressed payload, in bytes.
+     *
+     * \param[in] dictionary      The shared dictionary.
+     *
+     * \param[in] dictionarySize  The size of the shared dictionary, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt.
+     */
+    inline bool qtDictionaryDecompress(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize,
+            const unsigned char* dictionary,
+            unsigned long        dictionarySize
+        ) {
+        return inflateQt(source, sourceSize, destination, destinationSize, dictionary, dictionarySize);
+    }
+}
+
+#endif
+
+)");
+                break;
+            }
+
+            case Codec::ZSTD: {
+                dumpChunkDecoder(outputStream, indentation, Codec::ZSTD);
+                dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_ZSTD_DICTIONARY_RUNTIME
+#define BUILD_PAYLOAD_ZSTD_DICTIONARY_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that decompresses a payload holding a single Zstandard frame compressed against a dictionary.
+     *
+     * \param[in] source          The compressed payload.
+     *
+     * \param[in] sourceSize      The size of the compressed payload, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the decompressed payload.
+     *
+     * \param[in] destinationSize The exact size of the decompressed payload, in bytes.
+     *
+     * \param[in] dictionary      The shared dictionary.
+     *
+     * \param[in] dictionarySize  The size of the shared dictionary, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt.
+     */
+    inline bool zstdDictionaryDecompress(
+            const unsigned char* source,
+            unsigned long        sourceSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize,
+            const unsigned char* dictionary,
+            unsigned long        dictionarySize
+        ) {
+        // Each thread keeps its own context so that decompressing a payload does not allocate.
+        static thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> context(ZSTD_createDCtx());
+
+        bool success = false;
+        if (context) {
+            std::size_t result = ZSTD_decompress_usingDict(
+                context.get(),
+                destination,
+                destinationSize,
+                source,
+                sourceSize,
+                dictionary,
+                dictionarySize
+            );
+
+            success = (!ZSTD_isError(result) && result == destinationSize);
+        }
+
+        return success;
+    }
+}
+
+#endif
+
+)");
+                break;
+            }
+
+            case Codec::NONE:
+            case Codec::LZ4:
+            case Codec::XZ: {
+                break;
+            }
+        }
+    }
+}
+
+
+/**
+ * Function that dumps the structures and functions used to read chunked payloads along with the chunk decoders for
+ * the codecs in use.  The LZ4 chunk decoder is provided by \ref dumpLz4Runtime.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ *
+ * \param[in] codecs       The codecs used to compress the chunks.
+ */
+void dumpChunkedRuntime(std::ostream& outputStream, unsigned indentation, const std::vector<Codec>& codecs) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+
+#ifndef BUILD_PAYLOAD_CHUNKED_RUNTIME
+#define BUILD_PAYLOAD_CHUNKED_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Structure describing a payload that was divided into independently compressed chunks.
+     */
+    struct ChunkedPayload {
+        /**
+         * The compressed chunks, back to back.
+         */
+        const unsigned char* data;
+
+        /**
+         * The offset of each compressed chunk within the data followed by the total compressed size.
+         */
+        const unsigned long* chunkOffsets;
+
+        /**
+         * The number of chunks.
+         */
+        unsigned long numberChunks;
+
+        /**
+         * The uncompressed size of every chunk but the last, in bytes.
+         */
+        unsigned long chunkSize;
+
+        /**
+         * The uncompressed size of the payload, in bytes.
+         */
+        unsigned long uncompressedSize;
+    };
+
+    /**
+     * Function that determines the uncompressed size of a chunk.
+     *
+     * \param[in] payload    The chunked payload.
+     *
+     * \param[in] chunkIndex The zero based index of the chunk.
+     *
+     * \return Returns the uncompressed size of the chunk, in bytes.
+     */
+    inline unsigned long chunkLength(const ChunkedPayload& payload, unsigned long chunkIndex) {
+        unsigned long chunkStart = chunkIndex * payload.chunkSize;
+        unsigned long remaining  = payload.uncompressedSize - chunkStart;
+        return remaining < payload.chunkSize ? remaining : payload.chunkSize;
+    }
+
+    /**
+     * Function that reads a range of bytes from a chunked payload.  Only the chunks covering the range are
+     * decompressed.
+     *
+     * \param[in] payload     The chunked payload.
+     *
+     * \param[in] offset      The offset of the first byte to read.
+     *
+     * \param[in] length      The number of bytes to read.
+     *
+     * \param[in] destination The buffer to receive the bytes.
+     *
+     * \param[in] decoder     The function used to decompress a single chunk.
+     *
+     * \return Returns true on success.  Returns false if the range is out of bounds or the payload is corrupt.
+     */
+    template<typename Decoder> inline bool readChunkedRange(
+            const ChunkedPayload& payload,
+            unsigned long         offset,
+            unsigned long         length,
+            unsigned char*        destination,
+            Decoder               decoder
+        ) {
+        bool success = (offset <= payload.uncompressedSize && length <= payload.uncompressedSize - offset);
+
+        if (success && length > 0) {
+            unsigned long              rangeEnd   = offset + length;
+            unsigned long              firstChunk = offset / payload.chunkSize;
+            unsigned long              lastChunk  = (rangeEnd - 1) / payload.chunkSize;
+            std::vector<unsigned char> chunkBuffer;
+
+            for (unsigned long chunkIndex=firstChunk ; success && chunkIndex<=lastChunk ; ++chunkIndex) {
+                unsigned long        chunkStart = chunkIndex * payload.chunkSize;
+                unsigned long        chunkEnd   = chunkStart + chunkLength(payload, chunkIndex);
+                const unsigned char* source     = payload.data + payload.chunkOffsets[chunkIndex];
+                unsigned long        sourceSize = payload.chunkOffsets[chunkIndex + 1]
+                                                  - payload.chunkOffsets[chunkIndex];
+
+                if (chunkStart >= offset && chunkEnd <= rangeEnd) {
+                    success = decoder(source, sourceSize, destination + (chunkStart - offset), chunkEnd - chunkStart);
+                } else {
+                    unsigned long copyStart = chunkStart > offset ? chunkStart : offset;
+                    unsigned long copyEnd   = chunkEnd < rangeEnd ? chunkEnd : rangeEnd;
+
+                    chunkBuffer.resize(chunkEnd - chunkStart);
+                    success = decoder(source, sourceSize, chunkBuffer.data(), chunkEnd - chunkStart);
+                    if (success) {
+                        std::memcpy(
+                            destination + (copyStart - offset),
+                            chunkBuffer.data() + (copyStart - chunkStart),
+                            copyEnd - copyStart
+                        );
+                    }
+                }
+            }
+        }
+
+        return success;
+    }
+
+    /**
+     * Class that hands out the chunks of a payload to any number of threads, each decompressing directly into its
+     * place in a shared destination buffer.
+     */
+    template<typename Decoder> class ChunkDecompressor {
+        public:
+            /**
+             * Constructor.
+             *
+             * \param[in] payload     The chunked payload.
+             *
+             * \param[in] destination The buffer to receive the entire decompressed payload.
+             *
+             * \param[in] decoder     The function used to decompress a single chunk.
+             */
+            ChunkDecompressor(
+                    const ChunkedPayload& payload,
+                    unsigned char*        destination,
+                    Decoder               decoder
+                ):currentPayload(
+                    payload
+                ),currentDestination(
+                    destination
+                ),currentDecoder(
+                    decoder
+                ),nextChunk(
+                    0
+                ),currentSuccess(
+                    true
+                ) {}
+
+            /**
+             * Method that decompresses chunks until none remain.  May be called from any number of threads.
+             */
+            void run() {
+                unsigned long chunkIndex = nextChunk++;
+                while (currentSuccess && chunkIndex < currentPayload.numberChunks) {
+                    unsigned long sourceStart = currentPayload.chunkOffsets[chunkIndex];
+                    unsigned long sourceEnd   = currentPayload.chunkOffsets[chunkIndex + 1];
+
+                    if (!currentDecoder(
+                            currentPayload.data + sourceStart,
+                            sourceEnd - sourceStart,
+                            currentDestination + chunkIndex * currentPayload.chunkSize,
+                            chunkLength(currentPayload, chunkIndex)
+                        )) {
+                        currentSuccess = false;
+                    }
+
+                    chunkIndex = nextChunk++;
+                }
+            }
+
+            /**
+             * Method you can use to determine if every chunk decompressed successfully.
+             *
+             * \return Returns true on success.  Returns false if the payload is corrupt.
+             */
+            bool success() const {
+                return currentSuccess;
+            }
+
+        private:
+            const ChunkedPayload&      currentPayload;
+            unsigned char*             currentDestination;
+            Decoder                    currentDecoder;
+            std::atomic<unsigned long> nextChunk;
+            std::atomic<bool>          currentSuccess;
+    };
+
+    /**
+     * Function that decompresses an entire chunked payload using a pool of threads.
+     *
+     * \param[in] payload       The chunked payload.
+     *
+     * \param[in] destination   The buffer to receive the payload.  The buffer must hold payload.uncompressedSize
+     *                          bytes.
+     *
+     * \param[in] decoder       The function used to decompress a single chunk.
+     *
+     * \param[in] numberThreads The number of threads to use, including the calling thread.  A value of 0 uses one
+     *                          thread per hardware thread.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt.
+     */
+    template<typename Decoder> inline bool decompressChunked(
+            const ChunkedPayload& payload,
+            unsigned char*        destination,
+            Decoder               decoder,
+            unsigned              numberThreads = 0
+        ) {
+        if (numberThreads == 0) {
+            numberThreads = std::thread::hardware_concurrency();
+        }
+
+        if (numberThreads > payload.numberChunks) {
+            numberThreads = static_cast<unsigned>(payload.numberChunks);
+        }
+
+        ChunkDecompressor<Decoder> decompressor(payload, destination, decoder);
+        std::vector<std::thread>   threads;
+        for (unsigned i=1 ; i<numberThreads ; ++i) {
+            threads.push_back(std::thread([&decompressor]() { decompressor.run(); }));
+        }
+
+        decompressor.run();
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        return decompressor.success();
+    }
+
+    /**
+     * Function that decompresses an entire chunked payload using a caller supplied executor, such as an existing
+     * thread pool.  The calling thread also decompresses chunks and then waits for every task to finish.
+     *
+     * \param[in] payload     The chunked payload.
+     *
+     * \param[in] destination The buffer to receive the payload.  The buffer must hold payload.uncompressedSize bytes.
+     *
+     * \param[in] decoder     The function used to decompress a single chunk.
+     *
+     * \param[in] executor    A callable accepting a std::function<void()> that it must run exactly once on any
+     *                        thread.
+     *
+     * \param[in] numberTasks The number of tasks to submit to the executor.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt.
+     */
+    template<typename Decoder, typename Executor> inline bool decompressChunkedOn(
+            const ChunkedPayload& payload,
+            unsigned char*        destination,
+            Decoder               decoder,
+            Executor&&            executor,
+            unsigned              numberTasks
+        ) {
+        ChunkDecompressor<Decoder> decompressor(payload, destination, decoder);
+        std::mutex                 mutex;
+        std::condition_variable    tasksFinished;
+        unsigned                   remainingTasks = numberTasks;
+
+        for (unsigned i=0 ; i<numberTasks ; ++i) {
+            executor(
+                std::function<void()>(
+                    [&decompressor, &mutex, &tasksFinished, &remainingTasks]() {
+                        decompressor.run();
+
+                        std::lock_guard<std::mutex> lock(mutex);
+                        --remainingTasks;
+                        tasksFinished.notify_all();
+                    }
+                )
+            );
+        }
+
+        decompressor.run();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        tasksFinished.wait(lock, [&remainingTasks]() { return remainingTasks == 0; });
+
+        return decompressor.success();
+    }
+}
+
+#endif
+
+)");
+
+    for (Codec codec : codecs) {
+        dumpChunkDecoder(outputStream, indentation, codec);
+    }
+}
+
+
+/**
+ * Function that dumps the structures and functions used to reassemble payloads from a shared store of content defined
+ * chunks, along with the chunk decoder for each of the codecs in use.  The LZ4 chunk decoder is provided by
+ * \ref dumpLz4Runtime.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ *
+ * \param[in] codecs       The codecs used to compress the chunks.
+ */
+void dumpChunkStoreRuntime(std::ostream& outputStream, unsigned indentation, const std::vector<Codec>& codecs) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+#include <vector>
+
+#ifndef BUILD_PAYLOAD_CHUNK_STORE_RUNTIME
+#define BUILD_PAYLOAD_CHUNK_STORE_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Structure describing a store of unique, independently compressed, chunks shared by several payloads.
+     */
+    struct ChunkStore {
+        /**
+         * The compressed chunks, back to back.
+         */
+        const unsigned char* data;
+
+        /**
+         * The offset of each compressed chunk within the data followed by the total compressed size.
+         */
+        const unsigned long* offsets;
+
+        /**
+         * The uncompressed size of each chunk, in bytes.
+         */
+        const unsigned long* lengths;
+
+        /**
+         * The number of chunks in the store.
+         */
+        unsigned long numberChunks;
+    };
+
+    /**
+     * Structure describing a payload as a list of chunks held in a chunk store.
+     */
+    struct ChunkList {
+        /**
+         * The store holding the chunks.
+         */
+        const ChunkStore* store;
+
+        /**
+         * The index of each chunk of the payload within the store, in payload order.
+         */
+        const unsigned long* chunks;
+
+        /**
+         * The offset, within the payload, of the first copy of each chunk of the payload, in payload order.  Chunks
+         * that do not appear earlier in the payload hold the uncompressed size of the payload.
+         */
+        const unsigned long* sources;
+
+        /**
+         * The number of chunks making up the payload.
+         */
+        unsigned long numberChunks;
+
+        /**
+         * The uncompressed size of the payload, in bytes.
+         */
+        unsigned long uncompressedSize;
+    };
+
+    /**
+     * Function that reassembles a payload from its chunks.  A chunk that appears more than once within the payload is
+     * decompressed only once and then copied from its first copy, located through the chunk list, so reassembly does
+     * not allocate.
+     *
+     * \param[in] list        The chunk list describing the payload.
+     *
+     * \param[in] destination The buffer to receive the payload.  The buffer must hold list.uncompressedSize bytes.
+     *
+     * \param[in] decoder     The function used to decompress a single chunk.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt.
+     */
+    template<typename Decoder> inline bool reassembleChunks(
+            const ChunkList& list,
+            unsigned char*   destination,
+            Decoder          decoder
+        ) {
+        const ChunkStore& store    = *list.store;
+        unsigned long     position = 0;
+        bool              success  = true;
+
+        for (unsigned long i=0 ; success && i<list.numberChunks ; ++i) {
+            unsigned long chunkIndex = list.chunks[i];
+            unsigned long length     = store.lengths[chunkIndex];
+            unsigned long source     = list.sources[i];
+
+            if (source < position) {
+                std::memcpy(destination + position, destination + source, length);
+            } else {
+                success = decoder(
+                    store.data + store.offsets[chunkIndex],
+                    store.offsets[chunkIndex + 1] - store.offsets[chunkIndex],
+                    destination + position,
+                    length
+                );
+            }
+
+            position += length;
+        }
+
+        return success;
+    }
+
+    /**
+     * Function that streams a payload to a sink one chunk at a time so that only a single chunk is held in memory.
+     *
+     * \param[in] list    The chunk list describing the payload.
+     *
+     * \param[in] decoder The function used to decompress a single chunk.
+     *
+     * \param[in] sink    A callable, bool sink(const unsigned char* data, unsigned long length), that receives each
+     *                    chunk in order.  Returning false from the sink stops the stream.
+     *
+     * \return Returns true on success.  Returns false if the payload is corrupt or the sink stopped the stream.
+     */
+    template<typename Decoder, typename Sink> inline bool streamChunks(
+            const ChunkList& list,
+            Decoder          decoder,
+            Sink&&           sink
+        ) {
+        const ChunkStore&          store         = *list.store;
+        std::vector<unsigned char> buffer;
+        unsigned long              bufferedChunk = store.numberChunks;
+        bool                       success       = true;
+
+        for (unsigned long i=0 ; success && i<list.numberChunks ; ++i) {
+            unsigned long chunkIndex = list.chunks[i];
+            unsigned long length     = store.lengths[chunkIndex];
+
+            if (chunkIndex != bufferedChunk) {
+                buffer.resize(length);
+                success = decoder(
+                    store.data + store.offsets[chunkIndex],
+                    store.offsets[chunkIndex + 1] - store.offsets[chunkIndex],
+                    buffer.data(),
+                    length
+                );
+
+                bufferedChunk = chunkIndex;
+            }
+
+            if (success) {
+                success = sink(static_cast<const unsigned char*>(buffer.data()), length);
+            }
+        }
+
+        return success;
+    }
+}
+
+#endif
+
+)");
+
+    for (Codec codec : codecs) {
+        dumpChunkDecoder(outputStream, indentation, codec);
+    }
+}
+
+
+/**
+ * Function that dumps the functions used to rebuild a payload from a baseline and a delta, along with the chunk
+ * decoder for each of the codecs in use.  The LZ4 chunk decoder is provided by \ref dumpLz4Runtime.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ *
+ * \param[in] codecs       The codecs used to compress the deltas.
+ */
+void dumpDeltaRuntime(std::ostream& outputStream, unsigned indentation, const std::vector<Codec>& codecs) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+#include <vector>
+
+#ifndef BUILD_PAYLOAD_DELTA_RUNTIME
+#define BUILD_PAYLOAD_DELTA_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that reads a little endian base 128 value from a delta.
+     *
+     * \param[in,out] position The current position within the delta.  Advanced past the value.
+     *
+     * \param[in]     end      The end of the delta.
+     *
+     * \param[out]    value    The value read.
+     *
+     * \return Returns true on success.  Returns false if the delta is truncated.
+     */
+    inline bool readDeltaValue(const unsigned char*& position, const unsigned char* end, unsigned long long& value) {
+        unsigned shift    = 0;
+        bool     complete = false;
+
+        value = 0;
+        while (!complete && position < end && shift < 64) {
+            unsigned char v = *position++;
+            value    |= static_cast<unsigned long long>(v & 0x7F) << shift;
+            shift    += 7;
+            complete  = ((v & 0x80) == 0);
+        }
+
+        return complete;
+    }
+
+    /**
+     * Function that calculates the 64-bit FNV-1a hash used to identify a baseline.
+     *
+     * \param[in] data The baseline.
+     *
+     * \param[in] size The size of the baseline, in bytes.
+     *
+     * \return Returns the hash.
+     */
+    inline unsigned long long deltaHash(const unsigned char* data, unsigned long size) {
+        unsigned long long hash = 0xCBF29CE484222325ULL;
+        for (unsigned long i=0 ; i<size ; ++i) {
+            hash = (hash ^ data[i]) * 0x100000001B3ULL;
+        }
+
+        return hash;
+    }
+
+    /**
+     * Function that rebuilds data from a baseline and a delta.  The delta is a sequence of instructions, each a value
+     * holding the instruction length shifted left by one with the low bit set for a copy from the baseline.  Literal
+     * bytes follow an add instruction.  A copy is followed by the zigzag encoded distance from the end of the previous
+     * copy to the baseline offset to copy from.
+     *
+     * \param[in] baseline        The baseline.
+     *
+     * \param[in] baselineSize    The size of the baseline, in bytes.
+     *
+     * \param[in] delta           The uncompressed delta.
+     *
+     * \param[in] deltaSize       The size of the delta, in bytes.
+     *
+     * \param[in] destination     The buffer to receive the rebuilt data.
+     *
+     * \param[in] destinationSize The exact size of the rebuilt data, in bytes.
+     *
+     * \return Returns true on success.  Returns false if the delta is corrupt or does not match the baseline.
+     */
+    inline bool applyDelta(
+            const unsigned char* baseline,
+            unsigned long        baselineSize,
+            const unsigned char* delta,
+            unsigned long        deltaSize,
+            unsigned char*       destination,
+            unsigned long        destinationSize
+        ) {
+        const unsigned char* position = delta;
+        const unsigned char* end      = delta + deltaSize;
+        unsigned long long   copyEnd  = 0;
+        unsigned long long   written  = 0;
+        bool                 success  = true;
+
+        while (success && position < end) {
+            unsigned long long instruction;
+            success = readDeltaValue(position, end, instruction);
+            if (success) {
+                unsigned long long length = instruction >> 1;
+                success = (length <= destinationSize - written);
+
+                if (success && (instruction & 1) != 0) {
+                    unsigned long long distance;
+                    success = readDeltaValue(position, end, distance);
+                    if (success) {
+                        unsigned long long offset = (
+                              (distance & 1) != 0
+                            ? copyEnd - (distance >> 1) - 1
+                            : copyEnd + (distance >> 1)
+                        );
+
+                        success = (offset <= baselineSize && length <= baselineSize - offset);
+                        if (success) {
+                            std::memcpy(destination + written, baseline + offset, length);
+                            copyEnd = offset + length;
+                        }
+                    }
+                } else if (success) {
+                    success = (length <= static_cast<unsigned long long>(end - position));
+                    if (success) {
+                        std::memcpy(destination + written, position, length);
+                        position += length;
+                    }
+                }
+
+                written += length;
+            }
+        }
+
+        return success && written == destinationSize;
+    }
+}
+
+#endif
+
+)");
+
+    for (Codec codec : codecs) {
+        dumpChunkDecoder(outputStream, indentation, codec);
+    }
+}
+
+
+/**
+ * Function that dumps the class used by the generated accessors to decompress a payload once on first use, along with
+ * the chunk decoder for each of the codecs in use.  The LZ4 chunk decoder is provided by \ref dumpLz4Runtime.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ *
+ * \param[in] codecs       The codecs used to compress the payloads.
+ */
+void dumpAccessorRuntime(std::ostream& outputStream, unsigned indentation, const std::vector<Codec>& codecs) {
+    dumpCode(outputStream, 0, indentation, R"(#include <atomic>
+#include <memory>
+#include <mutex>
+
+#ifndef BUILD_PAYLOAD_ACCESSOR_RUNTIME
+#define BUILD_PAYLOAD_ACCESSOR_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Structure referencing a block of decompressed data.
+     */
+    struct Span {
+        /**
+         * Pointer to the first byte.  A null pointer indicates that the data could not be decompressed.
+         */
+        const unsigned char* data;
+
+        /**
+         * The size of the data, in bytes.
+         */
+        unsigned long size;
+    };
+
+    /**
+     * Class that decompresses a payload exactly once, on first use, and then holds the result for the lifetime of the
+     * program.  Once decompressed, access is a single acquire load.  The constructor is constexpr so instances with
+     * static storage duration are constant initialized.
+     */
+    class LazyPayload {
+        public:
+            /**
+             * Enumeration of payload states.
+             */
+            enum State : int {
+                /**
+                 * Indicates the payload has not yet been decompressed.  Access will block while decompressing.
+                 */
+                PENDING,
+
+                /**
+                 * Indicates the payload is decompressed.  Access will not block.
+                 */
+                READY,
+
+                /**
+                 * Indicates the payload is corrupt.
+                 */
+                FAILED
+            };
+
+            constexpr LazyPayload():currentState(PENDING),currentSize(0) {}
+
+            /**
+             * Method that returns the decompressed payload, decompressing it if this is the first call.  May be
+             * called from any number of threads.  Threads arriving while the payload is being decompressed wait for
+             * the first thread to finish.
+             *
+             * \param[in] size    The uncompressed size of the payload, in bytes.
+             *
+             * \param[in] decoder A callable, bool decoder(unsigned char* destination), that decompresses the payload
+             *                    into a buffer of the uncompressed size.
+             *
+             * \return Returns the decompressed payload.  An empty span with a null pointer is returned if the payload
+             *         is corrupt.
+             */
+            template<typename Decoder> Span get(unsigned long size, Decoder decoder) {
+                if (currentState.load(std::memory_order_acquire) == PENDING) {
+                    std::call_once(
+                        onceFlag,
+                        [this, size, &decoder]() {
+                            std::unique_ptr<unsigned char[]> buffer(new unsigned char[size > 0 ? size : 1]);
+                            if (decoder(buffer.get())) {
+                                currentData = std::move(buffer);
+                                currentSize = size;
+                                currentState.store(READY, std::memory_order_release);
+                            } else {
+                                currentState.store(FAILED, std::memory_order_release);
+                            }
+                        }
+                    );
+                }
+
+                Span result = { nullptr, 0 };
+                if (currentState.load(std::memory_order_acquire) == READY) {
+                    result.data = currentData.get();
+                    result.size = currentSize;
+                }
+
+                return result;
+            }
+
+            /**
+             * Method you can use to determine if the payload has been decompressed without blocking.
+             *
+             * \return Returns the current payload state.
+             */
+            State state() const {
+                return static_cast<State>(currentState.load(std::memory_order_acquire));
+            }
+
+        private:
+            std::atomic<int>                 currentState;
+            std::once_flag                   onceFlag;
+            std::unique_ptr<unsigned char[]> currentData;
+            unsigned long                    currentSize;
+    };
+}
+
+#endif
+
+)");
+
+    for (Codec codec : codecs) {
+        dumpChunkDecoder(outputStream, indentation, codec);
+    }
+}
+
+
+/**
+ * Function that builds a generated return statement that evaluates to true only if every step succeeds.  Steps may
+ * span several lines.  Continuation lines are indented relative to the start of the step.
+ *
+ * \param[in] steps       The expressions to be evaluated, in order.
+ *
+ * \param[in] indentation The indentation of the statement, in spaces.
+ *
+ * \return Returns the statement, including the trailing newline.
+ */
+std::string toReturnStatement(const std::vector<std::string>& steps, unsigned indentation) {
+    std::string indentationString(indentation, ' ');
+    std::string continuation = "\n" + indentationString + "       ";
+
+    std::vector<std::string> indentedSteps;
+    for (std::string step : steps) {
+        std::size_t position = step.find('\n');
+        while (position != std::string::npos) {
+            step.replace(position, 1, continuation);
+            position = step.find('\n', position + continuation.size());
+        }
+
+        indentedSteps.push_back(step);
+    }
+
+    std::string result;
+    if (indentedSteps.size() == 1) {
+        result = indentationString + "return " + indentedSteps.front() + ";\n";
+    } else {
+        result = indentationString + "return (\n";
+        for (unsigned i=0 ; i<indentedSteps.size() ; ++i) {
+            result += indentationString + (i == 0 ? "       " : "    && ") + indentedSteps[i] + "\n";
+        }
+
+        result += indentationString + ");\n";
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that converts a variable type to the equivalent constexpr type by replacing the const qualifier.
+ *
+ * \param[in] type The variable type to convert.
+ *
+ * \return Returns the constexpr type.
+ */
+std::string toConstexprType(const std::string& type) {
+    std::string result   = " " + type + " ";
+    std::size_t position = result.find(" const ");
+    if (position != std::string::npos) {
+        result.replace(position + 1, 5, "constexpr");
+    } else {
+        result.insert(0, " constexpr");
+    }
+
+    return result.substr(1, result.size() - 2);
+}
+
+
+/**
+ * Function that dumps the function that decompresses a payload directly into caller owned memory.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] name            The name of the payload, including any prefix.
+ *
+ * \param[in] decodeSteps     The expressions, evaluated in order, that decompress the payload into a buffer named
+ *                            destination.  Each expression must evaluate to true on success.
+ */
+void dumpDecompressInto(
+        std::ostream&                   outputStream,
+        unsigned                        leftIndentation,
+        unsigned                        indentation,
+        const std::string&              name,
+        const std::vector<std::string>& decodeSteps
+    ) {
+    std::vector<std::string> steps(1, "size >= " + name + "UncompressedSize");
+    steps.insert(steps.end(), decodeSteps.begin(), decodeSteps.end());
+
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that decompresses " + name + " directly into caller owned memory, such as an arena\n"
+              " * or a pinned buffer.  The destination must hold at least " + name + "UncompressedSize bytes.\n"
+              " */\n"
+              "static inline bool " + name + "DecompressInto(unsigned char* destination, unsigned long size) {\n"
+            + toReturnStatement(steps, 4) +
+              "}\n"
+              "\n"
+        ).c_str()
+    );
+}
+
+
+/**
+ * Function that dumps the lazy accessor for a payload.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] name            The name of the payload, including any prefix.
+ *
+ * \param[in] decodeSteps     The expressions, evaluated in order, that decompress the payload into a buffer named
+ *                            destination.  Each expression must evaluate to true on success.
+ */
+void dumpAccessor(
+        std::ostream&                   outputStream,
+        unsigned                        leftIndentation,
+        unsigned                        indentation,
+        const std::string&              name,
+        const std::vector<std::string>& decodeSteps
+    ) {
+    std::string decodeStatement = toReturnStatement(decodeSteps, 12);
+
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that returns the object holding the decompressed contents of " + name + ".\n"
+              " */\n"
+              "static inline BuildPayload::LazyPayload& " + name + "Lazy() {\n"
+              "    static BuildPayload::LazyPayload payload;\n"
+              "    return payload;\n"
+              "}\n"
+              "\n"
+              "/**\n"
+              " * Function that returns the decompressed contents of " + name + ", decompressing them once on\n"
+              " * first use.  Safe to call from any thread.  Returns an empty span if the payload is corrupt.\n"
+              " */\n"
+              "static inline BuildPayload::Span " + name + "Get() {\n"
+              "    return " + name + "Lazy().get(\n"
+              "        " + name + "UncompressedSize,\n"
+              "        [](unsigned char* destination) {\n"
+            + decodeStatement +
+              "        }\n"
+              "    );\n"
+              "}\n"
+              "\n"
+              "/**\n"
+              " * Function you can use to determine, without blocking, if " + name + " has been decompressed.\n"
+              " */\n"
+              "static inline BuildPayload::LazyPayload::State " + name + "State() {\n"
+              "    return " + name + "Lazy().state();\n"
+              "}\n"
+              "\n"
+        ).c_str()
+    );
+}
+
+
+/**
+ * Function that dumps the function used to record the first access to each payload in an access profile.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpProfileRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+#ifndef BUILD_PAYLOAD_PROFILE_RUNTIME
+#define BUILD_PAYLOAD_PROFILE_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Function that appends a payload name to the access profile named by the BUILD_PAYLOAD_PROFILE environment
+     * variable.  Nothing is recorded if the variable is not set.  Names are appended so delete the file to start a
+     * new profile.
+     *
+     * \param[in] name The payload name.
+     */
+    inline void recordAccess(const char* name) {
+        static std::mutex           mutex;
+        std::lock_guard<std::mutex> lock(mutex);
+
+        static const char* filename = std::getenv("BUILD_PAYLOAD_PROFILE");
+        if (filename != nullptr) {
+            std::FILE* file = std::fopen(filename, "a");
+            if (file != nullptr) {
+                std::fprintf(file, "%s\n", name);
+                std::fclose(file);
+            }
+        }
+    }
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the function that records the first access to a payload in the access profile.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] name            The name of the payload, including any prefix.
+ */
+void dumpRecord(std::ostream& outputStream, unsigned leftIndentation, unsigned indentation, const std::string& name) {
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that records the first access to " + name + " in the access profile.  Called by the\n"
+              " * generated accessors; call it yourself before using " + name + " directly.\n"
+              " */\n"
+              "static inline bool " + name + "Record() {\n"
+              "    static std::atomic<bool> recorded(false);\n"
+              "    if (!recorded.load(std::memory_order_relaxed) && !recorded.exchange(true)) {\n"
+              "        BuildPayload::recordAccess(\"" + name + "\");\n"
+              "    }\n"
+              "\n"
+              "    return true;\n"
+              "}\n"
+              "\n"
+        ).c_str()
+    );
+}
+
+
+/**
+ * Function that dumps the macros used to place payload variables in their own sections.  Sections are only used for
+ * ELF targets.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpSectionRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_SECTION_RUNTIME
+#define BUILD_PAYLOAD_SECTION_RUNTIME
+
+#if (defined(__ELF__))
+    #define BUILD_PAYLOAD_SECTION(name)        __attribute__((section(name)))
+    #define BUILD_PAYLOAD_HIDDEN_SECTION(name) __attribute__((section(name), visibility("hidden")))
+#else
+    #define BUILD_PAYLOAD_SECTION(name)
+    #define BUILD_PAYLOAD_HIDDEN_SECTION(name)
+#endif
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the function used to issue madvise hints on the pages holding a payload.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpAdviceRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <cstdint>
+
+#if (defined(__unix__) || defined(__APPLE__))
+    #include <sys/mman.h>
+    #include <unistd.h>
+    #define BUILD_PAYLOAD_MADVISE
+#endif
+
+#ifndef BUILD_PAYLOAD_ADVICE_RUNTIME
+#define BUILD_PAYLOAD_ADVICE_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Enumeration of page hints.
+     */
+    enum class Advice {
+        /**
+         * Indicates the pages will be needed soon and should be read ahead.
+         */
+        WILL_NEED,
+
+        /**
+         * Indicates the pages are no longer needed and can be dropped from the resident set.  The pages are read
+         * back from the executable on the next access.
+         */
+        DONT_NEED,
+
+        /**
+         * Indicates the pages should be backed by huge pages where the system supports it.
+         */
+        HUGE_PAGE
+    };
+
+    /**
+     * Function that issues an madvise hint on the pages holding a block of read only data.  WILL_NEED and HUGE_PAGE
+     * cover every page the block touches.  DONT_NEED covers only pages lying entirely within the block so unrelated
+     * data is never dropped.
+     *
+     * \param[in] data   The data of interest.
+     *
+     * \param[in] size   The size of the data, in bytes.
+     *
+     * \param[in] advice The hint to issue.
+     *
+     * \return Returns true on success.  Returns false if the hint is not supported or the call failed.
+     */
+    inline bool advise(const void* data, unsigned long size, Advice advice) {
+        #if (defined(BUILD_PAYLOAD_MADVISE))
+
+            int flag = -1;
+            switch (advice) {
+                case Advice::WILL_NEED: { flag = MADV_WILLNEED;   break; }
+                case Advice::DONT_NEED: { flag = MADV_DONTNEED;   break; }
+                case Advice::HUGE_PAGE: {
+                    #if (defined(MADV_HUGEPAGE))
+                        flag = MADV_HUGEPAGE;
+                    #endif
+
+                    break;
+                }
+            }
+
+            std::uintptr_t pageSize = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+            std::uintptr_t begin    = reinterpret_cast<std::uintptr_t>(data);
+            std::uintptr_t end      = begin + size;
+            if (advice == Advice::DONT_NEED) {
+                begin = (begin + pageSize - 1) & ~(pageSize - 1);
+                end   = end & ~(pageSize - 1);
+            } else {
+                begin = begin & ~(pageSize - 1);
+                end   = (end + pageSize - 1) & ~(pageSize - 1);
+            }
+
+            return (
+                   flag != -1
+                && (end <= begin || madvise(reinterpret_cast<void*>(begin), end - begin, flag) == 0)
+            );
+
+        #else
+
+            (void) data;
+            (void) size;
+            (void) advice;
+
+            return false;
+
+        #endif
+    }
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the transform filters applied to a payload, both as the comma separated <name>Filters list and
+ * as the <name>FilterSteps array BuildPayload::unfilter walks.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] name            The name of the payload, including any prefix.
+ *
+ * \param[in] filters         The filters applied to the payload.
+ */
+void dumpFilterMetadata(
+        std::ostream&              outputStream,
+        unsigned                   leftIndentation,
+        unsigned                   indentation,
+        const std::string&         name,
+        const std::vector<Filter>& filters
+    ) {
+    std::string leftIndentationString(leftIndentation, ' ');
+    std::string stepIndentationString(leftIndentation + indentation, ' ');
+
+    outputStream << leftIndentationString << "static const char " << name << "Filters[] = \"" << toString(filters)
+                 << "\";" << std::endl
+                 << leftIndentationString << "static constexpr BuildPayload::FilterStep " << name << "FilterSteps[] = {"
+                 << std::endl;
+
+    for (std::size_t index=0 ; index<filters.size() ; ++index) {
+        const Filter& filter = filters[index];
+
+        std::string typeName;
+        switch (filter.type) {
+            case FilterType::SHUFFLE: { typeName = "SHUFFLE";   break; }
+            case FilterType::DELTA:   { typeName = "DELTA";     break; }
+            case FilterType::X86:     { typeName = "X86";       break; }
+            case FilterType::ARM:     { typeName = "ARM";       break; }
+            case FilterType::ARM64:   { typeName = "ARM64";     break; }
+        }
+
+        outputStream << stepIndentationString << "{ BuildPayload::FilterType::" << typeName << ", "
+                     << filter.parameter << "UL }" << (index + 1 < filters.size() ? "," : "") << std::endl;
+    }
+
+    outputStream << leftIndentationString << "};" << std::endl;
+}
+
+
+/**
+ * Function that dumps the function that issues madvise hints on the pages holding a payload.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] name            The name of the payload array, including any prefix.
+ */
+void dumpAdvise(std::ostream& outputStream, unsigned leftIndentation, unsigned indentation, const std::string& name) {
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that issues an madvise hint on the pages holding " + name + ", including its padding.\n"
+              " */\n"
+              "static inline bool " + name + "Advise(BuildPayload::Advice advice) {\n"
+              "    return BuildPayload::advise(" + name + ", sizeof(" + name + "), advice);\n"
+              "}\n"
+              "\n"
+        ).c_str()
+    );
+}
+
+
+/**
+ * Function that dumps the memory bounded cache of decompressed payloads, along with the chunk decoder for each of the
+ * codecs in use.  The LZ4 chunk decoder is provided by \ref dumpLz4Runtime.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ *
+ * \param[in] codecs       The codecs used to compress the payloads.
+ */
+void dumpCacheRuntime(std::ostream& outputStream, unsigned indentation, const std::vector<Codec>& codecs) {
+    dumpCode(outputStream, 0, indentation, R"(#include <condition_variable>
+#include <mutex>
+#include <utility>
+
+#ifndef BUILD_PAYLOAD_CACHE_RUNTIME
+#define BUILD_PAYLOAD_CACHE_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Structure tracking the decompressed copy of a single payload held by the payload cache.  The constructor is
+     * constexpr so instances with static storage duration are constant initialized.  All fields are guarded by the
+     * cache.
+     */
+    struct CacheEntry {
+        constexpr CacheEntry():data(nullptr),size(0),references(0),loading(false),previous(nullptr),next(nullptr) {}
+
+        /**
+         * The decompressed copy.  A null pointer indicates the payload is not resident.
+         */
+        unsigned char* data;
+
+        /**
+         * The size of the decompressed copy, in bytes.
+         */
+        unsigned long size;
+
+        /**
+         * The number of handles pinning the decompressed copy.
+         */
+        unsigned long references;
+
+        /**
+         * Flag indicating that a thread is decompressing the payload.
+         */
+        bool loading;
+
+        /**
+         * The more recently used resident entry.
+         */
+        CacheEntry* previous;
+
+        /**
+         * The less recently used resident entry.
+         */
+        CacheEntry* next;
+    };
+
+    /**
+     * Class holding a reference counted handle to a decompressed payload.  The payload can not be evicted while any
+     * handle to it exists.
+     */
+    class PayloadHandle {
+        friend class PayloadCache;
+
+        public:
+            PayloadHandle():currentEntry(nullptr) {}
+
+            PayloadHandle(const PayloadHandle& other);
+
+            PayloadHandle(PayloadHandle&& other):currentEntry(other.currentEntry) {
+                other.currentEntry = nullptr;
+            }
+
+            ~PayloadHandle();
+
+            PayloadHandle& operator=(PayloadHandle other) {
+                std::swap(currentEntry, other.currentEntry);
+                return *this;
+            }
+
+            /**
+             * Method you can use to obtain the decompressed payload.
+             *
+             * \return Returns a pointer to the first byte.  A null pointer is returned for an empty handle.
+             */
+            const unsigned char* data() const {
+                return currentEntry != nullptr ? currentEntry->data : nullptr;
+            }
+
+            /**
+             * Method you can use to obtain the size of the decompressed payload.
+             *
+             * \return Returns the size, in bytes.
+             */
+            unsigned long size() const {
+                return currentEntry != nullptr ? currentEntry->size : 0;
+            }
+
+            /**
+             * Method you can use to determine if the handle references a payload.
+             *
+             * \return Returns true if the handle references a payload.  Returns false if the payload was corrupt.
+             */
+            explicit operator bool() const {
+                return currentEntry != nullptr;
+            }
+
+        private:
+            explicit PayloadHandle(CacheEntry* entry):currentEntry(entry) {}
+
+            CacheEntry* currentEntry;
+    };
+
+    /**
+     * Class that holds decompressed payloads within a global memory budget.  When the budget is exceeded the least
+     * recently acquired payloads not pinned by a handle are released and are transparently decompressed again from the
+     * embedded data on their next use.  Pinned payloads may hold the cache above its budget.  The budget is unlimited
+     * until set.
+     */
+    class PayloadCache {
+        friend class PayloadHandle;
+
+        public:
+            /**
+             * Method that returns the cache shared by the whole program.  The cache is never destroyed so handles
+             * remain usable during static destruction.
+             *
+             * \return Returns the cache.
+             */
+            static PayloadCache& instance() {
+                static PayloadCache* cache = new PayloadCache;
+                return *cache;
+            }
+
+            /**
+             * Method you can use to change the memory budget.  Payloads are evicted immediately if needed.
+             *
+             * \param[in] newBudget The new budget, in bytes.
+             */
+            void setBudget(unsigned long long newBudget) {
+                std::lock_guard<std::mutex> lock(currentMutex);
+                currentBudget = newBudget;
+                evict();
+            }
+
+            /**
+             * Method you can use to obtain the memory budget.
+             *
+             * \return Returns the budget, in bytes.
+             */
+            unsigned long long budget() const {
+                std::lock_guard<std::mutex> lock(currentMutex);
+                return currentBudget;
+            }
+
+            /**
+             * Method you can use to obtain the memory held by decompressed payloads.
+             *
+             * \return Returns the resident size, in bytes.
+             */
+            unsigned long long resident() const {
+                std::lock_guard<std::mutex> lock(currentMutex);
+                return currentResident;
+            }
+
+            /**
+             * Method that returns a handle to a payload, decompressing the payload if it is not resident.  Threads
+             * acquiring a payload while it is being decompressed wait for the first thread to finish.
+             *
+             * \param[in] entry   The entry tracking the payload.
+             *
+             * \param[in] size    The uncompressed size of the payload, in bytes.
+             *
+             * \param[in] decoder A callable, bool decoder(unsigned char* destination), that decompresses the payload
+             *                    into a buffer of the uncompressed size.
+             *
+             * \return Returns a handle pinning the payload.  An empty handle is returned if the payload is corrupt.
+             */
+            template<typename Decoder> PayloadHandle acquire(CacheEntry& entry, unsigned long size, Decoder decoder) {
+                std::unique_lock<std::mutex> lock(currentMutex);
+                while (entry.loading) {
+                    currentLoaded.wait(lock);
+                }
+
+                if (entry.data == nullptr) {
+                    entry.loading = true;
+                    lock.unlock();
+
+                    unsigned char* buffer  = new unsigned char[size > 0 ? size : 1];
+                    bool           success = decoder(buffer);
+
+                    lock.lock();
+                    entry.loading = false;
+                    currentLoaded.notify_all();
+
+                    if (!success) {
+                        delete[] buffer;
+                        return PayloadHandle();
+                    }
+
+                    entry.data       = buffer;
+                    entry.size       = size;
+                    currentResident += size;
+                } else {
+                    unlink(entry);
+                }
+
+                link(entry);
+                ++entry.references;
+                evict();
+
+                return PayloadHandle(&entry);
+            }
+
+        private:
+            PayloadCache():currentBudget(~0ULL),currentResident(0),currentHead(nullptr),currentTail(nullptr) {}
+
+            void retain(CacheEntry& entry) {
+                std::lock_guard<std::mutex> lock(currentMutex);
+                ++entry.references;
+            }
+
+            void release(CacheEntry& entry) {
+                std::lock_guard<std::mutex> lock(currentMutex);
+                --entry.references;
+                if (entry.references == 0) {
+                    evict();
+                }
+            }
+
+            // Releases unpinned payloads, least recently used first, until the cache is within budget.
+            void evict() {
+                CacheEntry* entry = currentTail;
+                while (currentResident > currentBudget && entry != nullptr) {
+                    CacheEntry* previous = entry->previous;
+                    if (entry->references == 0) {
+                        unlink(*entry);
+                        currentResident -= entry->size;
+
+                        delete[] entry->data;
+                        entry->data = nullptr;
+                        entry->size = 0;
+                    }
+
+                    entry = previous;
+                }
+            }
+
+            void link(CacheEntry& entry) {
+                entry.previous = nullptr;
+                entry.next     = currentHead;
+                if (currentHead != nullptr) {
+                    currentHead->previous = &entry;
+                } else {
+                    currentTail = &entry;
+                }
+
+                currentHead = &entry;
+            }
+
+            void unlink(CacheEntry& entry) {
+                if (entry.previous != nullptr) {
+                    entry.previous->next = entry.next;
+                } else {
+                    currentHead = entry.next;
+                }
+
+                if (entry.next != nullptr) {
+                    entry.next->previous = entry.previous;
+                } else {
+                    currentTail = entry.previous;
+                }
+
+                entry.previous = nullptr;
+                entry.next     = nullptr;
+            }
+
+            mutable std::mutex      currentMutex;
+            std::condition_variable currentLoaded;
+            unsigned long long      currentBudget;
+            unsigned long long      currentResident;
+            CacheEntry*             currentHead;
+            CacheEntry*             currentTail;
+    };
+
+    inline PayloadHandle::PayloadHandle(const PayloadHandle& other):currentEntry(other.currentEntry) {
+        if (currentEntry != nullptr) {
+            PayloadCache::instance().retain(*currentEntry);
+        }
+    }
+
+    inline PayloadHandle::~PayloadHandle() {
+        if (currentEntry != nullptr) {
+            PayloadCache::instance().release(*currentEntry);
+        }
+    }
+}
+
+#endif
+
+)");
+
+    for (Codec codec : codecs) {
+        dumpChunkDecoder(outputStream, indentation, codec);
+    }
+}
+
+
+/**
+ * Function that dumps the function that acquires a payload through the payload cache.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] name            The name of the payload, including any prefix.
+ *
+ * \param[in] decodeSteps     The expressions, evaluated in order, that decompress the payload into a buffer named
+ *                            destination.  Each expression must evaluate to true on success.
+ */
+void dumpCacheAccessor(
+        std::ostream&                   outputStream,
+        unsigned                        leftIndentation,
+        unsigned                        indentation,
+        const std::string&              name,
+        const std::vector<std::string>& decodeSteps
+    ) {
+    std::string decodeStatement = toReturnStatement(decodeSteps, 12);
+
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that returns a handle to the decompressed contents of " + name + ", decompressing\n"
+              " * them again if they were evicted from the payload cache.  The contents stay resident while the\n"
+              " * handle, or a copy, exists.  Returns an empty handle if the payload is corrupt.\n"
+              " */\n"
+              "static inline BuildPayload::PayloadHandle " + name + "Acquire() {\n"
+              "    static BuildPayload::CacheEntry entry;\n"
+              "    return BuildPayload::PayloadCache::instance().acquire(\n"
+              "        entry,\n"
+              "        " + name + "UncompressedSize,\n"
+              "        [](unsigned char* destination) {\n"
+            + decodeStatement +
+              "        }\n"
+              "    );\n"
+              "}\n"
+              "\n"
+        ).c_str()
+    );
+}
+
+
+/**
+ * Function that dumps the classes used to decompress the payloads in a registry on background threads.
+ *
+ * \param[in] outputStream The stream to receive the generated output.
+ *
+ * \param[in] indentation  The desired indentation in spaces.
+ */
+void dumpPrefetchRuntime(std::ostream& outputStream, unsigned indentation) {
+    dumpCode(outputStream, 0, indentation, R"(#include <atomic>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#ifndef BUILD_PAYLOAD_PREFETCH_RUNTIME
+#define BUILD_PAYLOAD_PREFETCH_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Structure describing a single payload in a registry.
+     */
+    struct RegistryEntry {
+        /**
+         * The payload name, the input filename less any directory.
+         */
+        const char* name;
+
+        /**
+         * The payload accessor.
+         */
+        Span (*get)();
+
+        /**
+         * Function returning the payload state.
+         */
+        LazyPayload::State (*state)();
+    };
+
+    /**
+     * Class that decompresses the payloads in a registry on background threads.  Payloads named in the priority list
+     * are decompressed first, in list order, followed by the remaining payloads in registry order.  Accessors called
+     * while prefetching block only if their payload is still pending.  The destructor abandons payloads not yet
+     * started and waits for the threads so keep the instance alive for as long as prefetching should continue.
+     */
+    class Prefetch {
+        public:
+            /**
+             * Constructor.  Starts the background threads.
+             *
+             * \param[in] entries       The registry entries.
+             *
+             * \param[in] numberEntries The number of registry entries.
+             *
+             * \param[in] priority      The names of the payloads to decompress first, in order.  Unknown names are
+             *                          ignored.
+             *
+             * \param[in] numberThreads The number of background threads.  A value of 0 selects one thread per core.
+             */
+            Prefetch(
+                    const RegistryEntry*               entries,
+                    unsigned long                      numberEntries,
+                    std::initializer_list<const char*> priority,
+                    unsigned                           numberThreads
+                ):currentQueue(
+                    new Queue
+                ) {
+                std::vector<bool> queued(numberEntries, false);
+                for (const char* name : priority) {
+                    for (unsigned long i=0 ; i<numberEntries ; ++i) {
+                        if (!queued[i] && std::strcmp(entries[i].name, name) == 0) {
+                            currentQueue->order.push_back(entries + i);
+                            queued[i] = true;
+                            break;
+                        }
+                    }
+                }
+
+                for (unsigned long i=0 ; i<numberEntries ; ++i) {
+                    if (!queued[i]) {
+                        currentQueue->order.push_back(entries + i);
+                    }
+                }
+
+                if (numberThreads == 0) {
+                    numberThreads = std::thread::hardware_concurrency();
+                    if (numberThreads == 0) {
+                        numberThreads = 1;
+                    }
+                }
+
+                if (numberThreads > currentQueue->order.size()) {
+                    numberThreads = static_cast<unsigned>(currentQueue->order.size());
+                }
+
+                Queue* queue = currentQueue.get();
+                for (unsigned i=0 ; i<numberThreads ; ++i) {
+                    currentThreads.emplace_back([queue]() { queue->run(); });
+                }
+            }
+
+            Prefetch(Prefetch&& other) = default;
+
+            ~Prefetch() {
+                cancel();
+                wait();
+            }
+
+            /**
+             * Method you can use to abandon payloads that have not yet been started.  Abandoned payloads are
+             * decompressed on first access.
+             */
+            void cancel() {
+                if (currentQueue) {
+                    currentQueue->cancelled.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            /**
+             * Method that blocks until the background threads finish.
+             */
+            void wait() {
+                for (std::thread& thread : currentThreads) {
+                    if (thread.joinable()) {
+                        thread.join();
+                    }
+                }
+            }
+
+            /**
+             * Method you can use to determine if every payload has been prefetched.
+             *
+             * \return Returns true if every payload has been decompressed.  Returns false if payloads remain.
+             */
+            bool finished() const {
+                return (
+                       !currentQueue
+                    || currentQueue->completed.load(std::memory_order_acquire) == currentQueue->order.size()
+                );
+            }
+
+        private:
+            /**
+             * The shared work queue.  Held by pointer so the threads are unaffected if the instance is moved.
+             */
+            struct Queue {
+                Queue():next(0),completed(0),cancelled(false) {}
+
+                void run() {
+                    unsigned long index = next.fetch_add(1, std::memory_order_relaxed);
+                    while (index < order.size() && !cancelled.load(std::memory_order_relaxed)) {
+                        order[index]->get();
+                        completed.fetch_add(1, std::memory_order_release);
+                        index = next.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+
+                std::vector<const RegistryEntry*> order;
+                std::atomic<unsigned long>        next;
+                std::atomic<unsigned long>        completed;
+                std::atomic<bool>                 cancelled;
+            };
+
+            std::unique_ptr<Queue>   currentQueue;
+            std::vector<std::thread> currentThreads;
+    };
+}
+
+#endif
+
+)");
+}
+
+
+/**
+ * Function that dumps the classes used to decompress payloads incrementally through a std::streambuf or, when Qt is
+ * available, a QIODevice, along with the chunk decoder for each of the codecs in use.  The LZ4 chunk decoder is
+ * provided by \ref dumpLz4Runtime.
+ *
+ * \param[in] outputStream   The stream to receive the generated output.
+ *
+ * \param[in] indentation    The desired indentation in spaces.
+ *
+ * \param[in] codecs         The codecs used to compress the payloads.
+ *
+ * \param[in] outputSettings Settings controlling how the payloads are laid out.
+ */
+void dumpStreamRuntime(
+        std::ostream&             outputStream,
+        unsigned                  indentation,
+        const std::vector<Codec>& codecs,
+        const OutputSettings&     outputSettings
+    ) {
+    for (Codec codec : codecs) {
+        dumpChunkDecoder(outputStream, indentation, codec);
+    }
+
+    dumpCode(outputStream, 0, indentation, R"(#include <cstring>
+#include <memory>
+#include <streambuf>
+#include <vector>
+
+#if (defined(__has_include))
+    #if (__has_include(<QIODevice>))
+        #include <QIODevice>
+        #define BUILD_PAYLOAD_QIODEVICE
+    #endif
+#endif
+
+#ifndef BUILD_PAYLOAD_STREAM_RUNTIME
+#define BUILD_PAYLOAD_STREAM_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Pure virtual base class for classes that decompress a payload incrementally.
+     */
+    class StreamDecoder {
+        public:
+            virtual ~StreamDecoder() {}
+
+            /**
+             * Method that decompresses the next block of the payload.
+             *
+             * \param[in] buffer The buffer to receive the data.
+             *
+             * \param[in] size   The size of the buffer, in bytes.
+             *
+             * \return Returns the number of bytes placed in the buffer.  A value of 0 indicates the end of the payload
+             *         or that the payload is corrupt.
+             */
+            unsigned long read(unsigned char* buffer, unsigned long size) {
+                unsigned long count = 0;
+                if (!currentFailed && size > 0) {
+                    count = decode(buffer, size);
+                    if (count > currentUncompressedSize - currentProduced || (count == 0 && remaining() > 0)) {
+                        currentFailed = true;
+                        count         = 0;
+                    } else {
+                        currentProduced += count;
+                    }
+                }
+
+                return count;
+            }
+
+            /**
+             * Method you can use to obtain the number of bytes not yet read.
+             *
+             * \return Returns the number of bytes remaining.
+             */
+            unsigned long remaining() const {
+                return currentFailed ? 0 : currentUncompressedSize - currentProduced;
+            }
+
+            /**
+             * Method you can use to determine if the payload was found to be corrupt.
+             *
+             * \return Returns true if the payload is corrupt.  Returns false if no error was found.
+             */
+            bool failed() const {
+                return currentFailed;
+            }
+
+        protected:
+            /**
+             * Constructor.
+             *
+             * \param[in] uncompressedSize The uncompressed size of the payload, in bytes.
+             */
+            explicit StreamDecoder(
+                    unsigned long uncompressedSize
+                ):currentFailed(
+                    false
+                ),currentUncompressedSize(
+                    uncompressedSize
+                ),currentProduced(
+                    0
+                ) {}
+
+            /**
+             * Method that decompresses the next block of the payload.
+             *
+             * \param[in] buffer The buffer to receive the data.
+             *
+             * \param[in] size   The size of the buffer, in bytes.  Always greater than 0.
+             *
+             * \return Returns the number of bytes placed in the buffer.  A value of 0 indicates the end of the payload.
+             *         Set currentFailed on error.
+             */
+            virtual unsigned long decode(unsigned char* buffer, unsigned long size) = 0;
+
+            bool currentFailed;
+
+        private:
+            unsigned long currentUncompressedSize;
+            unsigned long currentProduced;
+    };
+
+    /**
+     * Class that reads a stored, uncompressed, payload.
+     */
+    class StoredStreamDecoder:public StreamDecoder {
+        public:
+            StoredStreamDecoder(
+                    const unsigned char* data,
+                    unsigned long        dataSize,
+                    unsigned long        uncompressedSize
+                ):StreamDecoder(
+                    uncompressedSize
+                ),currentData(
+                    data
+                ),currentRemaining(
+                    dataSize
+                ) {}
+
+        protected:
+            unsigned long decode(unsigned char* buffer, unsigned long size) override {
+                unsigned long count = size < currentRemaining ? size : currentRemaining;
+                std::memcpy(buffer, currentData, count);
+                currentData      += count;
+                currentRemaining -= count;
+
+                return count;
+            }
+
+        private:
+            const unsigned char* currentData;
+            unsigned long        currentRemaining;
+    };
+
+    /**
+     * Base class for decoders that produce a payload in whole blocks, such as chunks.
+     */
+    class BlockStreamDecoder:public StreamDecoder {
+        protected:
+            explicit BlockStreamDecoder(
+                    unsigned long uncompressedSize
+                ):StreamDecoder(
+                    uncompressedSize
+                ),currentPosition(
+                    0
+                ) {}
+
+            /**
+             * Method that decompresses the next block.
+             *
+             * \param[in,out] block The buffer to receive the block.  The buffer still holds the previous block.
+             *
+             * \return Returns true if a block was decompressed.  Returns false at the end of the payload or on error.
+             */
+            virtual bool nextBlock(std::vector<unsigned char>& block) = 0;
+
+            unsigned long decode(unsigned char* buffer, unsigned long size) override {
+                unsigned long count = 0;
+                while (count < size && !currentFailed) {
+                    if (currentPosition == currentBlock.size()) {
+                        currentPosition = 0;
+                        if (!nextBlock(currentBlock)) {
+                            currentBlock.clear();
+                            break;
+                        }
+                    }
+
+                    unsigned long available = static_cast<unsigned long>(currentBlock.size() - currentPosition);
+                    unsigned long copied    = size - count < available ? size - count : available;
+                    std::memcpy(buffer + count, currentBlock.data() + currentPosition, copied);
+                    currentPosition += copied;
+                    count           += copied;
+                }
+
+                return count;
+            }
+
+        private:
+            std::vector<unsigned char> currentBlock;
+            std::size_t                currentPosition;
+    };
+
+    /**
+     * Base class for decoders that decompress into a window so matches can reference earlier output.  The window holds
+     * the history followed by up to 64K of new output and slides once full.
+     */
+    class WindowStreamDecoder:public StreamDecoder {
+        protected:
+            /**
+             * Constructor.
+             *
+             * \param[in] uncompressedSize The uncompressed size of the payload, in bytes.
+             *
+             * \param[in] historySize      The number of bytes of earlier output that matches may reference.
+             */
+            WindowStreamDecoder(
+                    unsigned long uncompressedSize,
+                    unsigned long historySize
+                ):StreamDecoder(
+                    uncompressedSize
+                ),currentHistorySize(
+                    historySize
+                ),currentWindow(
+                    historySize + 65536
+                ),currentPosition(
+                    0
+                ),currentRead(
+                    0
+                ) {}
+
+            /**
+             * Method that places data in front of the payload so matches can reference it.  Only the tail that fits in
+             * the history is kept.  Call before the first read.
+             *
+             * \param[in] data The data, such as a preset dictionary.
+             *
+             * \param[in] size The size of the data, in bytes.
+             */
+            void preload(const unsigned char* data, unsigned long size) {
+                unsigned long count = size < currentHistorySize ? size : currentHistorySize;
+                std::memcpy(currentWindow.data(), data + size - count, count);
+                currentPosition = count;
+                currentRead     = count;
+            }
+
+            /**
+             * Method that decompresses into the window until the window fills or the payload ends.
+             *
+             * \param[in]     window   The window.  Bytes in front of the position hold earlier output.
+             *
+             * \param[in,out] position The position of the next byte of output.  Updated to the position just past
+             *                         the last byte of output.
+             *
+             * \param[in]     limit    The size of the window, in bytes.
+             *
+             * \return Returns true on success.  Returns false if the payload is corrupt.
+             */
+            virtual bool fill(unsigned char* window, unsigned long& position, unsigned long limit) = 0;
+
+            unsigned long decode(unsigned char* buffer, unsigned long size) override {
+                unsigned long count = 0;
+                unsigned long limit = static_cast<unsigned long>(currentWindow.size());
+                bool          ended = false;
+
+                while (count < size && count < remaining() && !ended && !currentFailed) {
+                    if (currentRead == currentPosition) {
+                        if (currentPosition == limit) {
+                            std::memmove(
+                                currentWindow.data(),
+                                currentWindow.data() + limit - currentHistorySize,
+                                currentHistorySize
+                            );
+
+                            currentPosition = currentHistorySize;
+                            currentRead     = currentHistorySize;
+                        }
+
+                        unsigned long start = currentPosition;
+                        currentFailed = !fill(currentWindow.data(), currentPosition, limit);
+                        ended         = (currentPosition == start);
+                    } else {
+                        unsigned long available = currentPosition - currentRead;
+                        unsigned long copied    = size - count < available ? size - count : available;
+                        std::memcpy(buffer + count, currentWindow.data() + currentRead, copied);
+                        currentRead += copied;
+                        count       += copied;
+                    }
+                }
+
+                return count;
+            }
+
+        private:
+            unsigned long              currentHistorySize;
+            std::vector<unsigned char> currentWindow;
+            unsigned long              currentPosition;
+            unsigned long              currentRead;
+    };
+
+    /**
+     * Class that adapts a stream decoder to a std::streambuf so a payload can be read through a std::istream.  Reads
+     * larger than the buffer bypass it.
+     */
+    class PayloadStreamBuffer:public std::streambuf {
+        public:
+            /**
+             * Constructor.
+             *
+             * \param[in] decoder    The decoder supplying the payload.
+             *
+             * \param[in] bufferSize The size of the read buffer, in bytes.
+             */
+            explicit PayloadStreamBuffer(
+                    std::unique_ptr<StreamDecoder> decoder,
+                    unsigned long                  bufferSize = 65536
+                ):currentDecoder(
+                    std::move(decoder)
+                ),currentBuffer(
+                    bufferSize > 0 ? bufferSize : 1
+                ) {}
+
+            /**
+             * Method you can use to determine if the payload was found to be corrupt.
+             *
+             * \return Returns true if the payload is corrupt.  Returns false if no error was found.
+             */
+            bool failed() const {
+                return currentDecoder->failed();
+            }
+
+        protected:
+            int_type underflow() override {
+                if (gptr() == egptr()) {
+                    char*         buffer = currentBuffer.data();
+                    unsigned long count  = currentDecoder->read(
+                        reinterpret_cast<unsigned char*>(buffer),
+                        static_cast<unsigned long>(currentBuffer.size())
+                    );
+
+                    setg(buffer, buffer, buffer + count);
+                }
+
+                return gptr() == egptr() ? traits_type::eof() : traits_type::to_int_type(*gptr());
+            }
+
+            std::streamsize xsgetn(char* destination, std::streamsize count) override {
+                std::streamsize copied = 0;
+                while (copied < count) {
+                    std::streamsize available = egptr() - gptr();
+                    if (available > 0) {
+                        std::streamsize length = count - copied < available ? count - copied : available;
+                        std::memcpy(destination + copied, gptr(), static_cast<std::size_t>(length));
+                        gbump(static_cast<int>(length));
+                        copied += length;
+                    } else if (static_cast<std::size_t>(count - copied) >= currentBuffer.size()) {
+                        unsigned long length = currentDecoder->read(
+                            reinterpret_cast<unsigned char*>(destination + copied),
+                            static_cast<unsigned long>(count - copied)
+                        );
+
+                        if (length == 0) {
+                            break;
+                        }
+
+                        copied += static_cast<std::streamsize>(length);
+                    } else if (traits_type::eq_int_type(underflow(), traits_type::eof())) {
+                        break;
+                    }
+                }
+
+                return copied;
+            }
+
+            std::streamsize showmanyc() override {
+                return currentDecoder->failed() ? -1 : static_cast<std::streamsize>(currentDecoder->remaining());
+            }
+
+        private:
+            std::unique_ptr<StreamDecoder> currentDecoder;
+            std::vector<char>              currentBuffer;
+    };
+
+    #if (defined(BUILD_PAYLOAD_QIODEVICE))
+
+        /**
+         * Class that adapts a stream decoder to a read only, sequential, QIODevice.  The device is opened by the
+         * constructor.
+         */
+        class PayloadDevice:public QIODevice {
+            public:
+                /**
+                 * Constructor.
+                 *
+                 * \param[in] decoder The decoder supplying the payload.
+                 *
+                 * \param[in] parent  The parent object.
+                 */
+                explicit PayloadDevice(
+                        std::unique_ptr<StreamDecoder> decoder,
+                        QObject*                       parent = nullptr
+                    ):QIODevice(
+                        parent
+                    ),currentDecoder(
+                        std::move(decoder)
+                    ) {
+                    QIODevice::open(QIODevice::ReadOnly);
+                }
+
+                bool isSequential() const override {
+                    return true;
+                }
+
+                qint64 bytesAvailable() const override {
+                    return static_cast<qint64>(currentDecoder->remaining()) + QIODevice::bytesAvailable();
+                }
+
+                /**
+                 * Method you can use to determine if the payload was found to be corrupt.
+                 *
+                 * \return Returns true if the payload is corrupt.  Returns false if no error was found.
+                 */
+                bool failed() const {
+                    return currentDecoder->failed();
+                }
+
+            protected:
+                qint64 readData(char* data, qint64 maximumSize) override {
+                    unsigned long count = currentDecoder->read(
+                        reinterpret_cast<unsigned char*>(data),
+                        static_cast<unsigned long>(maximumSize)
+                    );
+
+                    return currentDecoder->failed() ? -1 : static_cast<qint64>(count);
+                }
+
+                qint64 writeData(const char*, qint64) override {
+                    return -1;
+                }
+
+            private:
+                std::unique_ptr<StreamDecoder> currentDecoder;
+        };
+
+    #endif
+
+    /**
+     * Function that opens a payload for streaming decompression.
+     *
+     * \param[in] data             The compressed payload.
+     *
+     * \param[in] dataSize         The size of the compressed payload, in bytes.
+     *
+     * \param[in] uncompressedSize The uncompressed size of the payload, in bytes.
+     *
+     * \return Returns the stream decoder.
+     */
+    template<typename Decoder> inline std::unique_ptr<StreamDecoder> openStream(
+            const unsigned char* data,
+            unsigned long        dataSize,
+            unsigned long        uncompressedSize
+        ) {
+        return std::unique_ptr<StreamDecoder>(new Decoder(data, dataSize, uncompressedSize));
+    }
+
+    /**
+     * Function that opens a payload compressed against a preset dictionary for streaming decompression.
+     *
+     * \param[in] data             The compressed payload.
+     *
+     * \param[in] dataSize         The size of the compressed payload, in bytes.
+     *
+     * \param[in] uncompressedSize The uncompressed size of the payload, in bytes.
+     *
+     * \param[in] dictionary       The shared dictionary.  Must outlive the stream decoder.
+     *
+     * \param[in] dictionarySize   The size of the shared dictionary, in bytes.
+     *
+     * \return Returns the stream decoder.
+     */
+    template<typename Decoder> inline std::unique_ptr<StreamDecoder> openStream(
+            const unsigned char* data,
+            unsigned long        dataSize,
+            unsigned long        uncompressedSize,
+            const unsigned char* dictionary,
+            unsigned long        dictionarySize
+        ) {
+        return std::unique_ptr<StreamDecoder>(
+            new Decoder(data, dataSize, uncompressedSize, dictionary, dictionarySize)
+        );
+    }
+}
+
+#endif
+
+)");
+
+    for (Codec codec : codecs) {
+        switch (codec) {
+            case Codec::NONE: {
+                break;
+            }
+
+            case Codec::LZ4: {
+                dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_LZ4_STREAM_RUNTIME
+#define BUILD_PAYLOAD_LZ4_STREAM_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Class that incrementally decompresses a payload holding a raw LZ4 block, keeping the 64K of history LZ4 matches
+     * may reference.
+     */
+    class Lz4StreamDecoder:public WindowStreamDecoder {
+        public:
+            Lz4StreamDecoder(
+                    const unsigned char* data,
+                    unsigned long        dataSize,
+                    unsigned long        uncompressedSize
+                ):WindowStreamDecoder(
+                    uncompressedSize,
+                    65536
+                ),currentNext(
+                    data
+                ),currentEnd(
+                    data + dataSize
+                ),currentToken(
+                    0
+                ),currentLiterals(
+                    0
+                ),currentMatch(
+                    0
+                ),currentOffset(
+                    0
+                ),currentMatchPending(
+                    false
+                ) {}
+
+        protected:
+            bool fill(unsigned char* window, unsigned long& position, unsigned long limit) override {
+                bool success = true;
+                bool ended   = false;
+
+                while (success && !ended && position < limit) {
+                    if (currentLiterals > 0) {
+                        unsigned long count = currentLiterals < limit - position ? currentLiterals : limit - position;
+                        std::memcpy(window + position, currentNext, count);
+                        currentNext     += count;
+                        position        += count;
+                        currentLiterals -= count;
+                    } else if (currentMatch > 0) {
+                        unsigned long        count = currentMatch < limit - position ? currentMatch : limit - position;
+                        const unsigned char* match = window + position - currentOffset;
+                        if (currentOffset >= count) {
+                            std::memcpy(window + position, match, count);
+                            position += count;
+                        } else {
+                            unsigned char* matchEnd = window + position + count;
+                            unsigned char* out      = window + position;
+                            while (out < matchEnd) {
+                                *out++ = *match++;
+                            }
+
+                            position += count;
+                        }
+
+                        currentMatch -= count;
+                    } else if (currentNext == currentEnd) {
+                        // The last sequence of a block holds only literals.
+                        ended = true;
+                    } else if (currentMatchPending) {
+                        currentMatchPending = false;
+                        if (currentEnd - currentNext < 2) {
+                            success = false;
+                        } else {
+                            currentOffset = currentNext[0] | (static_cast<unsigned long>(currentNext[1]) << 8);
+                            currentNext  += 2;
+
+                            success = (
+                                   currentOffset != 0
+                                && currentOffset <= position
+                                && readLength(currentToken & 15, currentMatch)
+                            );
+
+                            currentMatch += 4;
+                        }
+                    } else {
+                        currentToken        = *currentNext++;
+                        currentMatchPending = true;
+                        success             = (
+                               readLength(currentToken >> 4, currentLiterals)
+                            && currentLiterals <= static_cast<unsigned long>(currentEnd - currentNext)
+                        );
+                    }
+                }
+
+                return success;
+            }
+
+        private:
+            /**
+             * Method that reads a literal or match length, including any extension bytes.
+             *
+             * \param[in]  nibble The length held in the token.
+             *
+             * \param[out] length The length.
+             *
+             * \return Returns true on success.  Returns false if the payload is truncated.
+             */
+            bool readLength(unsigned nibble, unsigned long& length) {
+                bool success = true;
+
+                length = nibble;
+                if (nibble == 15) {
+                    unsigned char extension;
+                    do {
+                        if (currentNext == currentEnd) {
+                            success   = false;
+                            extension = 0;
+                        } else {
+                            extension  = *currentNext++;
+                            length    += extension;
+                        }
+                    } while (extension == 255);
+                }
+
+                return success;
+            }
+
+            const unsigned char* currentNext;
+            const unsigned char* currentEnd;
+            unsigned             currentToken;
+            unsigned long        currentLiterals;
+            unsigned long        currentMatch;
+            unsigned long        currentOffset;
+            bool                 currentMatchPending;
+    };
+}
+
+#endif
+
+)");
+                break;
+            }
+
+            case Codec::QT_ZLIB: {
+                dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_QT_STREAM_RUNTIME
+#define BUILD_PAYLOAD_QT_STREAM_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Class that incrementally decompresses a payload generated by qCompress, keeping the 32K of history deflate
+     * matches may reference.
+     */
+    class QtStreamDecoder:public WindowStreamDecoder {
+        public:
+            /**
+             * Constructor.
+             *
+             * \param[in] data             The compressed payload, including the 4 byte size header.
+             *
+             * \param[in] dataSize         The size of the compressed payload, in bytes.
+             *
+             * \param[in] uncompressedSize The uncompressed size of the payload, in bytes.
+             *
+             * \param[in] dictionary       The preset dictionary the payload was compressed against.  A null pointer
+             *                             indicates none.
+             *
+             * \param[in] dictionarySize   The size of the preset dictionary, in bytes.
+             */
+            QtStreamDecoder(
+                    const unsigned char* data,
+                    unsigned long        dataSize,
+                    unsigned long        uncompressedSize,
+                    const unsigned char* dictionary = nullptr,
+                    unsigned long        dictionarySize = 0
+                ):WindowStreamDecoder(
+                    uncompressedSize,
+                    32768
+                ),currentInflater(
+                    data,
+                    dataSize
+                ) {
+                // qCompress stores an empty payload as a bare size header.
+                currentFailed = (
+                       dataSize < 4
+                    || (uncompressedSize > 0 && currentInflater.recordedSize() != (uncompressedSize & 0xFFFFFFFFUL))
+                );
+
+                if (dictionary != nullptr) {
+                    preload(dictionary, dictionarySize);
+                }
+            }
+
+        protected:
+            bool fill(unsigned char* window, unsigned long& position, unsigned long limit) override {
+                return currentInflater.run(window, position, limit) != Inflater::Status::CORRUPT;
+            }
+
+        private:
+            Inflater currentInflater;
+    };
+}
+
+#endif
+
+)");
+                break;
+            }
+
+            case Codec::ZSTD: {
+                dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_ZSTD_STREAM_RUNTIME
+#define BUILD_PAYLOAD_ZSTD_STREAM_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Class that incrementally decompresses a payload holding Zstandard frames.
+     */
+    class ZstdStreamDecoder:public StreamDecoder {
+        public:
+            /**
+             * Constructor.
+             *
+             * \param[in] data             The compressed payload.
+             *
+             * \param[in] dataSize         The size of the compressed payload, in bytes.
+             *
+             * \param[in] uncompressedSize The uncompressed size of the payload, in bytes.
+             *
+             * \param[in] dictionary       The dictionary the payload was compressed against.  The decoder keeps a
+             *                             copy.  A null pointer indicates none.
+             *
+             * \param[in] dictionarySize   The size of the dictionary, in bytes.
+             */
+            ZstdStreamDecoder(
+                    const unsigned char* data,
+                    unsigned long        dataSize,
+                    unsigned long        uncompressedSize,
+                    const unsigned char* dictionary = nullptr,
+                    unsigned long        dictionarySize = 0
+                ):StreamDecoder(
+                    uncompressedSize
+                ),currentStream(
+                    ZSTD_createDStream()
+                ) {
+                currentInput.src  = data;
+                currentInput.size = dataSize;
+                currentInput.pos  = 0;
+                currentFailed     = (
+                       currentStream == nullptr
+                    || (   dictionary != nullptr
+                        && ZSTD_isError(ZSTD_DCtx_loadDictionary(currentStream, dictionary, dictionarySize))
+                       )
+                );
+            }
+
+            ~ZstdStreamDecoder() override {
+                ZSTD_freeDStream(currentStream);
+            }
+
+        protected:
+            unsigned long decode(unsigned char* buffer, unsigned long size) override {
+                ZSTD_outBuffer output = { buffer, size, 0 };
+                bool           done   = false;
+
+                while (!done && !currentFailed && output.pos < output.size) {
+                    std::size_t inputPosition  = currentInput.pos;
+                    std::size_t outputPosition = output.pos;
+                    std::size_t result         = ZSTD_decompressStream(currentStream, &output, &currentInput);
+
+                    if (ZSTD_isError(result)) {
+                        currentFailed = true;
+                    } else {
+                        done = (
+                               (result == 0 && currentInput.pos == currentInput.size)
+                            || (currentInput.pos == inputPosition && output.pos == outputPosition)
+                        );
+                    }
+                }
+
+                return static_cast<unsigned long>(output.pos);
+            }
+
+        private:
+            ZSTD_DStream*  currentStream;
+            ZSTD_inBuffer  currentInput;
+    };
+}
+
+#endif
+
+)");
+                break;
+            }
+
+            case Codec::XZ: {
+                dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_XZ_STREAM_RUNTIME
+#define BUILD_PAYLOAD_XZ_STREAM_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Class that incrementally decompresses a payload holding a .xz stream.
+     */
+    class XzStreamDecoder:public StreamDecoder {
+        public:
+            XzStreamDecoder(
+                    const unsigned char* data,
+                    unsigned long        dataSize,
+                    unsigned long        uncompressedSize
+                ):StreamDecoder(
+                    uncompressedSize
+                ),currentFinished(
+                    false
+                ) {
+                lzma_stream initialStream = LZMA_STREAM_INIT;
+                currentStream = initialStream;
+                currentFailed = (lzma_stream_decoder(&currentStream, UINT64_MAX, 0) != LZMA_OK);
+
+                currentStream.next_in  = data;
+                currentStream.avail_in = dataSize;
+            }
+
+            ~XzStreamDecoder() override {
+                lzma_end(&currentStream);
+            }
+
+        protected:
+            unsigned long decode(unsigned char* buffer, unsigned long size) override {
+                currentStream.next_out  = buffer;
+                currentStream.avail_out = size;
+
+                while (!currentFinished && !currentFailed && currentStream.avail_out > 0) {
+                    lzma_ret result = lzma_code(&currentStream, LZMA_FINISH);
+                    if (result == LZMA_STREAM_END) {
+                        currentFinished = true;
+                    } else if (result != LZMA_OK) {
+                        currentFailed = true;
+                    }
+                }
+
+                return static_cast<unsigned long>(size - currentStream.avail_out);
+            }
+
+        private:
+            lzma_stream currentStream;
+            bool        currentFinished;
+    };
+}
+
+#endif
+
+)");
+                break;
+            }
+        }
+    }
+
+    if (outputSettings.chunkSize > 0) {
+        dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_CHUNKED_STREAM_RUNTIME
+#define BUILD_PAYLOAD_CHUNKED_STREAM_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Class that streams a chunked payload one chunk at a time.
+     */
+    template<typename Decoder> class ChunkedStreamDecoder:public BlockStreamDecoder {
+        public:
+            ChunkedStreamDecoder(
+                    const ChunkedPayload& payload,
+                    Decoder               decoder
+                ):BlockStreamDecoder(
+                    payload.uncompressedSize
+                ),currentPayload(
+                    payload
+                ),currentDecoder(
+                    decoder
+                ),nextChunk(
+                    0
+                ) {}
+
+        protected:
+            bool nextBlock(std::vector<unsigned char>& block) override {
+                bool result = false;
+                if (nextChunk < currentPayload.numberChunks) {
+                    unsigned long sourceStart = currentPayload.chunkOffsets[nextChunk];
+                    unsigned long sourceEnd   = currentPayload.chunkOffsets[nextChunk + 1];
+
+                    block.resize(chunkLength(currentPayload, nextChunk));
+                    result = currentDecoder(
+                        currentPayload.data + sourceStart,
+                        sourceEnd - sourceStart,
+                        block.data(),
+                        static_cast<unsigned long>(block.size())
+                    );
+
+                    currentFailed = !result;
+                    ++nextChunk;
+                }
+
+                return result;
+            }
+
+        private:
+            const ChunkedPayload& currentPayload;
+            Decoder               currentDecoder;
+            unsigned long         nextChunk;
+    };
+
+    /**
+     * Function that opens a chunked payload for streaming decompression.
+     *
+     * \param[in] payload The chunked payload.
+     *
+     * \param[in] decoder The function used to decompress a single chunk.
+     *
+     * \return Returns the stream decoder.
+     */
+    template<typename Decoder> inline std::unique_ptr<StreamDecoder> openChunkedStream(
+            const ChunkedPayload& payload,
+            Decoder               decoder
+        ) {
+        return std::unique_ptr<StreamDecoder>(new ChunkedStreamDecoder<Decoder>(payload, decoder));
+    }
+}
+
+#endif
+
+)");
+    }
+
+    if (outputSettings.cdcAverageSize > 0) {
+        dumpCode(outputStream, 0, indentation, R"(#ifndef BUILD_PAYLOAD_CHUNK_LIST_STREAM_RUNTIME
+#define BUILD_PAYLOAD_CHUNK_LIST_STREAM_RUNTIME
+
+namespace BuildPayload {
+    /**
+     * Class that streams a payload held in a chunk store one chunk at a time.  Consecutive references to the same
+     * chunk are decompressed once.
+     */
+    template<typename Decoder> class ChunkListStreamDecoder:public BlockStreamDecoder {
+        public:
+            ChunkListStreamDecoder(
+                    const ChunkList& list,
+                    Decoder          decoder
+                ):BlockStreamDecoder(
+                    list.uncompressedSize
+                ),currentList(
+                    list
+                ),currentDecoder(
+                    decoder
+                ),nextChunk(
+                    0
+                ),bufferedChunk(
+                    list.store->numberChunks
+                ) {}
+
+        protected:
+            bool nextBlock(std::vector<unsigned char>& block) override {
+                bool result = false;
+                if (nextChunk < currentList.numberChunks) {
+                    const ChunkStore& store      = *currentList.store;
+                    unsigned long     chunkIndex = currentList.chunks[nextChunk];
+
+                    if (chunkIndex == bufferedChunk) {
+                        result = true;
+                    } else {
+                        block.resize(store.lengths[chunkIndex]);
+                        result = currentDecoder(
+                            store.data + store.offsets[chunkIndex],
+                            store.offsets[chunkIndex + 1] - store.offsets[chunkIndex],
+                            block.data(),
+                            store.lengths[chunkIndex]
+                        );
+
+                        currentFailed = !result;
+                        bufferedChunk = chunkIndex;
+                    }
+
+                    ++nextChunk;
+                }
+
+                return result;
+            }
+
+        private:
+            const ChunkList& currentList;
+            Decoder          currentDecoder;
+            unsigned long    nextChunk;
+            unsigned long    bufferedChunk;
+    };
+
+    /**
+     * Function that opens a payload held in a chunk store for streaming decompression.
+     *
+     * \param[in] list    The chunk list describing the payload.
+     *
+     * \param[in] decoder The function used to decompress a single chunk.
+     *
+     * \return Returns the stream decoder.
+     */
+    template<typename Decoder> inline std::unique_ptr<StreamDecoder> openChunkListStream(
+            const ChunkList& list,
+            Decoder          decoder
+        ) {
+        return std::unique_ptr<StreamDecoder>(new ChunkListStreamDecoder<Decoder>(list, decoder));
+    }
+}
+
+#endif
+
+)");
+    }
+}
+
+
+/**
+ * Function that returns the name of the generated class used to incrementally decompress a payload compressed with a
+ * codec.
+ *
+ * \param[in] codec The codec of interest.
+ *
+ * \return Returns the fully qualified class name.
+ */
+std::string streamDecoderName(Codec codec) {
+    std::string result;
+
+    switch (codec) {
+        case Codec::NONE:    { result = "BuildPayload::StoredStreamDecoder";   break; }
+        case Codec::QT_ZLIB: { result = "BuildPayload::QtStreamDecoder";       break; }
+        case Codec::ZSTD:    { result = "BuildPayload::ZstdStreamDecoder";     break; }
+        case Codec::LZ4:     { result = "BuildPayload::Lz4StreamDecoder";      break; }
+        case Codec::XZ:      { result = "BuildPayload::XzStreamDecoder";       break; }
+    }
+
+    return result;
+}
+
+
+/**
+ * Function that dumps the function that opens a payload for streaming decompression.
+ *
+ * \param[in] outputStream    The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] name            The name of the payload, including any prefix.
+ *
+ * \param[in] openExpression  The expression that creates the stream decoder.
+ *
+ * \param[in] record          If true, the function records the access in the access profile.
+ */
+void dumpStreamOpener(
+        std::ostream&      outputStream,
+        unsigned           leftIndentation,
+        unsigned           indentation,
+        const std::string& name,
+        const std::string& openExpression,
+        bool               record
+    ) {
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that opens " + name + " for streaming decompression.  Read the payload through a\n"
+              " * BuildPayload::PayloadStreamBuffer or, with Qt, a BuildPayload::PayloadDevice.\n"
+              " */\n"
+              "static inline std::unique_ptr<BuildPayload::StreamDecoder> " + name + "OpenStream() {\n"
+            + (record ? "    " + name + "Record();\n" : std::string())
+            + toReturnStatement(std::vector<std::string>(1, openExpression), 4) +
+              "}\n"
+              "\n"
+        ).c_str()
+    );
+}
+
+
+/**
+ * Function that compresses a single payload and dumps its contents.
+ *
+ * \param[in] outputStream        The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation     Additional left side indentation.
+ *
+ * \param[in] indentation         The desired indentation in spaces.
+ *
+ * \param[in] width               The desired maximum line width.
+ *
+ * \param[in] prefix              An optional prefix in front of each variable name.
+ *
+ * \param[in] variableName        The payload variable name or suffix.
+ *
+ * \param[in] variableType        The variable type for the payload contents.
+ *
+ * \param[in] sizeVariableName    The size variable name or suffix.
+ *
+ * \param[in] sizeVariableType    The size variable type.
+ *
+ * \param[in] inputBuffer         The uncompressed payload.
+ *
+ * \param[in] compressionSettings The compression settings to apply to the payload.
+ *
+ * \param[in] dictionary          The shared dictionary to compress against.  An empty dictionary indicates none.
+ *
+ * \param[in] outputSettings      Settings controlling how the payload is laid out.
+ *
+ * \param[in] aliasPrefix         The prefix of an earlier payload with identical contents.  When supplied the payload
+ *                                is not compressed again and its declarations refer to the earlier payload's storage.
+ *                                An empty prefix indicates the payload is not an alias.
+ *
+ * \param[in,out] compressed      The compressed payload.  Filled in unless the payload is an alias, in which case it
+ *                                must hold the compressed form of the earlier payload.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool compressAndDumpPayload(
+        std::ostream&                     outputStream,
+        unsigned                          leftIndentation,
+        unsigned                          indentation,
+        unsigned                          width,
+        const std::string&                prefix,
+        const std::string&                variableName,
+        const std::string&                variableType,
+        const std::string&                sizeVariableName,
+        const std::string&                sizeVariableType,
+        const std::vector<unsigned char>& inputBuffer,
+        const CompressionSettings&        compressionSettings,
+        const std::vector<unsigned char>& dictionary,
+        const OutputSettings&             outputSettings,
+        const std::string&                aliasPrefix,
+        CompressedPayload&                compressed
+    ) {
+    bool success = true;
+
+    if (aliasPrefix.empty()) {
+        if (outputSettings.chunkSize > 0) {
+            success = compressChunks(
+                inputBuffer,
+                compressionSettings,
+                outputSettings.chunkSize,
+                compressed.data,
+                compressed.chunkOffsets
+            );
+        } else {
+            success = compressPayload(inputBuffer, compressionSettings, dictionary, compressed.data);
+        }
+    }
+
+    if (success) {
+        std::string leftIndentationString(leftIndentation, ' ');
+        std::string payloadName = outputSettings.solid ? std::string() : prefix + variableName;
+
+        if (aliasPrefix.empty()) {
+            dumpByteArray(
+                outputStream,
+                leftIndentation,
+                indentation,
+                width,
+                variableType + " " + prefix + variableName,
+                compressed.data,
+                outputSettings.alignment,
+                toSectionAttribute(
+                    variableType,
+                    toSectionName(outputSettings, payloadName, prefix + variableName, false)
+                )
+            );
+        } else {
+            outputStream << leftIndentationString << variableType << " (&" << prefix << variableName << ")["
+                         << toAlignedSize(compressed.data.size(), outputSettings.alignment) << "] = "
+                         << aliasPrefix << variableName << ";" << std::endl
+                         << std::endl;
+        }
+
+        outputStream << leftIndentationString << sizeVariableType << " " << prefix << sizeVariableName
+                     << toSectionAttribute(
+                            sizeVariableType,
+                            toSectionName(outputSettings, payloadName, prefix + sizeVariableName, true)
+                        )
+                     << " = " << compressed.data.size() << ";" << std::endl
+                     << std::endl;
+
+        if (outputSettings.alignment > 0) {
+            dumpAdvise(outputStream, leftIndentation, indentation, prefix + variableName);
+        }
+
+        if (outputSettings.recordProfile) {
+            dumpRecord(outputStream, leftIndentation, indentation, prefix + variableName);
+        }
+
+        bool legacyCodec = (
+               dictionary.empty()
+            && (compressionSettings.codec == Codec::QT_ZLIB || compressionSettings.codec == Codec::NONE)
+        );
+
+        bool metadataRequired = (
+               !legacyCodec
+            || compressionSettings.includeMetadata
+            || outputSettings.chunkSize > 0
+            || !compressionSettings.filters.empty()
+        );
+
+        if (metadataRequired) {
+            outputStream << leftIndentationString << "static const char " << prefix << variableName << "Codec[] = \""
+                         << toString(compressionSettings.codec) << "\";" << std::endl;
+
+            if (!compressionSettings.filters.empty()) {
+                dumpFilterMetadata(
+                    outputStream,
+                    leftIndentation,
+                    indentation,
+                    prefix + variableName,
+                    compressionSettings.filters
+                );
+            }
+
+            if (compressionSettings.autoCodec) {
+                outputStream << leftIndentationString << "static const int " << prefix << variableName
+                             << "Level = " << compressionSettings.level << ";" << std::endl;
+            }
+
+            outputStream << leftIndentationString
+                         << (outputSettings.decompressInto ? toConstexprType(sizeVariableType) : sizeVariableType)
+                         << " " << prefix << variableName << "UncompressedSize = " << inputBuffer.size() << ";"
+                         << std::endl
+                         << std::endl;
+        }
+
+        if (outputSettings.chunkSize > 0) {
+            std::string name = prefix + variableName;
+
+            if (aliasPrefix.empty()) {
+                dumpValueArray(
+                    outputStream,
+                    leftIndentation,
+                    indentation,
+                    width,
+                    "static const unsigned long " + name + "ChunkOffsets",
+                    compressed.chunkOffsets
+                );
+
+                outputStream << leftIndentationString << "static const BuildPayload::ChunkedPayload " << name
+                             << "Chunks = {" << std::endl
+                             << leftIndentationString << std::string(indentation, ' ')
+                             << "reinterpret_cast<const unsigned char*>(" << name << "), " << name
+                             << "ChunkOffsets, " << (compressed.chunkOffsets.size() - 1) << "UL, "
+                             << outputSettings.chunkSize << "UL, " << inputBuffer.size() << "UL" << std::endl
+                             << leftIndentationString << "};" << std::endl
+                             << std::endl;
+            } else {
+                outputStream << leftIndentationString << "static const unsigned long (&" << name << "ChunkOffsets)["
+                             << compressed.chunkOffsets.size() << "] = " << aliasPrefix << variableName
+                             << "ChunkOffsets;" << std::endl
+                             << leftIndentationString << "static const BuildPayload::ChunkedPayload& " << name
+                             << "Chunks = " << aliasPrefix << variableName << "Chunks;" << std::endl
+                             << std::endl;
+            }
+
+            // Each chunk is filtered independently so filtered payloads decode each chunk and then undo the filters.
+            std::string decoderName = chunkDecoderName(compressionSettings.codec);
+            if (!compressionSettings.filters.empty()) {
+                dumpCode(
+                    outputStream,
+                    leftIndentation,
+                    indentation,
+                    (
+                          "/**\n"
+                          " * Function that decompresses a single chunk of " + name + " and undoes its filters.\n"
+                          " */\n"
+                          "static inline bool " + name + "DecodeChunk(\n"
+                          "        const unsigned char* source,\n"
+                          "        unsigned long        sourceSize,\n"
+                          "        unsigned char*       destination,\n"
+                          "        unsigned long        destinationSize\n"
+                          "    ) {\n"
+                          "    return (\n"
+                          "           " + decoderName + "(source, sourceSize, destination, destinationSize)\n"
+                          "        && BuildPayload::unfilter(" + name + "FilterSteps, destination, destinationSize)\n"
+                          "    );\n"
+                          "}\n"
+                          "\n"
+                    ).c_str()
+                );
+
+                decoderName = name + "DecodeChunk";
+            }
+
+            dumpCode(
+                outputStream,
+                leftIndentation,
+                indentation,
+                (
+                      "/**\n"
+                      " * Function that reads a range of bytes from " + name + ", decompressing only the chunks\n"
+                      " * covering the range.\n"
+                      " */\n"
+                      "static inline bool " + name + "Read(\n"
+                      "        unsigned long  offset,\n"
+                      "        unsigned long  length,\n"
+                      "        unsigned char* destination\n"
+                      "    ) {\n"
+                      "    return BuildPayload::readChunkedRange(\n"
+                      "        " + name + "Chunks,\n"
+                      "        offset,\n"
+                      "        length,\n"
+                      "        destination,\n"
+                      "        " + decoderName + "\n"
+                      "    );\n"
+                      "}\n"
+                      "\n"
+                      "/**\n"
+                      " * Function that decompresses all of " + name + " in parallel using a pool of threads.  A\n"
+                      " * value of 0 uses one thread per hardware thread.\n"
+                      " */\n"
+                      "static inline bool " + name + "Decompress(\n"
+                      "        unsigned char* destination,\n"
+                      "        unsigned       numberThreads = 0\n"
+                      "    ) {\n"
+                      "    return BuildPayload::decompressChunked(\n"
+                      "        " + name + "Chunks,\n"
+                      "        destination,\n"
+                      "        " + decoderName + ",\n"
+                      "        numberThreads\n"
+                      "    );\n"
+                      "}\n"
+                      "\n"
+                      "/**\n"
+                      " * Function that decompresses all of " + name + " in parallel by submitting tasks to a\n"
+                      " * caller supplied executor.\n"
+                      " */\n"
+                      "template<typename Executor> static inline bool " + name + "DecompressOn(\n"
+                      "        unsigned char* destination,\n"
+                      "        Executor&&     executor,\n"
+                      "        unsigned       numberTasks\n"
+                      "    ) {\n"
+                      "    return BuildPayload::decompressChunkedOn(\n"
+                      "        " + name + "Chunks,\n"
+                      "        destination,\n"
+                      "        " + decoderName + ",\n"
+                      "        executor,\n"
+                      "        numberTasks\n"
+                      "    );\n"
+                      "}\n"
+                      "\n"
+                ).c_str()
+            );
+        }
+
+        if (outputSettings.accessors      ||
+            outputSettings.decompressInto ||
+            outputSettings.stream         ||
+            outputSettings.cache             ) {
+            std::string              name = prefix + variableName;
+            std::vector<std::string> decodeSteps;
+
+            // Recording from the decoder captures the first access without adding work to later accesses.
+            if (outputSettings.recordProfile) {
+                decodeSteps.push_back(name + "Record()");
+            }
+
+            if (outputSettings.chunkSize == 0) {
+                // Payloads compressed against the shared dictionary need it again to decompress.
+                std::string decoderName         = chunkDecoderName(compressionSettings.codec);
+                std::string dictionaryArguments;
+                if (!dictionary.empty() && !dictionaryDecoderName(compressionSettings.codec).empty()) {
+                    decoderName         = dictionaryDecoderName(compressionSettings.codec);
+                    dictionaryArguments = (
+                          ",\n"
+                          "    reinterpret_cast<const unsigned char*>(" + variableName + "Dictionary),\n"
+                          "    " + variableName + "DictionarySize"
+                    );
+                }
+
+                decodeSteps.push_back(
+                      decoderName + "(\n"
+                      "    reinterpret_cast<const unsigned char*>(" + name + "),\n"
+                      "    " + prefix + sizeVariableName + ",\n"
+                      "    destination,\n"
+                      "    " + name + "UncompressedSize"
+                    + dictionaryArguments + "\n"
+                      ")"
+                );
+
+                if (!compressionSettings.filters.empty()) {
+                    decodeSteps.push_back(
+                        "BuildPayload::unfilter(" + name + "FilterSteps, destination, " + name + "UncompressedSize)"
+                    );
+                }
+            }
+
+            // Chunked payloads are read on the calling thread, which needs no allocation, or decompressed in parallel.
+            if (outputSettings.decompressInto) {
+                std::vector<std::string> decompressIntoSteps = decodeSteps;
+                if (outputSettings.chunkSize > 0) {
+                    decompressIntoSteps.push_back(name + "Read(0, " + name + "UncompressedSize, destination)");
+                }
+
+                dumpDecompressInto(outputStream, leftIndentation, indentation, name, decompressIntoSteps);
+            }
+
+            if (outputSettings.accessors || outputSettings.cache) {
+                std::vector<std::string> accessorSteps = decodeSteps;
+                if (outputSettings.chunkSize > 0) {
+                    accessorSteps.push_back(name + "Decompress(destination)");
+                }
+
+                if (outputSettings.accessors) {
+                    dumpAccessor(outputStream, leftIndentation, indentation, name, accessorSteps);
+                }
+
+                if (outputSettings.cache) {
+                    dumpCacheAccessor(outputStream, leftIndentation, indentation, name, accessorSteps);
+                }
+            }
+
+            // Filtered payloads are always chunked when streamed so their filters are undone one chunk at a time.
+            if (outputSettings.stream) {
+                std::string openExpression;
+                if (outputSettings.chunkSize > 0) {
+                    std::string chunkDecoder = (
+                          compressionSettings.filters.empty()
+                        ? chunkDecoderName(compressionSettings.codec)
+                        : name + "DecodeChunk"
+                    );
+
+                    openExpression = "BuildPayload::openChunkedStream(" + name + "Chunks, " + chunkDecoder + ")";
+                } else {
+                    std::string dictionaryArguments;
+                    if (!dictionary.empty() && !dictionaryDecoderName(compressionSettings.codec).empty()) {
+                        dictionaryArguments = (
+                              ",\n"
+                              "    reinterpret_cast<const unsigned char*>(" + variableName + "Dictionary),\n"
+                              "    " + variableName + "DictionarySize"
+                        );
+                    }
+
+                    openExpression = (
+                          "BuildPayload::openStream<" + streamDecoderName(compressionSettings.codec) + ">(\n"
+                          "    reinterpret_cast<const unsigned char*>(" + name + "),\n"
+                          "    " + prefix + sizeVariableName + ",\n"
+                          "    " + name + "UncompressedSize"
+                        + dictionaryArguments + "\n"
+                          ")"
+                    );
+                }
+
+                dumpStreamOpener(
+                    outputStream,
+                    leftIndentation,
+                    indentation,
+                    name,
+                    openExpression,
+                    outputSettings.recordProfile
+                );
+            }
+        }
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that strips any leading directory from a filename.
+ *
+ * \param[in] inputFilename The filename to convert.
+ *
+ * \return Returns the filename without any directory.
+ */
+std::string toBaseName(const std::string& inputFilename) {
+    std::size_t forwardSlashPosition = inputFilename.rfind('/');
+    std::size_t backslashPosition    = inputFilename.rfind('\\');
+
+    std::string prefix;
+    if (forwardSlashPosition != std::string::npos) {
+        if (backslashPosition != std::string::npos) {
+            std::size_t slashPosition = std::max(forwardSlashPosition, backslashPosition);
+            prefix = inputFilename.substr(slashPosition + 1);
+        } else {
+            prefix = inputFilename.substr(forwardSlashPosition + 1);
+        }
+    } else {
+        if (backslashPosition != std::string::npos) {
+            prefix = inputFilename.substr(backslashPosition + 1);
+        } else {
+            prefix = inputFilename;
+        }
+    }
+
+    return prefix;
+}
+
+
+/**
+ * Function that derives a variable name prefix from a filename.  The prefix is the filename, less any directory, with
+ * periods replaced by underscores.
+ *
+ * \param[in] inputFilename The filename to convert.
+ *
+ * \return Returns the variable name prefix.
+ */
+std::string toPrefix(const std::string& inputFilename) {
+    std::string prefix = toBaseName(inputFilename);
+    std::replace(prefix.begin(), prefix.end(), '.', '_');
+
+    return prefix;
+}
+
+
+/**
+ * Function that converts a string to a C++ string literal, including the enclosing quotes.
+ *
+ * \param[in] text The text to convert.
+ *
+ * \return Returns the string literal.
+ */
+std::string toStringLiteral(const std::string& text) {
+    std::string result = "\"";
+
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+            result += c;
+        } else if (c < ' ' || c > '~') {
+            char buffer[8];
+            sprintf(buffer, "\\%03o", static_cast<unsigned>(static_cast<unsigned char>(c)));
+            result += buffer;
+        } else {
+            result += c;
+        }
+    }
+
+    result += "\"";
+    return result;
+}
+
+
+/**
+ * Function that loads the contents of every input.
+ *
+ * \param[in]  inputs   The list of input files.  An empty list indicates stdin.
+ *
+ * \param[out] payloads The loaded payloads, in input order.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool loadPayloads(const std::vector<std::string>& inputs, std::vector<Payload>& payloads) {
+    bool success = true;
+
+    payloads.clear();
+
+    if (inputs.empty()) {
+        payloads.push_back(Payload());
+        success = readInput(std::cin, payloads.back().data);
+        if (!success) {
+            std::cerr << "*** Error reading input." << std::endl;
+        }
+    } else {
+        std::vector<std::string>::const_iterator inputIterator    = inputs.cbegin();
+        std::vector<std::string>::const_iterator inputEndIterator = inputs.cend();
+        while (success && inputIterator != inputEndIterator) {
+            const std::string& inputFilename = *inputIterator;
+            std::ifstream      inputStream(inputFilename, std::ios::binary);
+
+            if (inputStream) {
+                payloads.push_back(Payload());
+                Payload& payload = payloads.back();
+
+                payload.filename = inputFilename;
+                if (inputs.size() > 1) {
+                    payload.prefix = toPrefix(inputFilename);
+                }
+
+                success = readInput(inputStream, payload.data);
+                if (!success) {
+                    std::cerr << "*** Error reading input file " << inputFilename << std::endl;
+                }
+
+                inputStream.close();
+                ++inputIterator;
+            } else {
+                std::cerr << "*** Could not open input file " << inputFilename << std::endl;
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that loads an access profile recorded by the generated runtime.  Each line holds a payload name.  Repeated
+ * names, recorded by other translation units or earlier runs, are ignored.
+ *
+ * \param[in]  filename The profile file.
+ *
+ * \param[out] profile  The payload names, in first access order.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool loadProfile(const std::string& filename, std::vector<std::string>& profile) {
+    std::ifstream inputStream(filename);
+    bool          success = static_cast<bool>(inputStream);
+
+    if (success) {
+        std::string line;
+        while (std::getline(inputStream, line)) {
+            std::size_t first = line.find_first_not_of(" \t\r");
+            std::size_t last  = line.find_last_not_of(" \t\r");
+            if (first != std::string::npos) {
+                std::string name = line.substr(first, last - first + 1);
+                if (std::find(profile.begin(), profile.end(), name) == profile.end()) {
+                    profile.push_back(name);
+                }
+            }
+        }
+    } else {
+        std::cerr << "*** Could not open profile file " << filename << std::endl;
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that reorders payloads to follow an access profile.  Payloads named in the profile are placed first, in
+ * profile order, followed by the remaining payloads in input order.
+ *
+ * \param[in]     profile      The payload names, in first access order.
+ *
+ * \param[in]     variableName The payload variable name or suffix.
+ *
+ * \param[in,out] payloads     The payloads to reorder.
+ */
+void orderPayloads(
+        const std::vector<std::string>& profile,
+        const std::string&              variableName,
+        std::vector<Payload>&           payloads
+    ) {
+    auto rank = [&profile, &variableName](const Payload& payload) {
+        return static_cast<std::size_t>(
+            std::find(profile.begin(), profile.end(), payload.prefix + variableName) - profile.begin()
+        );
+    };
+
+    std::stable_sort(
+        payloads.begin(),
+        payloads.end(),
+        [&rank](const Payload& a, const Payload& b) {
+            return rank(a) < rank(b);
+        }
+    );
+}
+
+
+/**
+ * Function that finds payloads with identical contents.  Payloads are grouped by a 64-bit FNV-1a hash and then
+ * compared byte for byte.  Each duplicate records the index of the first payload with the same contents and its own
+ * copy of the contents is released.
+ *
+ * \param[in,out] payloads The payloads to examine.
+ */
+void findDuplicatePayloads(std::vector<Payload>& payloads) {
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> payloadsByHash;
+
+    for (std::size_t index=0 ; index<payloads.size() ; ++index) {
+        Payload& payload = payloads[index];
+        payload.originalIndex = index;
+
+        std::uint64_t hash = 0xCBF29CE484222325ULL;
+        for (unsigned char v : payload.data) {
+            hash = (hash ^ v) * 0x100000001B3ULL;
+        }
+
+        std::vector<std::size_t>& candidates = payloadsByHash[hash];
+        for (std::size_t candidate : candidates) {
+            if (payloads[candidate].data == payload.data) {
+                payload.originalIndex = candidate;
+                break;
+            }
+        }
+
+        if (payload.originalIndex == index) {
+            candidates.push_back(index);
+        } else {
+            std::vector<unsigned char>().swap(payload.data);
+        }
+    }
+}
+
+
+/**
+ * Function that divides data into content defined chunks using the FastCDC algorithm.  A gear hash is rolled across
+ * the data and a boundary is placed wherever the hash's masked bits are all zero.  Boundaries depend only on nearby
+ * content so an insertion or deletion moves only the boundaries around it.  A stricter mask is used below the average
+ * size and a looser mask above it, normalizing the chunk sizes.  Chunks are between a quarter of and eight times the
+ * average size.
+ *
+ * \param[in] data        The data to be divided.
+ *
+ * \param[in] averageSize The desired average chunk size, in bytes.
+ *
+ * \return Returns the length of each chunk, in order.
+ */
+std::vector<std::size_t> findContentDefinedChunks(const std::vector<unsigned char>& data, std::size_t averageSize) {
+    // The table is generated from a fixed seed so chunk boundaries are the same from one run to the next.
+    static const std::vector<std::uint64_t> gear = []() {
+        std::mt19937_64            generator(0x4275696C64ULL);
+        std::vector<std::uint64_t> result(256);
+        for (std::uint64_t& value : result) {
+            value = generator();
+        }
+
+        return result;
+    }();
+
+    unsigned averageBits = 0;
+    while ((std::size_t(2) << averageBits) <= averageSize) {
+        ++averageBits;
+    }
+
+    std::uint64_t strictMask  = ~std::uint64_t(0) << (64 - (averageBits + 1));
+    std::uint64_t relaxedMask = ~std::uint64_t(0) << (64 - (averageBits - 1));
+    std::size_t   minimumSize = averageSize / 4;
+    std::size_t   maximumSize = averageSize * 8;
+
+    std::vector<std::size_t> result;
+    std::size_t              start = 0;
+    while (start < data.size()) {
+        std::size_t remaining = data.size() - start;
+        std::size_t normal    = std::min(averageSize, remaining);
+        std::size_t maximum   = std::min(maximumSize, remaining);
+        std::size_t length    = maximum;
+
+        std::uint64_t fingerprint = 0;
+        for (std::size_t i=minimumSize ; i<maximum ; ++i) {
+            fingerprint = (fingerprint << 1) + gear[data[start + i]];
+            if ((fingerprint & (i < normal ? strictMask : relaxedMask)) == 0) {
+                length = i + 1;
+                break;
+            }
+        }
+
+        result.push_back(length);
+        start += length;
+    }
+
+    return result;
+}
+
+
+/**
+ * Structure holding the unique content defined chunks of a set of payloads.
+ */
+struct DeduplicatedChunks {
+    /**
+     * Structure locating a unique chunk within the payload where it first appears.
+     */
+    struct Chunk {
+        /**
+         * The index of the payload holding the chunk.
+         */
+        std::size_t payloadIndex;
+
+        /**
+         * The offset of the chunk within the payload.
+         */
+        std::size_t offset;
+
+        /**
+         * The length of the chunk, in bytes.
+         */
+        std::size_t length;
+    };
+
+    /**
+     * The unique chunks, in order of first appearance.
+     */
+    std::vector<Chunk> chunks;
+
+    /**
+     * The chunks making up each payload, as indices into the list of unique chunks.
+     */
+    std::vector<std::vector<unsigned long long>> chunkLists;
+};
+
+
+/**
+ * Function that divides every payload into content defined chunks and finds the unique chunks.  Chunks are grouped by
+ * a 64-bit FNV-1a hash and then compared byte for byte.  Duplicate payloads reuse the chunk list of the original.
+ *
+ * \param[in]  payloads    The payloads to be divided.
+ *
+ * \param[in]  averageSize The desired average chunk size, in bytes.
+ *
+ * \param[out] result      The unique chunks and the chunk list of each payload.
+ */
+void deduplicateChunks(
+        const std::vector<Payload>& payloads,
+        std::size_t                 averageSize,
+        DeduplicatedChunks&         result
+    ) {
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> chunksByHash;
+
+    result.chunks.clear();
+    result.chunkLists.assign(payloads.size(), std::vector<unsigned long long>());
+
+    for (std::size_t index=0 ; index<payloads.size() ; ++index) {
+        const Payload& payload = payloads[index];
+
+        if (payload.originalIndex != index) {
+            result.chunkLists[index] = result.chunkLists[payload.originalIndex];
+        } else {
+            std::size_t offset = 0;
+            for (std::size_t length : findContentDefinedChunks(payload.data, averageSize)) {
+                const unsigned char* chunkData = payload.data.data() + offset;
+
+                std::uint64_t hash = 0xCBF29CE484222325ULL;
+                for (std::size_t i=0 ; i<length ; ++i) {
+                    hash = (hash ^ chunkData[i]) * 0x100000001B3ULL;
+                }
+
+                std::vector<std::size_t>& candidates = chunksByHash[hash];
+                std::size_t               chunkIndex = result.chunks.size();
+                for (std::size_t candidate : candidates) {
+                    const DeduplicatedChunks::Chunk& chunk = result.chunks[candidate];
+                    if (chunk.length == length                                                              &&
+                        std::memcmp(payloads[chunk.payloadIndex].data.data() + chunk.offset, chunkData, length) == 0) {
+                        chunkIndex = candidate;
+                        break;
+                    }
+                }
+
+                if (chunkIndex == result.chunks.size()) {
+                    result.chunks.push_back({ index, offset, length });
+                    candidates.push_back(chunkIndex);
+                }
+
+                result.chunkLists[index].push_back(chunkIndex);
+                offset += length;
+            }
+        }
+    }
+}
+
+
+/**
+ * Function that compresses each unique chunk independently.  Chunks are compressed in parallel, each on a single
+ * thread.
+ *
+ * \param[in]  payloads            The payloads holding the chunks.
+ *
+ * \param[in]  chunks              The unique chunks.
+ *
+ * \param[in]  compressionSettings The compression settings to apply to each chunk.
+ *
+ * \param[out] compressed          The compressed chunks, back to back, and the offset of each.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool compressDeduplicatedChunks(
+        const std::vector<Payload>& payloads,
+        const DeduplicatedChunks&   chunks,
+        const CompressionSettings&  compressionSettings,
+        CompressedPayload&          compressed
+    ) {
+    std::size_t numberChunks = chunks.chunks.size();
+
+    CompressionSettings chunkCompressionSettings = compressionSettings;
+    chunkCompressionSettings.numberThreads = 0;
+
+    std::vector<std::vector<unsigned char>> compressedChunks(numberChunks);
+    std::atomic<std::size_t>                nextChunk(0);
+    std::atomic<bool>                       success(true);
+
+    auto worker = [&]() {
+        std::size_t chunkIndex = nextChunk++;
+        while (success && chunkIndex < numberChunks) {
+            const DeduplicatedChunks::Chunk&           location = chunks.chunks[chunkIndex];
+            std::vector<unsigned char>::const_iterator start    = (
+                payloads[location.payloadIndex].data.begin() + location.offset
+            );
+
+            std::vector<unsigned char> chunk(start, start + location.length);
+            std::vector<unsigned char> noDictionary;
+            if (!compressPayload(chunk, chunkCompressionSettings, noDictionary, compressedChunks[chunkIndex])) {
+                success = false;
+            }
+
+            chunkIndex = nextChunk++;
+        }
+    };
+
+    std::size_t              numberThreads = std::min<std::size_t>(compressionSettings.numberThreads, numberChunks);
+    std::vector<std::thread> threads;
+    for (std::size_t i=1 ; i<numberThreads ; ++i) {
+        threads.push_back(std::thread(worker));
+    }
+
+    worker();
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    compressed.data.clear();
+    compressed.chunkOffsets.clear();
+    for (const std::vector<unsigned char>& compressedChunk : compressedChunks) {
+        compressed.chunkOffsets.push_back(compressed.data.size());
+        compressed.data.insert(compressed.data.end(), compressedChunk.begin(), compressedChunk.end());
+    }
+
+    compressed.chunkOffsets.push_back(compressed.data.size());
+
+    return success;
+}
+
+
+/**
+ * Function that deduplicates the content defined chunks of every payload, then dumps the shared chunk store followed
+ * by the chunk list and accessors of each payload.
+ *
+ * \param[in] outputStream        The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation     Additional left side indentation.
+ *
+ * \param[in] indentation         The desired indentation in spaces.
+ *
+ * \param[in] width               The desired maximum line width.
+ *
+ * \param[in] variableName        The payload variable name or suffix.
+ *
+ * \param[in] variableType        The variable type for the chunk store contents.
+ *
+ * \param[in] sizeVariableType    The size variable type.
+ *
+ * \param[in] payloads            The payloads to be emitted.
+ *
+ * \param[in] compressionSettings The compression settings to apply to each chunk.
+ *
+ * \param[in] outputSettings      Settings controlling how the payloads are laid out.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool compressAndDumpChunkStore(
+        std::ostream&               outputStream,
+        unsigned                    leftIndentation,
+        unsigned                    indentation,
+        unsigned                    width,
+        const std::string&          variableName,
+        const std::string&          variableType,
+        const std::string&          sizeVariableType,
+        const std::vector<Payload>& payloads,
+        const CompressionSettings&  compressionSettings,
+        const OutputSettings&       outputSettings
+    ) {
+    DeduplicatedChunks chunks;
+    deduplicateChunks(payloads, static_cast<std::size_t>(outputSettings.cdcAverageSize), chunks);
+
+    CompressedPayload compressed;
+    bool              success = compressDeduplicatedChunks(payloads, chunks, compressionSettings, compressed);
+
+    if (success) {
+        std::string leftIndentationString(leftIndentation, ' ');
+        std::string storeName = variableName + "Store";
+
+        std::vector<unsigned long long> lengths;
+        for (const DeduplicatedChunks::Chunk& chunk : chunks.chunks) {
+            lengths.push_back(chunk.length);
+        }
+
+        std::string storeArrayName = variableName + "ChunkStore";
+        outputStream << leftIndentationString << "// Chunks shared by every payload:" << std::endl;
+        dumpByteArray(
+            outputStream,
+            leftIndentation,
+            indentation,
+            width,
+            variableType + " " + storeArrayName,
+            compressed.data,
+            outputSettings.alignment,
+            toSectionAttribute(variableType, toSectionName(outputSettings, std::string(), storeArrayName, false))
+        );
+
+        std::string storeSizeName    = variableName + "ChunkStoreSize";
+        std::string storeSizeSection = toSectionName(outputSettings, std::string(), storeSizeName, true);
+        outputStream << leftIndentationString << sizeVariableType << " " << storeSizeName
+                     << toSectionAttribute(sizeVariableType, storeSizeSection) << " = " << compressed.data.size()
+                     << ";" << std::endl
+                     << std::endl;
+
+        if (outputSettings.alignment > 0) {
+            dumpAdvise(outputStream, leftIndentation, indentation, variableName + "ChunkStore");
+        }
+
+        outputStream << leftIndentationString << "static const char " << storeName << "Codec[] = \""
+                     << toString(compressionSettings.codec) << "\";" << std::endl;
+
+        if (!compressionSettings.filters.empty()) {
+            dumpFilterMetadata(outputStream, leftIndentation, indentation, storeName, compressionSettings.filters);
+        }
+
+        outputStream << std::endl;
+
+        dumpValueArray(
+            outputStream,
+            leftIndentation,
+            indentation,
+            width,
+            "static const unsigned long " + variableName + "ChunkStoreOffsets",
+            compressed.chunkOffsets
+        );
+
+        dumpValueArray(
+            outputStream,
+            leftIndentation,
+            indentation,
+            width,
+            "static const unsigned long " + variableName + "ChunkStoreLengths",
+            lengths
+        );
+
+        outputStream << leftIndentationString << "static const BuildPayload::ChunkStore " << storeName << " = {"
+                     << std::endl
+                     << leftIndentationString << std::string(indentation, ' ')
+                     << "reinterpret_cast<const unsigned char*>(" << variableName << "ChunkStore), " << variableName
+                     << "ChunkStoreOffsets, " << variableName << "ChunkStoreLengths, " << lengths.size() << "UL"
+                     << std::endl
+                     << leftIndentationString << "};" << std::endl
+                     << std::endl;
+
+        // Each chunk is filtered independently so filtered stores decode each chunk and then undo the filters.
+        std::string decoderName = chunkDecoderName(compressionSettings.codec);
+        if (!compressionSettings.filters.empty()) {
+            dumpCode(
+                outputStream,
+                leftIndentation,
+                indentation,
+                (
+                      "/**\n"
+                      " * Function that decompresses a single chunk of " + storeName + " and undoes its filters.\n"
+                      " */\n"
+                      "static inline bool " + storeName + "DecodeChunk(\n"
+                      "        const unsigned char* source,\n"
+                      "        unsigned long        sourceSize,\n"
+                      "        unsigned char*       destination,\n"
+                      "        unsigned long        destinationSize\n"
+                      "    ) {\n"
+                      "    return (\n"
+                      "           " + decoderName + "(source, sourceSize, destination, destinationSize)\n"
+                      "        && BuildPayload::unfilter(" + storeName + "FilterSteps, destination, destinationSize)\n"
+                      "    );\n"
+                      "}\n"
+                      "\n"
+                ).c_str()
+            );
+
+            decoderName = storeName + "DecodeChunk";
+        }
+
+        for (std::size_t index=0 ; index<payloads.size() ; ++index) {
+            const Payload&                         payload   = payloads[index];
+            const Payload&                         original  = payloads[payload.originalIndex];
+            const std::vector<unsigned long long>& chunkList = chunks.chunkLists[index];
+            std::string                            name      = payload.prefix + variableName;
+
+            unsigned long long uncompressedSize = 0;
+            for (unsigned long long chunkIndex : chunkList) {
+                uncompressedSize += lengths[static_cast<std::size_t>(chunkIndex)];
+            }
+
+            // Repeated chunks are copied from their first copy, located here so reassembly needs no lookup table.
+            std::unordered_map<unsigned long long, unsigned long long> firstCopies;
+            std::vector<unsigned long long>                            sources;
+            unsigned long long                                         position = 0;
+            for (unsigned long long chunkIndex : chunkList) {
+                std::unordered_map<unsigned long long, unsigned long long>::const_iterator it = firstCopies.find(
+                    chunkIndex
+                );
+
+                if (it != firstCopies.end()) {
+                    sources.push_back(it->second);
+                } else {
+                    sources.push_back(uncompressedSize);
+                    firstCopies[chunkIndex] = position;
+                }
+
+                position += lengths[static_cast<std::size_t>(chunkIndex)];
+            }
+
+            if (!payload.prefix.empty()) {
+                outputStream << leftIndentationString << "// Contents of " << payload.filename;
+                if (payload.originalIndex != index) {
+                    outputStream << ", identical to " << original.filename;
+                }
+
+                outputStream << ":" << std::endl;
+            }
+
+            dumpValueArray(
+                outputStream,
+                leftIndentation,
+                indentation,
+                width,
+                "static const unsigned long " + name + "ChunkList",
+                chunkList
+            );
+
+            dumpValueArray(
+                outputStream,
+                leftIndentation,
+                indentation,
+                width,
+                "static const unsigned long " + name + "ChunkSources",
+                sources
+            );
+
+            outputStream << leftIndentationString
+                         << (outputSettings.decompressInto ? toConstexprType(sizeVariableType) : sizeVariableType)
+                         << " " << name << "UncompressedSize = " << uncompressedSize << ";" << std::endl
+                         << leftIndentationString << "static const BuildPayload::ChunkList " << name << "Chunks = {"
+                         << std::endl
+                         << leftIndentationString << std::string(indentation, ' ') << "&" << storeName << ", "
+                         << name << "ChunkList, " << name << "ChunkSources, " << chunkList.size() << "UL, "
+                         << uncompressedSize << "UL"
+                         << std::endl
+                         << leftIndentationString << "};" << std::endl
+                         << std::endl;
+
+            dumpCode(
+                outputStream,
+                leftIndentation,
+                indentation,
+                (
+                      "/**\n"
+                      " * Function that reassembles " + name + " from the shared chunk store.  The destination must\n"
+                      " * hold " + name + "UncompressedSize bytes.\n"
+                      " */\n"
+                      "static inline bool " + name + "Reassemble(unsigned char* destination) {\n"
+                      "    return BuildPayload::reassembleChunks(" + name + "Chunks, destination, " + decoderName
+                    + ");\n"
+                      "}\n"
+                      "\n"
+                      "/**\n"
+                      " * Function that streams " + name + " one chunk at a time to a sink callable as\n"
+                      " * bool sink(const unsigned char* data, unsigned long length).\n"
+                      " */\n"
+                      "template<typename Sink> static inline bool " + name + "Stream(Sink&& sink) {\n"
+                      "    return BuildPayload::streamChunks(" + name + "Chunks, " + decoderName + ", sink);\n"
+                      "}\n"
+                      "\n"
+                ).c_str()
+            );
+
+            if (outputSettings.recordProfile) {
+                dumpRecord(outputStream, leftIndentation, indentation, name);
+            }
+
+            std::vector<std::string> decodeSteps;
+            if (outputSettings.recordProfile) {
+                decodeSteps.push_back(name + "Record()");
+            }
+
+            decodeSteps.push_back(name + "Reassemble(destination)");
+            if (outputSettings.decompressInto) {
+                dumpDecompressInto(outputStream, leftIndentation, indentation, name, decodeSteps);
+            }
+
+            if (outputSettings.accessors) {
+                dumpAccessor(outputStream, leftIndentation, indentation, name, decodeSteps);
+            }
+
+            if (outputSettings.cache) {
+                dumpCacheAccessor(outputStream, leftIndentation, indentation, name, decodeSteps);
+            }
+
+            if (outputSettings.stream) {
+                dumpStreamOpener(
+                    outputStream,
+                    leftIndentation,
+                    indentation,
+                    name,
+                    "BuildPayload::openChunkListStream(" + name + "Chunks, " + decoderName + ")",
+                    outputSettings.recordProfile
+                );
+            }
+        }
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that calculates the seeded hash of a payload name.  The hash must match BuildPayload::perfectHash, emitted
+ * by \ref dumpPerfectHashRuntime.
+ *
+ * \param[in] name The name to be hashed.
+ *
+ * \param[in] seed The seed.
+ *
+ * \return Returns the hash.
+ */
+std::uint32_t perfectHash(const std::string& name, std::uint32_t seed) {
+    std::uint64_t hash = 0xCBF29CE484222325ULL ^ (seed * 0x9E3779B97F4A7C15ULL);
+    for (char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+    }
+
+    hash = (hash ^ (hash >> 33)) * 0xFF51AFD7ED558CCDULL;
+    hash = (hash ^ (hash >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+
+    return static_cast<std::uint32_t>(hash ^ (hash >> 33));
+}
+
+
+/**
+ * Function that builds a minimal perfect hash over a set of unique names using the compress, hash and displace
+ * algorithm.  Names are divided into buckets, averaging two names per bucket, by their unseeded hash.  Buckets are
+ * then placed largest first, each bucket searching for the smallest displacement, used as the seed, that maps every
+ * name in the bucket to a distinct free slot.
+ *
+ * \param[in]  names         The names to be hashed.
+ *
+ * \param[out] displacements The displacement of each bucket.  Empty buckets hold 0.
+ *
+ * \param[out] slots         The slot assigned to each name, in name order.
+ *
+ * \return Returns true on success.  Returns false if no displacement could be found for a bucket.
+ */
+bool buildPerfectHash(
+        const std::vector<std::string>& names,
+        std::vector<std::uint32_t>&     displacements,
+        std::vector<std::size_t>&       slots
+    ) {
+    const std::uint32_t maximumDisplacement = 1U << 24;
+
+    std::size_t numberSlots   = names.size();
+    std::size_t numberBuckets = std::max(std::size_t(1), (numberSlots + 1) / 2);
+
+    std::vector<std::vector<std::size_t>> buckets(numberBuckets);
+    for (std::size_t index=0 ; index<numberSlots ; ++index) {
+        buckets[perfectHash(names[index], 0) % numberBuckets].push_back(index);
+    }
+
+    std::vector<std::size_t> bucketOrder(numberBuckets);
+    for (std::size_t bucket=0 ; bucket<numberBuckets ; ++bucket) {
+        bucketOrder[bucket] = bucket;
+    }
+
+    std::stable_sort(
+        bucketOrder.begin(),
+        bucketOrder.end(),
+        [&buckets](std::size_t a, std::size_t b) {
+            return buckets[a].size() > buckets[b].size();
+        }
+    );
+
+    displacements.assign(numberBuckets, 0);
+    slots.assign(numberSlots, 0);
+
+    bool                     success = true;
+    std::vector<bool>        occupied(numberSlots, false);
+    std::vector<std::size_t> bucketSlots;
+    for (std::size_t orderIndex=0 ; success && orderIndex<numberBuckets ; ++orderIndex) {
+        const std::vector<std::size_t>& bucket = buckets[bucketOrder[orderIndex]];
+        if (!bucket.empty()) {
+            std::uint32_t displacement = 1;
+            bool          placed       = false;
+            while (!placed && displacement < maximumDisplacement) {
+                bucketSlots.clear();
+                placed = true;
+
+                for (std::size_t i=0 ; placed && i<bucket.size() ; ++i) {
+                    std::size_t slot = perfectHash(names[bucket[i]], displacement) % numberSlots;
+                    placed = (
+                           !occupied[slot]
+                        && std::find(bucketSlots.begin(), bucketSlots.end(), slot) == bucketSlots.end()
+                    );
+
+                    bucketSlots.push_back(slot);
+                }
+
+                if (!placed) {
+                    ++displacement;
+                }
+            }
+
+            if (placed) {
+                displacements[bucketOrder[orderIndex]] = displacement;
+                for (std::size_t i=0 ; i<bucket.size() ; ++i) {
+                    occupied[bucketSlots[i]] = true;
+                    slots[bucket[i]]         = bucketSlots[i];
+                }
+            } else {
+                std::cerr << "*** Could not build a perfect hash over the payload names." << std::endl;
+                success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that compresses every payload independently, packs the compressed payloads followed by their names into a
+ * single blob and then dumps the blob along with an index of 32-bit offsets and lengths.  Payloads are located by name
+ * through a binary search of the index, sorted by name, or through a minimal perfect hash with the index in hash order
+ * so lookups need neither relocations nor startup work.
+ *
+ * \param[in] outputStream     The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation  Additional left side indentation.
+ *
+ * \param[in] indentation      The desired indentation in spaces.
+ *
+ * \param[in] width            The desired maximum line width.
+ *
+ * \param[in] variableName     The payload variable name or suffix.
+ *
+ * \param[in] variableType     The variable type for the blob contents.
+ *
+ * \param[in] sizeVariableType The size variable type.
+ *
+ * \param[in] payloads         The payloads to be packed.  Each payload carries its own compression settings.
+ *
+ * \param[in] outputSettings   Settings controlling how the payloads are laid out.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool compressAndDumpPacked(
+        std::ostream&               outputStream,
+        unsigned                    leftIndentation,
+        unsigned                    indentation,
+        unsigned                    width,
+        const std::string&          variableName,
+        const std::string&          variableType,
+        const std::string&          sizeVariableType,
+        const std::vector<Payload>& payloads,
+        const OutputSettings&       outputSettings
+    ) {
+    const unsigned long long maximumOffset = 0xFFFFFFFFULL;
+
+    struct Entry {
+        std::string        name;
+        unsigned long long offset;
+        unsigned long long size;
+        unsigned long long uncompressedSize;
+        unsigned long long nameOffset;
+        Codec              codec;
+        bool               filtered;
+    };
+
+    bool                       success = true;
+    std::vector<unsigned char> blob;
+    std::vector<Entry>         entries(payloads.size());
+    std::vector<Filter>        filters;
+
+    // Duplicates share the compressed data of the payload they are identical to.
+    for (std::size_t index=0 ; success && index<payloads.size() ; ++index) {
+        const Payload& payload = payloads[index];
+        Entry&         entry   = entries[index];
+
+        entry.name = toBaseName(payload.filename);
+        if (payload.originalIndex != index) {
+            const Entry& original = entries[payload.originalIndex];
+
+            entry.offset           = original.offset;
+            entry.size             = original.size;
+            entry.uncompressedSize = original.uncompressedSize;
+            entry.codec            = original.codec;
+            entry.filtered         = original.filtered;
+        } else {
+            std::vector<unsigned char> noDictionary;
+            std::vector<unsigned char> compressed;
+            success = compressPayload(payload.data, payload.compressionSettings, noDictionary, compressed);
+
+            entry.offset           = blob.size();
+            entry.size             = compressed.size();
+            entry.uncompressedSize = payload.data.size();
+            entry.codec            = payload.compressionSettings.codec;
+            entry.filtered         = !payload.compressionSettings.filters.empty();
+
+            if (entry.filtered) {
+                filters = payload.compressionSettings.filters;
+            }
+
+            if (entry.uncompressedSize > maximumOffset) {
+                std::cerr << "*** " << payload.filename << " is too large to pack, payloads are limited to 4 GiB."
+                          << std::endl;
+                success = false;
+            }
+
+            blob.insert(blob.end(), compressed.begin(), compressed.end());
+        }
+    }
+
+    for (Entry& entry : entries) {
+        entry.nameOffset = blob.size();
+        blob.insert(blob.end(), entry.name.begin(), entry.name.end());
+        blob.push_back(0);
+    }
+
+    if (success && blob.size() > maximumOffset) {
+        std::cerr << "*** The packed payloads are too large, the packed blob is limited to 4 GiB." << std::endl;
+        success = false;
+    }
+
+    std::stable_sort(
+        entries.begin(),
+        entries.end(),
+        [](const Entry& a, const Entry& b) {
+            return a.name < b.name;
+        }
+    );
+
+    for (std::size_t index=1 ; success && index<entries.size() ; ++index) {
+        if (entries[index].name == entries[index - 1].name) {
+            std::cerr << "*** Multiple inputs are named " << entries[index].name << ", packed payloads must have "
+                      << "unique names." << std::endl;
+            success = false;
+        }
+    }
+
+    // With a perfect hash each entry is moved to the slot its name hashes to.
+    std::vector<std::uint32_t> displacements;
+    if (success && outputSettings.perfectHash) {
+        std::vector<std::string> names;
+        for (const Entry& entry : entries) {
+            names.push_back(entry.name);
+        }
+
+        std::vector<std::size_t> slots;
+        success = buildPerfectHash(names, displacements, slots);
+
+        if (success) {
+            std::vector<Entry> hashedEntries(entries.size());
+            for (std::size_t index=0 ; index<entries.size() ; ++index) {
+                hashedEntries[slots[index]] = entries[index];
+            }
+
+            entries.swap(hashedEntries);
+        }
+    }
+
+    if (success) {
+        std::string leftIndentationString(leftIndentation, ' ');
+        std::string contentsIndentationString(leftIndentation + indentation, ' ');
+        std::string blobName     = variableName + "Blob";
+        std::string blobSizeName = variableName + "BlobSize";
+        std::string indexName    = variableName + "Index";
+
+        outputStream << leftIndentationString << "// Every payload, followed by the payload names:" << std::endl;
+        dumpByteArray(
+            outputStream,
+            leftIndentation,
+            indentation,
+            width,
+            variableType + " " + blobName,
+            blob,
+            outputSettings.alignment,
+            toSectionAttribute(variableType, toSectionName(outputSettings, std::string(), blobName, false))
+        );
+
+        outputStream << leftIndentationString << sizeVariableType << " " << blobSizeName
+                     << toSectionAttribute(
+                            sizeVariableType,
+                            toSectionName(outputSettings, std::string(), blobSizeName, true)
+                        )
+                     << " = " << blob.size() << ";" << std::endl
+                     << std::endl;
+
+        if (outputSettings.alignment > 0) {
+            dumpAdvise(outputStream, leftIndentation, indentation, blobName);
+        }
+
+        if (!filters.empty()) {
+            dumpFilterMetadata(outputStream, leftIndentation, indentation, variableName, filters);
+            outputStream << std::endl;
+        }
+
+        outputStream << leftIndentationString << "// Index locating each payload within " << blobName
+                     << (outputSettings.perfectHash ? ", in hash order:" : ", sorted by name:") << std::endl
+                     << leftIndentationString << (outputSettings.perfectHash ? "static constexpr" : "static const")
+                     << " BuildPayload::PackedEntry " << indexName << "[" << entries.size() << "] = {" << std::endl;
+
+        for (std::size_t index=0 ; index<entries.size() ; ++index) {
+            const Entry& entry = entries[index];
+            outputStream << contentsIndentationString << "{ " << entry.offset << "U, " << entry.size << "U, "
+                         << entry.uncompressedSize << "U, " << entry.nameOffset << "U, " << entry.name.size()
+                         << "U, " << packedCodecName(entry.codec) << ", " << (entry.filtered ? 1 : 0) << " }"
+                         << (index + 1 < entries.size() ? "," : "") << std::endl;
+        }
+
+        outputStream << leftIndentationString << "};" << std::endl
+                     << std::endl
+                     << leftIndentationString << sizeVariableType << " " << variableName << "NumberEntries = "
+                     << entries.size() << ";" << std::endl
+                     << std::endl;
+
+        std::string findExpression;
+        if (outputSettings.perfectHash) {
+            outputStream << leftIndentationString << "// Displacement of each perfect hash bucket:" << std::endl;
+            dumpValueArray(
+                outputStream,
+                leftIndentation,
+                indentation,
+                width,
+                "static constexpr std::uint32_t " + variableName + "Displacements",
+                std::vector<unsigned long long>(displacements.begin(), displacements.end())
+            );
+
+            findExpression =   "    return BuildPayload::findHashed(\n"
+                               "        reinterpret_cast<const unsigned char*>(" + blobName + "),\n"
+                               "        " + indexName + ",\n"
+                               "        " + std::to_string(entries.size()) + "UL,\n"
+                               "        " + variableName + "Displacements,\n"
+                               "        " + std::to_string(displacements.size()) + "UL,\n"
+                               "        name,\n"
+                               "        nameLength\n"
+                               "    );\n";
+        } else {
+            findExpression =   "    return BuildPayload::findPacked(\n"
+                               "        reinterpret_cast<const unsigned char*>(" + blobName + "),\n"
+                               "        " + indexName + ",\n"
+                               "        " + std::to_string(entries.size()) + "UL,\n"
+                               "        name,\n"
+                               "        nameLength\n"
+                               "    );\n";
+        }
+
+        std::vector<Codec> codecs;
+        for (const Entry& entry : entries) {
+            if (std::find(codecs.begin(), codecs.end(), entry.codec) == codecs.end()) {
+                codecs.push_back(entry.codec);
+            }
+        }
+
+        std::string cases;
+        for (Codec codec : codecs) {
+            cases +=   "        case " + packedCodecName(codec) + ": {\n"
+                       "            success = " + chunkDecoderName(codec) + "(\n"
+                       "                source,\n"
+                       "                entry.size,\n"
+                       "                destination,\n"
+                       "                entry.uncompressedSize\n"
+                       "            );\n"
+                       "\n"
+                       "            break;\n"
+                       "        }\n"
+                       "\n";
+        }
+
+        std::string unfilter;
+        if (!filters.empty()) {
+            unfilter =   "    if (success && entry.filtered != 0) {\n"
+                         "        success = BuildPayload::unfilter(" + variableName + "FilterSteps, destination, "
+                       + "entry.uncompressedSize);\n"
+                         "    }\n"
+                         "\n";
+        }
+
+        dumpCode(
+            outputStream,
+            leftIndentation,
+            indentation,
+            (
+                  "/**\n"
+                  " * Function that locates a payload in " + blobName + " by name.  Returns a null pointer if no\n"
+                  " * payload has the name.\n"
+                  " */\n"
+                  "static inline const BuildPayload::PackedEntry* " + variableName + "Find(\n"
+                  "        const char*   name,\n"
+                  "        unsigned long nameLength\n"
+                  "    ) {\n"
+                + findExpression
+                + "}\n"
+                  "\n"
+                  "/**\n"
+                  " * Function that locates a payload in " + blobName + " by its nul terminated name.\n"
+                  " */\n"
+                  "static inline const BuildPayload::PackedEntry* " + variableName + "Find(const char* name) {\n"
+                  "    return " + variableName + "Find(name, std::strlen(name));\n"
+                  "}\n"
+                  "\n"
+                  "#if (__cplusplus >= 201703L)\n"
+                  "\n"
+                  "    /**\n"
+                  "     * Function that locates a payload in " + blobName + " by name.\n"
+                  "     */\n"
+                  "    static inline const BuildPayload::PackedEntry* " + variableName
+                + "Find(std::string_view name) {\n"
+                  "        return " + variableName + "Find(name.data(), name.size());\n"
+                  "    }\n"
+                  "\n"
+                  "#endif\n"
+                  "\n"
+                  "/**\n"
+                  " * Function that obtains the nul terminated name of a payload in " + blobName + ".\n"
+                  " */\n"
+                  "static inline const char* " + variableName + "Name(const BuildPayload::PackedEntry& entry) {\n"
+                  "    return BuildPayload::packedName(reinterpret_cast<const unsigned char*>(" + blobName
+                + "), entry);\n"
+                  "}\n"
+                  "\n"
+                  "/**\n"
+                  " * Function that decompresses a payload in " + blobName + ".  The destination must hold\n"
+                  " * entry.uncompressedSize bytes.\n"
+                  " */\n"
+                  "static inline bool " + variableName + "Decompress(\n"
+                  "        const BuildPayload::PackedEntry& entry,\n"
+                  "        unsigned char*                   destination\n"
+                  "    ) {\n"
+                  "    const unsigned char* source  = reinterpret_cast<const unsigned char*>(" + blobName
+                + ") + entry.offset;\n"
+                  "    bool                 success = false;\n"
+                  "\n"
+                  "    switch (entry.codec) {\n"
+                + cases
+                + "        default: {\n"
+                  "            break;\n"
+                  "        }\n"
+                  "    }\n"
+                  "\n"
+                + unfilter
+                + "    return success;\n"
+                  "}\n"
+                  "\n"
+            ).c_str()
+        );
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that appends a value to a delta as a little endian base 128 value.
+ *
+ * \param[in,out] delta The delta to append to.
+ *
+ * \param[in]     value The value to append.
+ */
+void appendDeltaValue(std::vector<unsigned char>& delta, unsigned long long value) {
+    while (value >= 0x80) {
+        delta.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+
+    delta.push_back(static_cast<unsigned char>(value));
+}
+
+
+/**
+ * Function that encodes a target as a delta against a baseline, in the format decoded by BuildPayload::applyDelta.
+ * Matches are located through a hash of every 16 byte window in the baseline.  The baseline position just past the
+ * previous match, advanced over any literals since, is tried first so that in place edits are followed cheaply and
+ * encode as a zero distance.
+ *
+ * \param[in] baseline The baseline.
+ *
+ * \param[in] target   The data to be encoded.
+ *
+ * \return Returns the uncompressed delta.
+ */
+std::vector<unsigned char> computeDelta(
+        const std::vector<unsigned char>& baseline,
+        const std::vector<unsigned char>& target
+    ) {
+    const std::size_t   windowSize = 16;
+    const std::uint32_t emptyEntry = 0xFFFFFFFF;
+
+    unsigned hashBits = 10;
+    while (hashBits < 26 && (std::size_t(1) << hashBits) < baseline.size()) {
+        ++hashBits;
+    }
+
+    auto windowHash = [hashBits](const unsigned char* data) {
+        std::uint64_t low;
+        std::uint64_t high;
+        std::memcpy(&low, data, sizeof(low));
+        std::memcpy(&high, data + sizeof(low), sizeof(high));
+        return static_cast<std::size_t>(
+            ((low * 0x9E3779B97F4A7C15ULL) ^ (high * 0xC2B2AE3D27D4EB4FULL)) >> (64 - hashBits)
+        );
+    };
+
+    std::vector<std::uint32_t> table;
+    if (baseline.size() >= windowSize) {
+        table.assign(std::size_t(1) << hashBits, emptyEntry);
+
+        std::size_t numberWindows = std::min<std::size_t>(baseline.size() - windowSize + 1, emptyEntry);
+        for (std::size_t i=0 ; i<numberWindows ; ++i) {
+            table[windowHash(baseline.data() + i)] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    auto matchLength = [&baseline, &target](std::size_t baselineOffset, std::size_t targetOffset) {
+        std::size_t limit  = std::min(baseline.size() - baselineOffset, target.size() - targetOffset);
+        std::size_t length = 0;
+        while (length < limit && baseline[baselineOffset + length] == target[targetOffset + length]) {
+            ++length;
+        }
+
+        return length;
+    };
+
+    std::vector<unsigned char> delta;
+    std::size_t                literalStart = 0;
+    std::size_t                copyEnd      = 0;
+    std::size_t                position     = 0;
+
+    auto appendLiterals = [&delta, &target, &literalStart](std::size_t literalEnd) {
+        if (literalEnd > literalStart) {
+            appendDeltaValue(delta, static_cast<unsigned long long>(literalEnd - literalStart) << 1);
+            delta.insert(delta.end(), target.begin() + literalStart, target.begin() + literalEnd);
+        }
+    };
+
+    while (position + windowSize <= target.size()) {
+        std::size_t matchOffset = copyEnd + (position - literalStart);
+        std::size_t matchSize   = matchOffset < baseline.size() ? matchLength(matchOffset, position) : 0;
+
+        if (matchSize < windowSize && !table.empty()) {
+            std::uint32_t candidate = table[windowHash(target.data() + position)];
+            if (candidate != emptyEntry) {
+                std::size_t candidateSize = matchLength(candidate, position);
+                if (candidateSize > matchSize) {
+                    matchOffset = candidate;
+                    matchSize   = candidateSize;
+                }
+            }
+        }
+
+        if (matchSize >= windowSize) {
+            while (position > literalStart && matchOffset > 0 && baseline[matchOffset - 1] == target[position - 1]) {
+                --position;
+                --matchOffset;
+                ++matchSize;
+            }
+
+            appendLiterals(position);
+
+            unsigned long long distance = (
+                  matchOffset >= copyEnd
+                ? static_cast<unsigned long long>(matchOffset - copyEnd) << 1
+                : (static_cast<unsigned long long>(copyEnd - matchOffset - 1) << 1) | 1
+            );
+
+            appendDeltaValue(delta, (static_cast<unsigned long long>(matchSize) << 1) | 1);
+            appendDeltaValue(delta, distance);
+
+            position     += matchSize;
+            copyEnd       = matchOffset + matchSize;
+            literalStart  = position;
+        } else {
+            ++position;
+        }
+    }
+
+    appendLiterals(target.size());
+
+    return delta;
+}
+
+
+/**
+ * Function that replaces the contents of each payload with a delta against its baseline.
+ *
+ * \param[in]     baselines The baseline file paired with each payload, in input order.
+ *
+ * \param[in,out] payloads  The payloads to be encoded.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool encodeDeltas(const std::vector<std::string>& baselines, std::vector<Payload>& payloads) {
+    bool success = true;
+
+    for (std::size_t index=0 ; success && index<payloads.size() ; ++index) {
+        Payload&           payload          = payloads[index];
+        const std::string& baselineFilename = baselines[index];
+        std::ifstream      inputStream(baselineFilename, std::ios::binary);
+
+        if (inputStream) {
+            std::vector<unsigned char> baseline;
+            success = readInput(inputStream, baseline);
+            if (success) {
+                std::uint64_t hash = 0xCBF29CE484222325ULL;
+                for (unsigned char v : baseline) {
+                    hash = (hash ^ v) * 0x100000001B3ULL;
+                }
+
+                payload.baselineSize = baseline.size();
+                payload.baselineHash = hash;
+                payload.targetSize   = payload.data.size();
+                payload.data         = computeDelta(baseline, payload.data);
+            } else {
+                std::cerr << "*** Error reading baseline file " << baselineFilename << std::endl;
+            }
+
+            inputStream.close();
+        } else {
+            std::cerr << "*** Could not open baseline file " << baselineFilename << std::endl;
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that dumps the baseline metadata and the apply function of a payload that was delta encoded.
+ *
+ * \param[in] outputStream     The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation  Additional left side indentation.
+ *
+ * \param[in] indentation      The desired indentation in spaces.
+ *
+ * \param[in] payload          The delta encoded payload.
+ *
+ * \param[in] variableName     The payload variable name or suffix.
+ *
+ * \param[in] sizeVariableName The size variable name or suffix.
+ *
+ * \param[in] sizeVariableType The size variable type.
+ */
+void dumpDeltaAccessor(
+        std::ostream&      outputStream,
+        unsigned           leftIndentation,
+        unsigned           indentation,
+        const Payload&     payload,
+        const std::string& variableName,
+        const std::string& sizeVariableName,
+        const std::string& sizeVariableType
+    ) {
+    std::string leftIndentationString(leftIndentation, ' ');
+    std::string name        = payload.prefix + variableName;
+    std::string decoderName = chunkDecoderName(payload.compressionSettings.codec);
+
+    outputStream << leftIndentationString << sizeVariableType << " " << name << "BaselineSize = "
+                 << payload.baselineSize << ";" << std::endl
+                 << leftIndentationString << "static const unsigned long long " << name << "BaselineHash = 0x"
+                 << std::hex << std::uppercase << std::setw(16) << std::setfill('0') << payload.baselineHash
+                 << std::dec << std::nouppercase << std::setfill(' ') << "ULL;" << std::endl
+                 << leftIndentationString << sizeVariableType << " " << name << "TargetSize = "
+                 << payload.targetSize << ";" << std::endl
+                 << std::endl;
+
+    std::string unfilter;
+    if (!payload.compressionSettings.filters.empty()) {
+        unfilter = "        && BuildPayload::unfilter(" + name + "FilterSteps, delta.data(), delta.size())\n";
+    }
+
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that rebuilds " + name + " from its baseline and the embedded delta.  The baseline\n"
+              " * must match " + name + "BaselineSize and " + name + "BaselineHash.  The destination must\n"
+              " * hold " + name + "TargetSize bytes.\n"
+              " */\n"
+              "static inline bool " + name + "Apply(\n"
+              "        const unsigned char* baseline,\n"
+              "        unsigned long        baselineSize,\n"
+              "        unsigned char*       destination\n"
+              "    ) {\n"
+              "    std::vector<unsigned char> delta(" + name + "UncompressedSize);\n"
+              "    return (\n"
+              "           baselineSize == " + name + "BaselineSize\n"
+              "        && BuildPayload::deltaHash(baseline, baselineSize) == " + name + "BaselineHash\n"
+              "        && " + decoderName + "(\n"
+              "               reinterpret_cast<const unsigned char*>(" + name + "),\n"
+              "               " + payload.prefix + sizeVariableName + ",\n"
+              "               delta.data(),\n"
+              "               delta.size()\n"
+              "           )\n"
+            + unfilter +
+              "        && BuildPayload::applyDelta(\n"
+              "               baseline,\n"
+              "               baselineSize,\n"
+              "               delta.data(),\n"
+              "               delta.size(),\n"
+              "               destination,\n"
+              "               " + name + "TargetSize\n"
+              "           )\n"
+              "    );\n"
+              "}\n"
+              "\n"
+        ).c_str()
+    );
+}
+
+
+/**
+ * Function that builds a deflate preset dictionary from a set of payloads.  The function is a simplified form of the
+ * COVER algorithm: the payloads are divided into epochs and, from each epoch, the segment whose 8 byte substrings
+ * appear in the most payloads is selected.  Substrings already covered by the dictionary no longer contribute to a
+ * segment's score.  The most valuable segments are placed at the end of the dictionary where they are cheapest to
+ * reference.
+ *
+ * \param[in] payloads       The payloads to train on.
+ *
+ * \param[in] dictionarySize The maximum dictionary size, in bytes.
+ *
+ * \return Returns the dictionary.  An empty dictionary is returned if the payloads share no content.
+ */
+std::vector<unsigned char> trainDeflateDictionary(const std::vector<Payload>& payloads, std::size_t dictionarySize) {
+    const std::size_t dmerSize    = 8;
+    const std::size_t segmentSize = 256;
+
+    struct DmerStatistics {
+        std::uint32_t numberPayloads;
+        std::uint32_t lastPayload;
+    };
+
+    auto loadDmer = [](const unsigned char* data) {
+        std::uint64_t result;
+        std::memcpy(&result, data, sizeof(result));
+        return result;
+    };
+
+    std::unordered_map<std::uint64_t, DmerStatistics> statistics;
+    std::size_t                                       totalSize = 0;
+    for (std::size_t payloadIndex=0 ; payloadIndex<payloads.size() ; ++payloadIndex) {
+        const std::vector<unsigned char>& data = payloads[payloadIndex].data;
+        totalSize += data.size();
+
+        for (std::size_t offset=0 ; offset + dmerSize <= data.size() ; ++offset) {
+            DmerStatistics& dmerStatistics = statistics[loadDmer(data.data() + offset)];
+            if (dmerStatistics.lastPayload != payloadIndex + 1) {
+                ++dmerStatistics.numberPayloads;
+                dmerStatistics.lastPayload = static_cast<std::uint32_t>(payloadIndex + 1);
+            }
+        }
+    }
+
+    // Only substrings shared by two or more payloads are of any value.
+    auto score = [&statistics](std::uint64_t dmer) -> std::uint64_t {
+        std::unordered_map<std::uint64_t, DmerStatistics>::const_iterator it = statistics.find(dmer);
+        return (it != statistics.end() && it->second.numberPayloads > 1) ? it->second.numberPayloads : 0;
+    };
+
+    struct Segment {
+        std::uint64_t score;
+        std::size_t   payloadIndex;
+        std::size_t   offset;
+        std::size_t   size;
+    };
+
+    std::vector<Segment> segments;
+    std::size_t          numberEpochs = std::max(std::size_t(1), dictionarySize / segmentSize);
+    std::size_t          epochSize    = std::max(std::size_t(1), (totalSize + numberEpochs - 1) / numberEpochs);
+
+    std::size_t payloadIndex  = 0;
+    std::size_t payloadOffset = 0;
+    for (std::size_t epoch=0 ; epoch<numberEpochs && payloadIndex<payloads.size() ; ++epoch) {
+        Segment     best          = { 0, 0, 0, 0 };
+        std::size_t epochConsumed = 0;
+
+        while (epochConsumed < epochSize && payloadIndex < payloads.size()) {
+            const std::vector<unsigned char>& data       = payloads[payloadIndex].data;
+            std::size_t                       sliceStart = payloadOffset;
+            std::size_t                       sliceEnd   = std::min(data.size(), sliceStart + epochSize - epochConsumed);
+
+            if (sliceEnd - sliceStart >= dmerSize) {
+                // Slide a window of at most segmentSize bytes across the slice, tracking the window score.
+                std::size_t   windowSize  = std::min(segmentSize, sliceEnd - sliceStart);
+                std::size_t   windowDmers = windowSize - dmerSize + 1;
+                std::uint64_t windowScore = 0;
+                for (std::size_t i=0 ; i<windowDmers ; ++i) {
+                    windowScore += score(loadDmer(data.data() + sliceStart + i));
+                }
+
+                std::size_t windowStart = sliceStart;
+                while (true) {
+                    if (windowScore > best.score) {
+                        best = { windowScore, payloadIndex, windowStart, windowSize };
+                    }
+
+                    if (windowStart + windowSize >= sliceEnd) {
+                        break;
+                    }
+
+                    windowScore -= score(loadDmer(data.data() + windowStart));
+                    windowScore += score(loadDmer(data.data() + windowStart + windowDmers));
+                    ++windowStart;
+                }
+            }
+
+            epochConsumed += sliceEnd - sliceStart;
+            payloadOffset  = sliceEnd;
+            if (payloadOffset >= data.size()) {
+                ++payloadIndex;
+                payloadOffset = 0;
+            }
+        }
+
+        if (best.score > 0) {
+            segments.push_back(best);
+
+            const unsigned char* segmentData = payloads[best.payloadIndex].data.data() + best.offset;
+            for (std::size_t i=0 ; i + dmerSize <= best.size ; ++i) {
+                statistics.erase(loadDmer(segmentData + i));
+            }
+        }
+    }
+
+    std::stable_sort(
+        segments.begin(),
+        segments.end(),
+        [](const Segment& a, const Segment& b) {
+            return a.score < b.score;
+        }
+    );
+
+    std::vector<unsigned char> result;
+    for (const Segment& segment : segments) {
+        const unsigned char* segmentData = payloads[segment.payloadIndex].data.data() + segment.offset;
+        result.insert(result.end(), segmentData, segmentData + segment.size);
+    }
+
+    if (result.size() > dictionarySize) {
+        result.erase(result.begin(), result.end() - dictionarySize);
+    }
+
+    return result;
+}
+
 
 /**
- * Function that parses a single input file and dumps its contents.
+ * Function that trains a dictionary, shared by every payload, for the selected codec.
  *
- * \param[in] inputStream        The input stream to be parsed.
+ * \param[in]  payloads            The payloads to train on.
  *
- * \param[in] outputStream       The name of the output file.  An empty string indicates stdout.
+ * \param[in]  compressionSettings The compression settings.
  *
- * \param[in] leftIndentation    Additional left side indentation.
- *
- * \param[in] indentation        The desired indentation in spaces.
+ * \param[out] dictionary          The trained dictionary.
  *
- * \param[in] width              The desired maximum line width.
+ * \return Returns true on success.  Returns false on error.
+ */
+bool trainDictionary(
+        const std::vector<Payload>& payloads,
+        const CompressionSettings&  compressionSettings,
+        std::vector<unsigned char>& dictionary
+    ) {
+    bool success = true;
+
+    if (compressionSettings.codec == Codec::ZSTD) {
+        #if (defined(HAVE_ZSTD))
+
+            std::vector<unsigned char> samples;
+            std::vector<std::size_t>   sampleSizes;
+            for (const Payload& payload : payloads) {
+                samples.insert(samples.end(), payload.data.begin(), payload.data.end());
+                sampleSizes.push_back(payload.data.size());
+            }
+
+            dictionary.resize(static_cast<std::size_t>(compressionSettings.sharedDictionarySize));
+            std::size_t result = ZDICT_trainFromBuffer(
+                dictionary.data(),
+                dictionary.size(),
+                samples.data(),
+                sampleSizes.data(),
+                static_cast<unsigned>(sampleSizes.size())
+            );
+
+            if (ZDICT_isError(result)) {
+                std::cerr << "*** Could not train a zstd dictionary: " << ZDICT_getErrorName(result) << std::endl;
+                success = false;
+            } else {
+                dictionary.resize(result);
+            }
+
+        #else
+
+            std::cerr << "*** Zstandard support was not included in this build." << std::endl;
+            success = false;
+
+        #endif
+    } else {
+        dictionary = trainDeflateDictionary(
+            payloads,
+            static_cast<std::size_t>(std::min(compressionSettings.sharedDictionarySize, 32768ULL))
+        );
+    }
+
+    return success;
+}
+
+
+/**
+ * Function that reads sample blocks from an input.  The input is divided into equal strata and one block is read from
+ * a random position within each stratum.  Only the sampled blocks are read from input files.
  *
- * \param[in] prefix             An optional prefix in front of each variable name.
+ * \param[in]  inputFilename  The input filename.  An empty filename indicates stdin.
  *
- * \param[in] variableName       The payload variable name or suffix.
+ * \param[in]  blockSize      The size of each sample block, in bytes.
  *
- * \param[in] variableType       The variable type for the payload contents.
+ * \param[in]  maximumSamples The maximum number of blocks to sample.
  *
- * \param[in] sizeVariableName   The size variable name or suffix.
+ * \param[out] samples        The sampled blocks.
  *
- * \param[in] sizeVariableType   The size variable type.
+ * \param[out] numberBlocks   The number of blocks in the input.
  *
- * \param[in] zlibCompress       Flag holding true if we should run the payload through the Qt compressor.
+ * \param[out] inputSize      The size of the input, in bytes.
  *
  * \return Returns true on success.  Returns false on error.
  */
-bool parseAndDumpInput(
-        std::istream&      inputStream,
-        std::ostream&      outputStream,
-        unsigned           leftIndentation,
-        unsigned           indentation,
-        unsigned           width,
-        const std::string& prefix,
-        const std::string& variableName,
-        const std::string& variableType,
-        const std::string& sizeVariableName,
-        const std::string& sizeVariableType,
-        bool               zlibCompress
+bool readSamples(
+        const std::string&                       inputFilename,
+        std::size_t                              blockSize,
+        std::size_t                              maximumSamples,
+        std::vector<std::vector<unsigned char>>& samples,
+        unsigned long long&                      numberBlocks,
+        unsigned long long&                      inputSize
     ) {
+    bool                       success = true;
     std::vector<unsigned char> inputBuffer;
-    while (inputStream) {
-        unsigned char readData;
-        inputStream.read(reinterpret_cast<char*>(&readData), 1);
-        inputBuffer.push_back(readData);
-    }
+    std::ifstream              inputStream;
 
-    QByteArray byteArray(reinterpret_cast<const char*>(inputBuffer.data()), static_cast<int>(inputBuffer.size()));
-    QByteArray outputData = zlibCompress ? qCompress(byteArray, 9) : byteArray;
+    samples.clear();
+    inputSize = 0;
 
-    std::string leftIndentationString;
-    for (unsigned column=0 ; column<leftIndentation ; ++column) {
-        leftIndentationString += " ";
+    if (inputFilename.empty()) {
+        success = readInput(std::cin, inputBuffer);
+        if (success) {
+            inputSize = inputBuffer.size();
+        } else {
+            std::cerr << "*** Error reading input." << std::endl;
+        }
+    } else {
+        inputStream.open(inputFilename, std::ios::binary | std::ios::ate);
+        if (inputStream) {
+            inputSize = static_cast<unsigned long long>(inputStream.tellg());
+        } else {
+            std::cerr << "*** Could not open input file " << inputFilename << std::endl;
+            success = false;
+        }
     }
 
-    std::string contentsIndentationString;
-    for (unsigned column=0 ; column<(leftIndentation + indentation) ; ++column) {
-        contentsIndentationString += " ";
+    numberBlocks = (inputSize + blockSize - 1) / blockSize;
+
+    std::size_t  numberSamples = static_cast<std::size_t>(std::min<unsigned long long>(numberBlocks, maximumSamples));
+    std::mt19937 generator(1);
+    for (std::size_t sampleIndex=0 ; success && sampleIndex<numberSamples ; ++sampleIndex) {
+        unsigned long long firstBlock = numberBlocks * sampleIndex / numberSamples;
+        unsigned long long endBlock   = numberBlocks * (sampleIndex + 1) / numberSamples;
+        unsigned long long block      = firstBlock + generator() % (endBlock - firstBlock);
+        unsigned long long offset     = block * blockSize;
+        std::size_t        length     = static_cast<std::size_t>(
+            std::min<unsigned long long>(blockSize, inputSize - offset)
+        );
+
+        samples.push_back(std::vector<unsigned char>(length));
+        if (inputFilename.empty()) {
+            std::copy(inputBuffer.begin() + offset, inputBuffer.begin() + offset + length, samples.back().begin());
+        } else {
+            inputStream.seekg(static_cast<std::streamoff>(offset));
+            inputStream.read(reinterpret_cast<char*>(samples.back().data()), static_cast<std::streamsize>(length));
+            if (!inputStream) {
+                std::cerr << "*** Error reading input file " << inputFilename << std::endl;
+                success = false;
+            }
+        }
     }
 
-    unsigned long numberBytes = outputData.size();
+    return success;
+}
 
-    outputStream << leftIndentationString << variableType << " "
-                 << prefix << variableName << "[" << numberBytes << "] = {";
 
-    unsigned valuesPerLine  = (width - indentation - leftIndentation + 1) / 6;
-    unsigned valuesThisLine = valuesPerLine;
-    for (unsigned long i=0 ; i<numberBytes ; ++i) {
-        if (valuesThisLine >= valuesPerLine) {
-            outputStream << std::endl << contentsIndentationString;
-            valuesThisLine = 1;
-        } else {
-            ++valuesThisLine;
+/**
+ * Function that calculates the size of the source text generated by \ref dumpByteArray for an array, excluding the
+ * declaration.
+ *
+ * \param[in] numberBytes     The number of bytes in the array.
+ *
+ * \param[in] leftIndentation Additional left side indentation.
+ *
+ * \param[in] indentation     The desired indentation in spaces.
+ *
+ * \param[in] width           The desired maximum line width.
+ *
+ * \return Returns the size of the source text, in bytes.
+ */
+unsigned long long byteArrayTextSize(
+        unsigned long long numberBytes,
+        unsigned           leftIndentation,
+        unsigned           indentation,
+        unsigned           width
+    ) {
+    unsigned long long valuesPerLine = std::max(1U, (width - indentation - leftIndentation + 1) / 6);
+    unsigned long long numberLines   = (numberBytes + valuesPerLine - 1) / valuesPerLine;
+
+    return numberBytes * 6 + numberLines * (1 + leftIndentation + indentation);
+}
+
+
+/**
+ * Function that estimates, for every available codec, the compressed size, generated source size and compile time of
+ * each input without compressing the entire input.  Up to 64 sample blocks are compressed with each codec on every
+ * worker thread and the results are projected to the full input along with a 95% confidence interval.  The report is
+ * written to stdout.
+ *
+ * \param[in] inputs              The list of input files.  An empty list indicates stdin.
+ *
+ * \param[in] leftIndentation     The left side indentation of the generated arrays.
+ *
+ * \param[in] indentation         The desired indentation in spaces.
+ *
+ * \param[in] width               The desired maximum line width.
+ *
+ * \param[in] compressionSettings The compression settings.  Settings for the selected codec are used as is, other
+ *                                codecs use their default level.
+ *
+ * \param[in] outputSettings      The output settings.  When chunking, the chunk size is used as the sample block
+ *                                size.
+ *
+ * \return Returns true on success.  Returns false on error.
+ */
+bool estimatePayloads(
+        const std::vector<std::string>& inputs,
+        unsigned                        leftIndentation,
+        unsigned                        indentation,
+        unsigned                        width,
+        const CompressionSettings&      compressionSettings,
+        const OutputSettings&           outputSettings
+    ) {
+    // Nominal rate at which compilers process array initializers, measured with GCC.  Real compilers vary widely.
+    const double elementsCompiledPerSecond = 5.0e5;
+    const std::size_t maximumSamples       = 64;
+    const std::size_t blockSize            = (
+          outputSettings.chunkSize > 0
+        ? static_cast<std::size_t>(outputSettings.chunkSize)
+        : static_cast<std::size_t>(65536)
+    );
+
+    std::vector<CompressionSettings> candidates;
+    for (Codec codec : { Codec::NONE, Codec::QT_ZLIB, Codec::ZSTD, Codec::LZ4, Codec::XZ }) {
+        if (isSupported(codec)) {
+            CompressionSettings candidate = compressionSettings;
+            if (codec != compressionSettings.codec) {
+                candidate.codec            = codec;
+                candidate.level            = -1;
+                candidate.numberIterations = 0;
+            }
+
+            if (codec == Codec::XZ && candidate.dictionarySize == 0) {
+                // A dictionary larger than a sample block only costs memory and time.
+                candidate.dictionarySize = std::max<unsigned long long>(blockSize, 4096);
+            }
+
+            candidate.numberThreads = 0;
+            candidates.push_back(candidate);
         }
+    }
+
+    std::vector<std::string> inputFilenames = inputs;
+    if (inputFilenames.empty()) {
+        inputFilenames.push_back(std::string());
+    }
 
-        unsigned char v = outputData.at(i);
+    bool success = true;
+    std::vector<std::string>::const_iterator inputIterator    = inputFilenames.cbegin();
+    std::vector<std::string>::const_iterator inputEndIterator = inputFilenames.cend();
+    while (success && inputIterator != inputEndIterator) {
+        const std::string& inputFilename = *inputIterator;
 
-        char buffer[6];
-        sprintf(buffer, "0x%02X", static_cast<unsigned>(v));
-        outputStream << buffer;
+        std::vector<std::vector<unsigned char>> samples;
+        unsigned long long                      numberBlocks;
+        unsigned long long                      inputSize;
+        success = readSamples(inputFilename, blockSize, maximumSamples, samples, numberBlocks, inputSize);
 
-        if (i < (numberBytes - 1)) {
-            outputStream << ", ";
+        if (success) {
+            std::size_t                     numberTasks = samples.size() * candidates.size();
+            std::vector<unsigned long long> compressedSizes(numberTasks);
+            std::atomic<std::size_t>        nextTask(0);
+            std::atomic<bool>               tasksSucceeded(true);
+
+            auto worker = [&]() {
+                std::size_t taskIndex = nextTask++;
+                while (tasksSucceeded && taskIndex < numberTasks) {
+                    std::vector<unsigned char> noDictionary;
+                    std::vector<unsigned char> outputBuffer;
+                    if (compressPayload(
+                            samples[taskIndex % samples.size()],
+                            candidates[taskIndex / samples.size()],
+                            noDictionary,
+                            outputBuffer
+                        )) {
+                        compressedSizes[taskIndex] = outputBuffer.size();
+                    } else {
+                        tasksSucceeded = false;
+                    }
+
+                    taskIndex = nextTask++;
+                }
+            };
+
+            std::size_t numberThreads = std::min<std::size_t>(compressionSettings.numberThreads, numberTasks);
+            std::vector<std::thread> threads;
+            for (std::size_t i=1 ; i<numberThreads ; ++i) {
+                threads.push_back(std::thread(worker));
+            }
+
+            worker();
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            success = tasksSucceeded;
+
+            std::cout << (inputFilename.empty() ? "stdin" : inputFilename) << ": " << inputSize << " bytes, "
+                      << samples.size() << " of " << numberBlocks << " blocks of " << blockSize << " bytes sampled"
+                      << std::endl;
+
+            for (std::size_t candidateIndex=0 ; success && candidateIndex<candidates.size() ; ++candidateIndex) {
+                const CompressionSettings& candidate = candidates[candidateIndex];
+
+                unsigned long long sampledBytes    = 0;
+                unsigned long long compressedBytes = 0;
+                for (std::size_t sampleIndex=0 ; sampleIndex<samples.size() ; ++sampleIndex) {
+                    sampledBytes    += samples[sampleIndex].size();
+                    compressedBytes += compressedSizes[candidateIndex * samples.size() + sampleIndex];
+                }
+
+                double ratio = sampledBytes > 0 ? static_cast<double>(compressedBytes) / sampledBytes : 1.0;
+
+                // The confidence interval treats the per-block ratios as a sample drawn without replacement from the
+                // blocks of the input.
+                double variance = 0;
+                for (std::size_t sampleIndex=0 ; sampleIndex<samples.size() ; ++sampleIndex) {
+                    double blockRatio = (
+                          static_cast<double>(compressedSizes[candidateIndex * samples.size() + sampleIndex])
+                        / samples[sampleIndex].size()
+                    );
+
+                    variance += (blockRatio - ratio) * (blockRatio - ratio);
+                }
+
+                double interval = 0;
+                if (samples.size() > 1 && numberBlocks > 1) {
+                    variance /= samples.size() - 1;
+                    double populationCorrection = (
+                          static_cast<double>(numberBlocks - samples.size())
+                        / static_cast<double>(numberBlocks - 1)
+                    );
+
+                    interval = 1.96 * std::sqrt(variance / samples.size() * populationCorrection);
+                }
+
+                unsigned long long projectedBytes = static_cast<unsigned long long>(ratio * inputSize + 0.5);
+                unsigned long long textBytes      = byteArrayTextSize(
+                    projectedBytes,
+                    leftIndentation,
+                    indentation,
+                    width
+                );
+
+                std::cout << "    " << std::left << std::setw(6) << toString(candidate.codec) << std::right
+                          << std::setw(16) << projectedBytes << " bytes"
+                          << std::fixed << std::setprecision(1)
+                          << std::setw(7) << 100.0 * ratio << "% +/- " << std::setw(4) << 100.0 * interval << "%"
+                          << std::setw(10) << textBytes / (1024.0 * 1024.0) << " MiB source"
+                          << std::setw(9) << projectedBytes / elementsCompiledPerSecond << " s compile"
+                          << std::defaultfloat << std::endl;
+            }
         }
+
+        ++inputIterator;
     }
 
-    outputStream << std::endl
-                 << leftIndentationString << "};" << std::endl
+    return success;
+}
+
+
+/**
+ * Function that dumps a registry of every payload's accessor along with the function that prefetches them.
+ *
+ * \param[in] outputStream     The stream to receive the generated output.
+ *
+ * \param[in] leftIndentation  Additional left side indentation.
+ *
+ * \param[in] indentation      The desired indentation in spaces.
+ *
+ * \param[in] variableName     The payload variable name or suffix.
+ *
+ * \param[in] sizeVariableType The size variable type.
+ *
+ * \param[in] payloads         The payloads, in output order.
+ */
+void dumpRegistry(
+        std::ostream&               outputStream,
+        unsigned                    leftIndentation,
+        unsigned                    indentation,
+        const std::string&          variableName,
+        const std::string&          sizeVariableType,
+        const std::vector<Payload>& payloads
+    ) {
+    std::string leftIndentationString(leftIndentation, ' ');
+    std::string contentsIndentationString(leftIndentation + indentation, ' ');
+
+    outputStream << leftIndentationString << "// Registry of every payload:" << std::endl
+                 << leftIndentationString << "static const BuildPayload::RegistryEntry " << variableName
+                 << "Registry[" << payloads.size() << "] = {" << std::endl;
+
+    for (std::size_t index=0 ; index<payloads.size() ; ++index) {
+        const Payload& payload  = payloads[index];
+        std::string    name     = payload.prefix + variableName;
+        std::string    baseName = toBaseName(payload.filename);
+
+        outputStream << contentsIndentationString << "{ " << toStringLiteral(baseName.empty() ? name : baseName)
+                     << ", " << name << "Get, " << name << "State }"
+                     << (index + 1 < payloads.size() ? "," : "") << std::endl;
+    }
+
+    outputStream << leftIndentationString << "};" << std::endl
                  << std::endl
-                 << leftIndentationString << sizeVariableType << " " << prefix << sizeVariableName
-                 << " = " << numberBytes << ";" << std::endl
+                 << leftIndentationString << sizeVariableType << " " << variableName << "NumberPayloads = "
+                 << payloads.size() << ";" << std::endl
                  << std::endl;
 
-    return true;
+    dumpCode(
+        outputStream,
+        leftIndentation,
+        indentation,
+        (
+              "/**\n"
+              " * Function that starts decompressing every payload on background threads.  Call it right after\n"
+              " * startup.  Payloads named in the priority list, by input filename less any directory, are\n"
+              " * decompressed first.  A thread count of 0 selects one thread per core.  Keep the returned object\n"
+              " * alive while prefetching should continue.\n"
+              " */\n"
+              "static inline BuildPayload::Prefetch " + variableName + "PrefetchAll(\n"
+              "        std::initializer_list<const char*> priority = {},\n"
+              "        unsigned                           numberThreads = 0\n"
+              "    ) {\n"
+              "    return BuildPayload::Prefetch(\n"
+              "        " + variableName + "Registry,\n"
+              "        " + variableName + "NumberPayloads,\n"
+              "        priority,\n"
+              "        numberThreads\n"
+              "    );\n"
+              "}\n"
+              "\n"
+        ).c_str()
+    );
 }
 
 
@@ -140,6 +8947,8 @@ bool parseAndDumpInput(
  *
  * \param[in] inputs             The list of input files.  An empty list indicates stdin.
  *
+ * \param[in] baselines          The baseline paired with each input.  An empty list indicates no delta encoding.
+ *
  * \param[in] outputStream       The stream to receive the generated output.
  *
  * \param[in] description        An optional description to place below the copyright message.
@@ -162,12 +8971,15 @@ bool parseAndDumpInput(
  *
  * \param[in] sizeVariableType   The size variable type.
  *
- * \param[in] zlibCompress       Flag holding true if we should run the payload through the Qt compressor.
+ * \param[in] compressionSettings The compression settings to apply to each payload.
+ *
+ * \param[in] outputSettings     Settings controlling how the payloads are laid out.
  *
  * \return Returns true on success.  Returns false on error.
  */
 bool buildPayloadHelper(
         const std::vector<std::string>& inputs,
+        const std::vector<std::string>& baselines,
         std::ostream&                   outputStream,
         const std::string&              description,
         const std::string&              copyrightMessage,
@@ -179,7 +8991,8 @@ bool buildPayloadHelper(
         const std::string&              variableType,
         const std::string&              sizeVariableName,
         const std::string&              sizeVariableType,
-        bool                            zlibCompress
+        const CompressionSettings&      compressionSettings,
+        const OutputSettings&           outputSettings
     ) {
     bool success = true;
 
@@ -206,121 +9019,339 @@ bool buildPayloadHelper(
             outputStream << "//**" << std::endl;
         }
 
-        if (!description.empty()) {
-            outputStream << "* \\file" << std::endl
-                         << "*" << std::endl;
+        if (!description.empty()) {
+            outputStream << "* \\file" << std::endl
+                         << "*" << std::endl;
+
+            std::istringstream descriptionStream(description);
+            std::string        descriptionLine;
+            while (std::getline(descriptionStream, descriptionLine)) {
+                outputStream << "* " << descriptionLine << std::endl;
+            }
+        }
+
+        for (unsigned column=1 ; column<=(width-1) ; ++column) {
+            outputStream << "*";
+        }
+        outputStream << "/" << std::endl
+                     << std::endl;
+    }
+
+    std::vector<Payload> payloads;
+    success = loadPayloads(inputs, payloads);
+
+    // Inputs paired with a baseline are replaced by a delta against the baseline ahead of compression.
+    if (success && !baselines.empty()) {
+        success = encodeDeltas(baselines, payloads);
+    }
+
+    // Payloads are placed in first access order so startup touches as few pages as possible.
+    if (!outputSettings.profile.empty()) {
+        orderPayloads(outputSettings.profile, variableName, payloads);
+    }
+
+    // Inputs with identical contents are compressed and emitted once, later copies become aliases.
+    findDuplicatePayloads(payloads);
+
+    std::vector<unsigned char> dictionary;
+    if (success && compressionSettings.sharedDictionarySize > 0) {
+        success = trainDictionary(payloads, compressionSettings, dictionary);
+    }
+
+    // In solid mode the inputs are folded into a single payload, keeping only their names and lengths.
+    std::vector<std::string>        solidNames;
+    std::vector<unsigned long long> solidOffsets;
+    std::vector<unsigned long long> solidLengths;
+    CompressionSettings             payloadCompressionSettings = compressionSettings;
+    if (success && outputSettings.solid) {
+        Payload solidPayload;
+        solidPayload.originalIndex = 0;
+
+        for (Payload& payload : payloads) {
+            solidNames.push_back(toBaseName(payload.filename));
+            if (payload.originalIndex == solidOffsets.size()) {
+                solidOffsets.push_back(solidPayload.data.size());
+                solidLengths.push_back(payload.data.size());
+                solidPayload.data.insert(solidPayload.data.end(), payload.data.begin(), payload.data.end());
+                std::vector<unsigned char>().swap(payload.data);
+            } else {
+                solidOffsets.push_back(solidOffsets[payload.originalIndex]);
+                solidLengths.push_back(solidLengths[payload.originalIndex]);
+            }
+        }
+
+        payloads.clear();
+        payloads.push_back(std::move(solidPayload));
+
+        payloadCompressionSettings.includeMetadata = true;
+    }
+
+    // The apply function needs the size of the delta ahead of decompressing it.
+    if (!baselines.empty()) {
+        payloadCompressionSettings.includeMetadata = true;
+    }
+
+    // Accessors allocate their buffer from the uncompressed size.
+    if (outputSettings.accessors || outputSettings.decompressInto || outputSettings.stream || outputSettings.cache) {
+        payloadCompressionSettings.includeMetadata = true;
+    }
+
+    std::vector<Codec> codecs;
+    for (std::size_t index=0 ; index<payloads.size() ; ++index) {
+        Payload&    payload = payloads[index];
+        std::string label   = payload.filename.empty() ? (outputSettings.solid ? "solid payload" : "stdin")
+                                                       : payload.filename;
+
+        if (payload.originalIndex != index) {
+            payload.compressionSettings = payloads[payload.originalIndex].compressionSettings;
+        } else if (success                                  &&
+            compressionSettings.storeIncompressible         &&
+            compressionSettings.codec != Codec::NONE        &&
+            isIncompressible(payload.data)                     ) {
+            std::cerr << label << " appears incompressible and will be stored uncompressed." << std::endl;
+
+            payload.compressionSettings                 = payloadCompressionSettings;
+            payload.compressionSettings.codec           = Codec::NONE;
+            payload.compressionSettings.level           = 0;
+            payload.compressionSettings.includeMetadata = true;
+            payload.compressionSettings.filters.clear();
+        } else if (success && compressionSettings.autoCodec) {
+            payloadCompressionSettings.includeMetadata = true;
+            success = chooseCompressionSettings(
+                label,
+                payload.data,
+                payloadCompressionSettings,
+                payload.compressionSettings
+            );
+        } else {
+            payload.compressionSettings = payloadCompressionSettings;
+        }
+
+        if (std::find(codecs.begin(), codecs.end(), payload.compressionSettings.codec) == codecs.end()) {
+            codecs.push_back(payload.compressionSettings.codec);
+        }
+    }
+
+    if (std::find(codecs.begin(), codecs.end(), Codec::LZ4) != codecs.end()) {
+        dumpLz4Runtime(outputStream, indentation);
+    }
+
+    if (!compressionSettings.filters.empty()) {
+        dumpFilterRuntime(outputStream, indentation);
+    }
+
+    if (outputSettings.chunkSize > 0) {
+        dumpChunkedRuntime(outputStream, indentation, codecs);
+    }
+
+    if (outputSettings.cdcAverageSize > 0) {
+        dumpChunkStoreRuntime(outputStream, indentation, codecs);
+    }
+
+    if (outputSettings.alignment > 0) {
+        dumpAdviceRuntime(outputStream, indentation);
+    }
+
+    if (outputSettings.sections || !outputSettings.profile.empty()) {
+        dumpSectionRuntime(outputStream, indentation);
+    }
+
+    if (outputSettings.recordProfile) {
+        dumpProfileRuntime(outputStream, indentation);
+    }
+
+    if (!baselines.empty()) {
+        dumpDeltaRuntime(outputStream, indentation, codecs);
+    }
+
+    if (outputSettings.accessors) {
+        dumpAccessorRuntime(outputStream, indentation, codecs);
+
+        if (outputSettings.prefetch) {
+            dumpPrefetchRuntime(outputStream, indentation);
+        }
+    } else if (outputSettings.decompressInto) {
+        for (Codec codec : codecs) {
+            dumpChunkDecoder(outputStream, indentation, codec);
+        }
+    }
+
+    if (outputSettings.cache) {
+        dumpCacheRuntime(outputStream, indentation, codecs);
+    }
+
+    if (outputSettings.stream) {
+        dumpStreamRuntime(outputStream, indentation, codecs, outputSettings);
+    }
+
+    bool decodesPayloads = (
+           outputSettings.accessors
+        || outputSettings.decompressInto
+        || outputSettings.stream
+        || outputSettings.cache
+    );
+
+    if (decodesPayloads && !dictionary.empty()) {
+        dumpDictionaryRuntime(outputStream, indentation, codecs);
+    }
+
+    if (outputSettings.solid) {
+        dumpSolidRuntime(outputStream, indentation);
+    }
+
+    if (outputSettings.packed) {
+        dumpPackedRuntime(outputStream, indentation);
 
-            std::istringstream descriptionStream(description);
-            std::string        descriptionLine;
-            while (std::getline(descriptionStream, descriptionLine)) {
-                outputStream << "* " << descriptionLine << std::endl;
-            }
+        if (outputSettings.perfectHash) {
+            dumpPerfectHashRuntime(outputStream, indentation);
         }
 
-        for (unsigned column=1 ; column<=(width-1) ; ++column) {
-            outputStream << "*";
+        for (Codec codec : codecs) {
+            dumpChunkDecoder(outputStream, indentation, codec);
         }
-        outputStream << "/" << std::endl
-                     << std::endl;
     }
 
     unsigned leftIndentation = 0;
     if (!namespaceName.empty()) {
-        outputStream << "namespace " << namespaceName << "{" << std::endl;
+        outputStream << "namespace " << namespaceName << " {" << std::endl;
         leftIndentation = indentation;
     }
 
-    if (inputs.empty()) {
-        success = parseAndDumpInput(
-            std::cin,
+    if (success && !dictionary.empty()) {
+        std::string leftIndentationString(leftIndentation, ' ');
+
+        outputStream << leftIndentationString << "// Dictionary shared by every payload:" << std::endl;
+        dumpByteArray(
             outputStream,
             leftIndentation,
             indentation,
             width,
-            "",
-            variableName,
-            variableType,
-            sizeVariableName,
-            sizeVariableType,
-            zlibCompress
+            variableType + " " + variableName + "Dictionary",
+            dictionary,
+            0,
+            std::string()
         );
+
+        outputStream << leftIndentationString << sizeVariableType << " " << variableName << "DictionarySize = "
+                     << dictionary.size() << ";" << std::endl
+                     << std::endl;
+    }
+
+    if (outputSettings.packed) {
+        if (success) {
+            success = compressAndDumpPacked(
+                outputStream,
+                leftIndentation,
+                indentation,
+                width,
+                variableName,
+                variableType,
+                sizeVariableType,
+                payloads,
+                outputSettings
+            );
+        }
+    } else if (outputSettings.cdcAverageSize > 0) {
+        if (success) {
+            success = compressAndDumpChunkStore(
+                outputStream,
+                leftIndentation,
+                indentation,
+                width,
+                variableName,
+                variableType,
+                sizeVariableType,
+                payloads,
+                payloadCompressionSettings,
+                outputSettings
+            );
+        }
     } else {
-        if (inputs.size() == 1) {
-            std::ifstream inputStream(inputs.at(0), std::ios::binary);
+        // Compressed payloads are kept only while a later duplicate may still refer to them.
+        std::vector<std::size_t> lastReferences(payloads.size());
+        for (std::size_t index=0 ; index<payloads.size() ; ++index) {
+            lastReferences[payloads[index].originalIndex] = index;
+        }
 
-            if (inputStream) {
-                success = parseAndDumpInput(
-                    inputStream,
+        std::vector<CompressedPayload> compressedPayloads(payloads.size());
+        for (std::size_t index=0 ; success && index<payloads.size() ; ++index) {
+            const Payload& payload  = payloads[index];
+            const Payload& original = payloads[payload.originalIndex];
+            bool           isAlias  = (payload.originalIndex != index);
+
+            if (!payload.prefix.empty()) {
+                outputStream << std::string(leftIndentation, ' ') << "// Contents of " << payload.filename;
+                if (isAlias) {
+                    outputStream << ", identical to " << original.filename;
+                }
+
+                outputStream << ":" << std::endl;
+            }
+
+            success = compressAndDumpPayload(
+                outputStream,
+                leftIndentation,
+                indentation,
+                width,
+                payload.prefix,
+                variableName,
+                variableType,
+                sizeVariableName,
+                sizeVariableType,
+                original.data,
+                payload.compressionSettings,
+                dictionary,
+                outputSettings,
+                isAlias ? original.prefix : std::string(),
+                compressedPayloads[payload.originalIndex]
+            );
+
+            if (success && !baselines.empty()) {
+                dumpDeltaAccessor(
                     outputStream,
                     leftIndentation,
                     indentation,
-                    width,
-                    "",
+                    payload,
                     variableName,
-                    variableType,
                     sizeVariableName,
-                    sizeVariableType,
-                    zlibCompress
+                    sizeVariableType
                 );
-
-                inputStream.close();
-            } else {
-                std::cerr << "*** Could not open input file " << inputs.at(0) << std::endl;
-                success = false;
             }
-        } else {
-            std::vector<std::string>::const_iterator inputIterator    = inputs.cbegin();
-            std::vector<std::string>::const_iterator inputEndIterator = inputs.cend();
-            while (success && inputIterator != inputEndIterator) {
-                std::string inputFilename = *inputIterator;
-                std::ifstream inputStream(inputFilename, std::ios::binary);
-
-                if (inputStream) {
-                    std::size_t forwardSlashPosition = inputFilename.rfind('/');
-                    std::size_t backslashPosition    = inputFilename.rfind('\\');
-
-                    std::string prefix;
-                    if (forwardSlashPosition != std::string::npos) {
-                        if (backslashPosition != std::string::npos) {
-                            std::size_t slashPosition = std::max(forwardSlashPosition, backslashPosition);
-                            prefix = inputFilename.substr(slashPosition + 1);
-                        } else {
-                            prefix = inputFilename.substr(forwardSlashPosition + 1);
-                        }
-                    } else {
-                        if (backslashPosition != std::string::npos) {
-                            prefix = inputFilename.substr(backslashPosition + 1);
-                        } else {
-                            prefix = inputFilename;
-                        }
-                    }
 
-                    std::replace(prefix.begin(), prefix.end(), '.', '_');
+            if (lastReferences[payload.originalIndex] == index) {
+                compressedPayloads[payload.originalIndex] = CompressedPayload();
+            }
+        }
+    }
 
-                    outputStream << "// Contents of " << inputFilename << ":" << std::endl;
+    if (success && outputSettings.solid) {
+        std::string leftIndentationString(leftIndentation, ' ');
+        std::string contentsIndentationString(leftIndentation + indentation, ' ');
 
-                    success = parseAndDumpInput(
-                        inputStream,
-                        outputStream,
-                        leftIndentation,
-                        indentation,
-                        width,
-                        prefix,
-                        variableName,
-                        variableType,
-                        sizeVariableName,
-                        sizeVariableType,
-                        zlibCompress
-                    );
+        outputStream << leftIndentationString << "// Table locating each input within " << variableName << ":"
+                     << std::endl
+                     << leftIndentationString << "static const BuildPayload::SolidEntry " << variableName
+                     << "Entries[" << solidNames.size() << "] = {" << std::endl;
 
-                    inputStream.close();
-                    ++inputIterator;
-                } else {
-                    std::cerr << "*** Could not open input file " << inputs.at(0) << std::endl;
-                    success = false;
-                }
-            }
+        for (std::size_t index=0 ; index<solidNames.size() ; ++index) {
+            outputStream << contentsIndentationString << "{ " << toStringLiteral(solidNames[index]) << ", "
+                         << solidOffsets[index] << "UL, " << solidLengths[index] << "UL }"
+                         << (index + 1 < solidNames.size() ? "," : "") << std::endl;
         }
+
+        outputStream << leftIndentationString << "};" << std::endl
+                     << std::endl
+                     << leftIndentationString << sizeVariableType << " " << variableName << "NumberEntries = "
+                     << solidNames.size() << ";" << std::endl
+                     << std::endl;
+    }
+
+    if (success && outputSettings.prefetch) {
+        dumpRegistry(outputStream, leftIndentation, indentation, variableName, sizeVariableType, payloads);
+    }
+
+    if (!namespaceName.empty()) {
+        outputStream << "}" << std::endl;
     }
 
     return success;
@@ -332,6 +9363,8 @@ bool buildPayloadHelper(
  *
  * \param[in] inputs             The list of input files.  An empty list indicates stdin.
  *
+ * \param[in] baselines          The baseline paired with each input.  An empty list indicates no delta encoding.
+ *
  * \param[in] outputFilename     The name of the output file.  An empty string indicates stdout.
  *
  * \param[in] description        An optional description to place below the copyright message.
@@ -354,12 +9387,15 @@ bool buildPayloadHelper(
  *
  * \param[in] sizeVariableType   The size variable type.
  *
- * \param[in] zlibCompress       Flag holding true if we should run the payload through the Qt compressor.
+ * \param[in] compressionSettings The compression settings to apply to each payload.
+ *
+ * \param[in] outputSettings     Settings controlling how the payloads are laid out.
  *
  * \return Returns true on success.  Returns false on error.
  */
 bool buildPayload(
         const std::vector<std::string>& inputs,
+        const std::vector<std::string>& baselines,
         const std::string&              outputFilename,
         const std::string&              description,
         const std::string&              copyrightMessage,
@@ -371,12 +9407,14 @@ bool buildPayload(
         const std::string&              variableType,
         const std::string&              sizeVariableName,
         const std::string&              sizeVariableType,
-        bool                            zlibCompress
+        const CompressionSettings&      compressionSettings,
+        const OutputSettings&           outputSettings
     ) {
     bool success;
     if (outputFilename.empty()) {
         success = buildPayloadHelper(
             inputs,
+            baselines,
             std::cout,
             description,
             copyrightMessage,
@@ -388,7 +9426,8 @@ bool buildPayload(
             variableType,
             sizeVariableName,
             sizeVariableType,
-            zlibCompress
+            compressionSettings,
+            outputSettings
         );
     } else {
         std::ofstream outputStream(outputFilename);
@@ -396,6 +9435,7 @@ bool buildPayload(
         if (outputStream) {
             success = buildPayloadHelper(
                 inputs,
+                baselines,
                 outputStream,
                 description,
                 copyrightMessage,
@@ -407,7 +9447,8 @@ bool buildPayload(
                 variableType,
                 sizeVariableName,
                 sizeVariableType,
-                zlibCompress
+                compressionSettings,
+                outputSettings
             );
 
             outputStream.close();
@@ -424,6 +9465,7 @@ bool buildPayload(
 int main(int argumentCount, char* argumentValues[]) {
     bool                     success          = true;
     bool                     helpRequested    = false;
+    bool                     estimateRequested = false;
     std::string              description;
     std::string              outputFilename;
     std::string              copyrightMessage = "Copyright 2020 Inesonic, LLC.\nAll rights reserved.";
@@ -435,8 +9477,38 @@ int main(int argumentCount, char* argumentValues[]) {
     std::string              variableType     = "static const unsigned char";
     std::string              sizeVariableName = "declarationsSize";
     std::string              sizeVariableType = "static const unsigned long";
-    bool                     useZlib          = true;
+    CompressionSettings      compressionSettings;
+    OutputSettings           outputSettings;
     std::vector<std::string> inputs;
+    std::vector<std::string> baselines;
+
+    compressionSettings.codec           = Codec::QT_ZLIB;
+    compressionSettings.level           = -1;
+    compressionSettings.numberThreads   = std::thread::hardware_concurrency();
+    compressionSettings.numberIterations = 0;
+    compressionSettings.longWindowLog   = 0;
+    compressionSettings.includeMetadata = false;
+    compressionSettings.extreme         = false;
+    compressionSettings.dictionarySize  = 0;
+    compressionSettings.branchFilter    = BranchFilter::NONE;
+    compressionSettings.sharedDictionarySize = 0;
+    compressionSettings.autoCodec       = false;
+    compressionSettings.measureTime     = false;
+    compressionSettings.storeIncompressible = false;
+
+    outputSettings.solid          = false;
+    outputSettings.packed         = false;
+    outputSettings.perfectHash    = false;
+    outputSettings.chunkSize      = 0;
+    outputSettings.cdcAverageSize = 0;
+    outputSettings.accessors      = false;
+    outputSettings.decompressInto = false;
+    outputSettings.stream         = false;
+    outputSettings.prefetch       = false;
+    outputSettings.cache          = false;
+    outputSettings.alignment      = 0;
+    outputSettings.sections       = false;
+    outputSettings.recordProfile  = false;
 
     unsigned argumentIndex = 1;
     while (success && !helpRequested && argumentIndex < static_cast<unsigned>(argumentCount)) {
@@ -528,9 +9600,211 @@ int main(int argumentCount, char* argumentValues[]) {
                 success = false;
             }
         } else if (argument == "-z" || argument == "--zlib") {
-            useZlib = true;
+            compressionSettings.codec = Codec::QT_ZLIB;
         } else if (argument == "-Z" || argument == "--no-zlib") {
-            useZlib = false;
+            compressionSettings.codec = Codec::NONE;
+        } else if (argument == "--zlib-max") {
+            compressionSettings.codec = Codec::QT_ZLIB;
+            if (compressionSettings.numberIterations == 0) {
+                compressionSettings.numberIterations = DeflateEncoder::defaultNumberIterations;
+            }
+        } else if (argument == "--iterations") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                compressionSettings.numberIterations = strtoul(argumentValues[argumentIndex], nullptr, 10);
+                if (compressionSettings.numberIterations <= 0) {
+                    std::cerr << "*** Invalid iteration count " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--codec") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!toCodec(argumentValues[argumentIndex], compressionSettings.codec)) {
+                    std::cerr << "*** Unknown codec " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                } else if (!isSupported(compressionSettings.codec)) {
+                    std::cerr << "*** Codec " << argumentValues[argumentIndex] << " was not included in this build."
+                              << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "-l" || argument == "--level") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                char* end;
+                compressionSettings.level = static_cast<int>(strtol(argumentValues[argumentIndex], &end, 10));
+                if (*end != '\0' || compressionSettings.level < 0) {
+                    std::cerr << "*** Invalid compression level " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--threads") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                compressionSettings.numberThreads = strtoul(argumentValues[argumentIndex], nullptr, 10);
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--long") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                compressionSettings.longWindowLog = strtoul(argumentValues[argumentIndex], nullptr, 10);
+                if (compressionSettings.longWindowLog < 10 || compressionSettings.longWindowLog > 31) {
+                    std::cerr << "*** Invalid long window " << argumentValues[argumentIndex]  << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--extreme") {
+            compressionSettings.extreme = true;
+        } else if (argument == "--dictionary-size") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!parseSize(argumentValues[argumentIndex], compressionSettings.dictionarySize) ||
+                    compressionSettings.dictionarySize < 4096                                     ||
+                    compressionSettings.dictionarySize > (1ULL << 30) * 3 / 2                        ) {
+                    std::cerr << "*** Invalid dictionary size " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--bcj") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!toBranchFilter(argumentValues[argumentIndex], compressionSettings.branchFilter)) {
+                    std::cerr << "*** Unknown branch filter " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--train-dictionary") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!parseSize(argumentValues[argumentIndex], compressionSettings.sharedDictionarySize) ||
+                    compressionSettings.sharedDictionarySize < 256                                         ) {
+                    std::cerr << "*** Invalid dictionary size " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--filter") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!toFilters(argumentValues[argumentIndex], compressionSettings.filters)) {
+                    std::cerr << "*** Invalid filter " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--auto-codec") {
+            compressionSettings.autoCodec = true;
+        } else if (argument == "--measure-time") {
+            compressionSettings.measureTime = true;
+        } else if (argument == "--store-incompressible") {
+            compressionSettings.storeIncompressible = true;
+        } else if (argument == "--estimate") {
+            estimateRequested = true;
+        } else if (argument == "--solid") {
+            outputSettings.solid = true;
+        } else if (argument == "--packed") {
+            outputSettings.packed = true;
+        } else if (argument == "--perfect-hash") {
+            outputSettings.packed      = true;
+            outputSettings.perfectHash = true;
+        } else if (argument == "--chunk-size") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!parseSize(argumentValues[argumentIndex], outputSettings.chunkSize) ||
+                    outputSettings.chunkSize < 1024                                     ||
+                    outputSettings.chunkSize > (1ULL << 30)                                ) {
+                    std::cerr << "*** Invalid chunk size " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--baseline") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                baselines.push_back(argumentValues[argumentIndex]);
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--cdc") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!parseSize(argumentValues[argumentIndex], outputSettings.cdcAverageSize) ||
+                    outputSettings.cdcAverageSize < 256                                      ||
+                    outputSettings.cdcAverageSize > (1ULL << 26)                                ) {
+                    std::cerr << "*** Invalid average chunk size " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--align") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                if (!parseSize(argumentValues[argumentIndex], outputSettings.alignment)        ||
+                    outputSettings.alignment < 4096                                            ||
+                    outputSettings.alignment > (1ULL << 21)                                    ||
+                    (outputSettings.alignment & (outputSettings.alignment - 1)) != 0              ) {
+                    std::cerr << "*** Invalid alignment " << argumentValues[argumentIndex] << std::endl;
+                    success = false;
+                }
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--sections") {
+            outputSettings.sections = true;
+        } else if (argument == "--record-profile") {
+            outputSettings.recordProfile = true;
+        } else if (argument == "--profile") {
+            if (remainingArguments > 0) {
+                ++argumentIndex;
+                success = loadProfile(argumentValues[argumentIndex], outputSettings.profile);
+            } else {
+                std::cerr << "*** The " << argument << " switch is missing a parameter." << std::endl;
+                success = false;
+            }
+        } else if (argument == "--accessors") {
+            outputSettings.accessors = true;
+        } else if (argument == "--decompress-into") {
+            outputSettings.decompressInto = true;
+        } else if (argument == "--stream") {
+            outputSettings.stream = true;
+        } else if (argument == "--cache") {
+            outputSettings.cache = true;
+        } else if (argument == "--prefetch") {
+            outputSettings.prefetch  = true;
+            outputSettings.accessors = true;
+        } else if (argument == "-m" || argument == "--metadata") {
+            compressionSettings.includeMetadata = true;
         } else {
             inputs.push_back(argument);
         }
@@ -538,6 +9812,105 @@ int main(int argumentCount, char* argumentValues[]) {
         ++argumentIndex;
     }
 
+    if (success                                       &&
+        compressionSettings.sharedDictionarySize > 0  &&
+        compressionSettings.codec != Codec::QT_ZLIB   &&
+        compressionSettings.codec != Codec::ZSTD         ) {
+        std::cerr << "*** The --train-dictionary switch requires the qt or zstd codec." << std::endl;
+        success = false;
+    }
+
+    if (success && outputSettings.solid && compressionSettings.sharedDictionarySize > 0) {
+        std::cerr << "*** The --solid and --train-dictionary switches can not be combined." << std::endl;
+        success = false;
+    }
+
+    if (success && outputSettings.chunkSize > 0 && compressionSettings.sharedDictionarySize > 0) {
+        std::cerr << "*** The --chunk-size and --train-dictionary switches can not be combined." << std::endl;
+        success = false;
+    }
+
+    if (success && compressionSettings.measureTime && !compressionSettings.autoCodec) {
+        std::cerr << "*** The --measure-time switch requires --auto-codec." << std::endl;
+        success = false;
+    }
+
+    if (success && compressionSettings.autoCodec && compressionSettings.sharedDictionarySize > 0) {
+        std::cerr << "*** The --auto-codec and --train-dictionary switches can not be combined." << std::endl;
+        success = false;
+    }
+
+    if (success                                          &&
+        outputSettings.cdcAverageSize > 0                &&
+        (outputSettings.solid                         ||
+         outputSettings.chunkSize > 0                 ||
+         compressionSettings.sharedDictionarySize > 0 ||
+         compressionSettings.autoCodec                ||
+         compressionSettings.storeIncompressible         )) {
+        std::cerr << "*** The --cdc switch can not be combined with --solid, --chunk-size, --train-dictionary, "
+                  << "--auto-codec or --store-incompressible." << std::endl;
+        success = false;
+    }
+
+    if (success && !baselines.empty() && baselines.size() != std::max<std::size_t>(inputs.size(), 1)) {
+        std::cerr << "*** Each input requires exactly one --baseline switch, supplied in input order." << std::endl;
+        success = false;
+    }
+
+    if (success                                          &&
+        !baselines.empty()                               &&
+        (outputSettings.solid                         ||
+         outputSettings.chunkSize > 0                 ||
+         outputSettings.cdcAverageSize > 0            ||
+         compressionSettings.sharedDictionarySize > 0    )) {
+        std::cerr << "*** The --baseline switch can not be combined with --solid, --chunk-size, --cdc or "
+                  << "--train-dictionary." << std::endl;
+        success = false;
+    }
+
+    bool decodesPayloads = (
+           outputSettings.accessors
+        || outputSettings.decompressInto
+        || outputSettings.stream
+        || outputSettings.cache
+    );
+
+    // Delta encoded payloads can only be rebuilt from a baseline the consumer supplies through the apply function.
+    if (success && decodesPayloads && !baselines.empty()) {
+        std::cerr << "*** The --accessors, --decompress-into, --stream and --cache switches can not be combined "
+                  << "with --baseline." << std::endl;
+        success = false;
+    }
+
+    if (success                                          &&
+        outputSettings.packed                            &&
+        (outputSettings.solid                         ||
+         outputSettings.chunkSize > 0                 ||
+         outputSettings.cdcAverageSize > 0            ||
+         compressionSettings.sharedDictionarySize > 0 ||
+         !baselines.empty()                           ||
+         decodesPayloads                              ||
+         outputSettings.recordProfile                    )) {
+        std::cerr << "*** The --packed switch can not be combined with --solid, --chunk-size, --cdc, "
+                  << "--train-dictionary, --baseline, --accessors, --decompress-into, --stream, --cache or "
+                  << "--record-profile." << std::endl;
+        success = false;
+    }
+
+    // Filters are undone one chunk at a time so streamed, filtered payloads are chunked to bound their memory.
+    if (success                                   &&
+        outputSettings.stream                     &&
+        !compressionSettings.filters.empty()      &&
+        outputSettings.chunkSize == 0             &&
+        outputSettings.cdcAverageSize == 0           ) {
+        if (compressionSettings.sharedDictionarySize > 0) {
+            std::cerr << "*** The --stream, --filter and --train-dictionary switches can not be combined." << std::endl;
+            success = false;
+        } else {
+            outputSettings.chunkSize = 65536;
+        }
+    }
+
     if (helpRequested) {
         std::cout << "Copyright 2020 Inesonic, LLC" << std::endl
                   << "This software is licensed under two terms:" << std::endl
@@ -604,10 +9977,247 @@ int main(int argumentCount, char* argumentValues[]) {
                   << std::endl
                   << "  -Z | --no-zlib" << std::endl
                   << "    Indicates that the generated payload should not be compressed using" << std::endl
-                  << "    Qt's variant of the zlib compression algorithm." << std::endl;
+                  << "    Qt's variant of the zlib compression algorithm." << std::endl
+                  << std::endl
+                  << "  --zlib-max" << std::endl
+                  << "    Compresses using Qt's variant of zlib, like -z, but replaces qCompress" << std::endl
+                  << "    with a much slower exhaustive deflate encoder.  Output is typically" << std::endl
+                  << "    several percent smaller and remains compatible with qUncompress.  The" << std::endl
+                  << "    qCompress output is kept whenever it is smaller." << std::endl
+                  << std::endl
+                  << "  --iterations <count>" << std::endl
+                  << "    Specifies the number of optimal parse iterations the --zlib-max" << std::endl
+                  << "    encoder runs on each block.  The default is 15." << std::endl
+                  << std::endl
+                  << "  --codec <codec>" << std::endl
+                  << "    Selects the codec used to compress the payload.  Supported values are:" << std::endl
+                  << "      none - The payload is not compressed.  Same as -Z." << std::endl
+                  << "      qt   - Qt's variant of zlib, use qUncompress to decompress.  Same as" << std::endl
+                  << "             -z.  This is the default." << std::endl
+                  << "      zstd - A single Zstandard frame, use ZSTD_decompress to decompress." << std::endl
+                  << "      lz4  - A single raw LZ4 block.  The generated source includes the" << std::endl
+                  << "             BuildPayload::lz4Decompress function to decompress it." << std::endl
+                  << "      xz   - A single .xz stream, use lzma_stream_buffer_decode to" << std::endl
+                  << "             decompress." << std::endl
+                  << "    Codecs other than none and qt also emit <variable>Codec and" << std::endl
+                  << "    <variable>UncompressedSize declarations." << std::endl
+                  << std::endl
+                  << "  -l <level> | --level <level>" << std::endl
+                  << "    Specifies the codec specific compression level.  The default is 9 for" << std::endl
+                  << "    qt, 19 for zstd, 12 for lz4 and 9 for xz.  lz4 levels below 3 select" << std::endl
+                  << "    the fast compressor, higher levels select LZ4-HC.  For xz, the level" << std::endl
+                  << "    selects the preset." << std::endl
+                  << std::endl
+                  << "  --threads <count>" << std::endl
+                  << "    Specifies the number of worker threads the codec may use.  A value of 0" << std::endl
+                  << "    compresses on the main thread.  The default is the number of cores." << std::endl
+                  << "    The --zlib-max output does not depend on the thread count." << std::endl
+                  << std::endl
+                  << "  --long <window log>" << std::endl
+                  << "    Enables zstd long distance matching using a window of 2^<window log>" << std::endl
+                  << "    bytes.  Windows larger than 2^27 bytes require the consumer to raise" << std::endl
+                  << "    ZSTD_d_windowLogMax when decompressing." << std::endl
+                  << std::endl
+                  << "  --extreme" << std::endl
+                  << "    Selects the slower, extreme, variant of the xz preset." << std::endl
+                  << std::endl
+                  << "  --dictionary-size <bytes>" << std::endl
+                  << "    Overrides the xz dictionary size implied by the preset.  The size may" << std::endl
+                  << "    use a K, M or G suffix.  Consumers need roughly this much memory to" << std::endl
+                  << "    decompress the payload." << std::endl
+                  << std::endl
+                  << "  --bcj <filter>" << std::endl
+                  << "    Applies an xz branch/call/jump filter ahead of LZMA2 to improve the" << std::endl
+                  << "    compression of executable code.  Supported values are none, x86, arm," << std::endl
+                  << "    armthumb, arm64, powerpc and sparc." << std::endl
+                  << std::endl
+                  << "  --train-dictionary <bytes>" << std::endl
+                  << "    Trains a dictionary over every input, emits it once as" << std::endl
+                  << "    <variable>Dictionary and compresses each payload against it.  Greatly" << std::endl
+                  << "    improves the compression of many small, similar, files.  Supported by" << std::endl
+                  << "    the zstd codec, use ZSTD_DCtx_loadDictionary to decompress, and the qt" << std::endl
+                  << "    codec, limited to 32K, use inflateSetDictionary on the zlib stream" << std::endl
+                  << "    following the 4 byte size header.  The functions generated by" << std::endl
+                  << "    --accessors, --decompress-into, --stream and --cache pass the dictionary" << std::endl
+                  << "    to the decoder.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --filter <filter>[,<filter>...]" << std::endl
+                  << "    Applies transform filters, in order, ahead of any codec.  May be" << std::endl
+                  << "    repeated.  Supported filters are shuffle:<element size>, which groups" << std::endl
+                  << "    byte N of every element, delta:<distance>, and the x86, arm and arm64" << std::endl
+                  << "    branch filters.  The shuffle is applied to independent 16K blocks.  The" << std::endl
+                  << "    list is recorded as <variable>Filters and as the <variable>FilterSteps" << std::endl
+                  << "    array, and BuildPayload::unfilter(<variable>FilterSteps, data, size)" << std::endl
+                  << "    undoes the filters in place, without allocating, after decompression." << std::endl
+                  << "    Chunked payloads are filtered per chunk and undone by the generated" << std::endl
+                  << "    accessors.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --auto-codec" << std::endl
+                  << "    Compresses each payload with every available codec at several levels," << std::endl
+                  << "    in parallel, and keeps the candidate with the lowest cost.  The cost" << std::endl
+                  << "    weighs the compressed size against compression and decompression times" << std::endl
+                  << "    estimated from nominal per codec and per level rates, so the choice" << std::endl
+                  << "    depends only on the input.  A report of every candidate is written to" << std::endl
+                  << "    stderr and the choice is recorded in the <variable>Codec and" << std::endl
+                  << "    <variable>Level declarations.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --measure-time" << std::endl
+                  << "    Makes --auto-codec weigh the measured compression time instead of the" << std::endl
+                  << "    nominal rate.  The choice then varies with machine load from run to" << std::endl
+                  << "    run." << std::endl
+                  << std::endl
+                  << "  --store-incompressible" << std::endl
+                  << "    Samples each payload and stores payloads that appear incompressible," << std::endl
+                  << "    such as JPEG, PNG or zip data, without compression.  Such payloads" << std::endl
+                  << "    always carry metadata with a codec of \"none\"." << std::endl
+                  << std::endl
+                  << "  --align <bytes>" << std::endl
+                  << "    Aligns each payload array to a power of two between 4K and 2M, such as" << std::endl
+                  << "    4K pages or 2M huge pages, and pads it to a multiple of the alignment so" << std::endl
+                  << "    no other data shares its pages.  Emits a <variable>Advise(advice)" << std::endl
+                  << "    function issuing madvise WILL_NEED, DONT_NEED or HUGE_PAGE hints on the" << std::endl
+                  << "    payload's pages.  Alignments above 8K are not supported by MSVC." << std::endl
+                  << std::endl
+                  << "  --sections" << std::endl
+                  << "    Places each payload and size variable in its own" << std::endl
+                  << "    .rodata.payload.<variable> section so linking with --gc-sections" << std::endl
+                  << "    discards payloads the program never references.  Variables with external" << std::endl
+                  << "    linkage are given hidden visibility.  Applies to ELF targets only." << std::endl
+                  << std::endl
+                  << "  --record-profile" << std::endl
+                  << "    Emits a <variable>Record() function for each payload, called by the" << std::endl
+                  << "    generated accessors, that appends the payload's name to the file named by" << std::endl
+                  << "    the BUILD_PAYLOAD_PROFILE environment variable on first access." << std::endl
+                  << std::endl
+                  << "  --profile <filename>" << std::endl
+                  << "    Reads an access profile written through --record-profile.  Payloads are" << std::endl
+                  << "    emitted in first access order so startup touches a contiguous set of" << std::endl
+                  << "    pages.  Payloads missing from the profile are placed in the .rodata.cold" << std::endl
+                  << "    section, and their sizes in .rodata.cold.sizes, or in" << std::endl
+                  << "    .rodata.cold.<variable> with --sections.  Variables of a writable type," << std::endl
+                  << "    such as a -T type without const, use .data in place of .rodata." << std::endl
+                  << std::endl
+                  << "  --solid" << std::endl
+                  << "    Concatenates every input and compresses them as a single payload named" << std::endl
+                  << "    <variable>.  A <variable>Entries table of BuildPayload::SolidEntry" << std::endl
+                  << "    holds the name, offset and length of each input within the" << std::endl
+                  << "    decompressed payload.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --packed" << std::endl
+                  << "    Compresses each input independently and packs them, followed by their" << std::endl
+                  << "    names, into a single <variable>Blob.  A <variable>Index table of" << std::endl
+                  << "    BuildPayload::PackedEntry, sorted by name, holds 32-bit offsets and" << std::endl
+                  << "    lengths rather than pointers so the table needs no relocations in" << std::endl
+                  << "    position independent executables.  <variable>Find(name) locates an" << std::endl
+                  << "    input and <variable>Decompress(entry, destination) decompresses it." << std::endl
+                  << "    Inputs and the blob are limited to 4 GiB." << std::endl
+                  << std::endl
+                  << "  --perfect-hash" << std::endl
+                  << "    Locates packed inputs through a minimal perfect hash of their names." << std::endl
+                  << "    <variable>Index is emitted in hash order and a constexpr" << std::endl
+                  << "    <variable>Displacements table selects each input's slot so" << std::endl
+                  << "    <variable>Find(name) costs two hashes and one comparison with no" << std::endl
+                  << "    allocation or startup initialization.  <variable>Find also accepts a" << std::endl
+                  << "    std::string_view under C++17.  Implies --packed." << std::endl
+                  << std::endl
+                  << "  --chunk-size <bytes>" << std::endl
+                  << "    Divides each payload into chunks of this size, between 1K and 1G, that" << std::endl
+                  << "    are compressed independently.  Emits a <variable>ChunkOffsets index, a" << std::endl
+                  << "    BuildPayload::ChunkedPayload <variable>Chunks descriptor and a" << std::endl
+                  << "    <variable>Read(offset, length, destination) function that decompresses" << std::endl
+                  << "    only the chunks covering the requested range.  A" << std::endl
+                  << "    <variable>Decompress(destination, threads) function decompresses the" << std::endl
+                  << "    entire payload with every chunk decoded in parallel and" << std::endl
+                  << "    <variable>DecompressOn(destination, executor, tasks) does the same on a" << std::endl
+                  << "    caller supplied executor.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --baseline <filename>" << std::endl
+                  << "    Encodes the input as a binary delta against a baseline, such as the" << std::endl
+                  << "    same file from the previous release, before compression.  Supply one" << std::endl
+                  << "    baseline per input, in input order.  Emits <variable>BaselineSize," << std::endl
+                  << "    <variable>BaselineHash and <variable>TargetSize declarations and a" << std::endl
+                  << "    <variable>Apply(baseline, baselineSize, destination) function that" << std::endl
+                  << "    decompresses the delta and rebuilds the input from the baseline.  Apply" << std::endl
+                  << "    fails if the baseline does not match.  The baseline is only available" << std::endl
+                  << "    at run time so --accessors, --decompress-into, --stream and --cache can" << std::endl
+                  << "    not be combined with --baseline.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --cdc <bytes>" << std::endl
+                  << "    Divides every input into content defined chunks averaging this size," << std::endl
+                  << "    between 256 and 64M, and compresses each distinct chunk once into a" << std::endl
+                  << "    shared <variable>ChunkStore.  Each input is emitted as a" << std::endl
+                  << "    <variable>ChunkList of chunk indices with a BuildPayload::ChunkList" << std::endl
+                  << "    <variable>Chunks descriptor, a <variable>Reassemble(destination)" << std::endl
+                  << "    function and a <variable>Stream(sink) function that passes the payload" << std::endl
+                  << "    to the sink one chunk at a time.  Greatly reduces the size of inputs" << std::endl
+                  << "    that share large regions, such as successive versions of a file." << std::endl
+                  << std::endl
+                  << "  --estimate" << std::endl
+                  << "    Reports, for every available codec, the projected compressed size," << std::endl
+                  << "    generated source size and compile time of each input rather than" << std::endl
+                  << "    generating output.  Up to 64 randomly placed blocks of 64K, or of the" << std::endl
+                  << "    chunk size, are compressed independently on every thread so results" << std::endl
+                  << "    are slightly pessimistic and include a 95% confidence interval." << std::endl
+                  << std::endl
+                  << "  --accessors" << std::endl
+                  << "    Emits a <variable>Get() function for each payload that decompresses the" << std::endl
+                  << "    payload on first use and returns a BuildPayload::Span holding the" << std::endl
+                  << "    decompressed contents.  The accessor is thread safe, decompresses once" << std::endl
+                  << "    per translation unit and later calls cost a single atomic load.  Can not" << std::endl
+                  << "    be combined with --baseline.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --prefetch" << std::endl
+                  << "    Emits <variable>Registry, listing every payload's accessor, and a" << std::endl
+                  << "    <variable>PrefetchAll(priority, threads) function that decompresses the" << std::endl
+                  << "    payloads on background threads, those named in the priority list first." << std::endl
+                  << "    Accessors block only while their payload is pending and" << std::endl
+                  << "    <variable>State() reports whether it is ready.  Implies --accessors." << std::endl
+                  << std::endl
+                  << "  --cache" << std::endl
+                  << "    Emits a <variable>Acquire() function for each payload returning a" << std::endl
+                  << "    reference counted BuildPayload::PayloadHandle.  Decompressed payloads are" << std::endl
+                  << "    held by BuildPayload::PayloadCache::instance() within the budget set by" << std::endl
+                  << "    setBudget, least recently used payloads not pinned by a handle are" << std::endl
+                  << "    released first and decompressed again on their next use.  Can not be" << std::endl
+                  << "    combined with --baseline.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --decompress-into" << std::endl
+                  << "    Declares <variable>UncompressedSize constexpr and emits a" << std::endl
+                  << "    <variable>DecompressInto(destination, size) function for each payload" << std::endl
+                  << "    that decompresses straight into caller owned memory, such as an arena or" << std::endl
+                  << "    a pinned buffer, rather than allocating the output.  The qt, lz4 and" << std::endl
+                  << "    none codecs decode with generated code that never allocates, zstd" << std::endl
+                  << "    allocates one context per thread on first use and xz allocates its" << std::endl
+                  << "    decoder state inside liblzma on every call.  Can not be combined with" << std::endl
+                  << "    --baseline.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  --stream" << std::endl
+                  << "    Emits a <variable>OpenStream() function for each payload returning a" << std::endl
+                  << "    BuildPayload::StreamDecoder.  Wrap it in a BuildPayload::PayloadStreamBuffer" << std::endl
+                  << "    to read the payload through a std::istream or, when Qt is available, a" << std::endl
+                  << "    BuildPayload::PayloadDevice to read it as a QIODevice.  The payload is" << std::endl
+                  << "    decompressed on demand into a 64K buffer, keeping at most 64K of" << std::endl
+                  << "    history.  Filtered payloads are chunked, using 64K chunks unless" << std::endl
+                  << "    --chunk-size or --cdc is given, so their filters are undone one chunk at" << std::endl
+                  << "    a time.  Can not be combined with --baseline, or with --filter and" << std::endl
+                  << "    --train-dictionary.  Implies --metadata." << std::endl
+                  << std::endl
+                  << "  -m | --metadata" << std::endl
+                  << "    Emits the <variable>Codec and <variable>UncompressedSize declarations" << std::endl
+                  << "    for every codec." << std::endl;
+    } else if (success && estimateRequested) {
+        success = estimatePayloads(
+            inputs,
+            namespaceName.empty() ? 0 : indentation,
+            indentation,
+            width,
+            compressionSettings,
+            outputSettings
+        );
     } else if (success) {
         success = buildPayload(
             inputs,
+            baselines,
             outputFilename,
             description,
             copyrightMessage,
@@ -619,7 +10229,8 @@ int main(int argumentCount, char* argumentValues[]) {
             variableType,
             sizeVariableName,
             sizeVariableType,
-            useZlib
+            compressionSettings,
+            outputSettings
         );
     }
 
@@ -30,7 +30,31 @@ QT += core
 CONFIG += c++14
 CONFIG -= import_plugins
 
-SOURCES = build_payload.cpp
+HEADERS = deflate_encoder.h
+
+SOURCES = build_payload.cpp \
+          deflate_encoder.cpp
+
+########################################################################################################################
+# Optional codec libraries
+#
+
+CONFIG += link_pkgconfig
+
+packagesExist(libzstd) {
+    PKGCONFIG += libzstd
+    DEFINES += HAVE_ZSTD
+}
+
+packagesExist(liblz4) {
+    PKGCONFIG += liblz4
+    DEFINES += HAVE_LZ4
+}
+
+packagesExist(liblzma) {
+    PKGCONFIG += liblzma
+    DEFINES += HAVE_LZMA
+}
 
 ########################################################################################################################
 # Locate build intermediate and output products
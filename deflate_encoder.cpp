@@ -0,0 +1,1535 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+*
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This file implements the \ref DeflateEncoder class.
+***********************************************************************************************************************/
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "deflate_encoder.h"
+
+namespace {
+    /**
+     * The size of the deflate sliding window, in bytes.
+     */
+    const std::size_t windowSize = 32768;
+
+    /**
+     * The shortest match deflate can represent.
+     */
+    const unsigned minimumMatchLength = 3;
+
+    /**
+     * The longest match deflate can represent.
+     */
+    const unsigned maximumMatchLength = 258;
+
+    /**
+     * The maximum number of hash chain entries examined at each position.
+     */
+    const unsigned maximumChainHits = 2048;
+
+    /**
+     * The number of bits in the match finder hash.
+     */
+    const unsigned hashBits = 16;
+
+    /**
+     * The size of the segments handed to worker threads.  The size is fixed so the thread count only changes the
+     * compression time, never the output.  Also limits the memory used by the match tables.
+     */
+    const std::size_t segmentSize = 512 * 1024;
+
+    /**
+     * The maximum number of blocks a segment is split into.
+     */
+    const unsigned maximumBlocksPerSegment = 15;
+
+    /**
+     * The number of symbols between candidate block split points.
+     */
+    const std::size_t splitGranularity = 1024;
+
+    /**
+     * The maximum number of bytes in a stored block.
+     */
+    const std::size_t maximumStoredBlockSize = 65535;
+
+    /**
+     * The number of literal/length symbols, including the two reserved symbols.
+     */
+    const unsigned numberLiteralLengthSymbols = 288;
+
+    /**
+     * The number of distance symbols, including the two reserved symbols.
+     */
+    const unsigned numberDistanceSymbols = 32;
+
+    /**
+     * The number of code length symbols.
+     */
+    const unsigned numberCodeLengthSymbols = 19;
+
+    /**
+     * The end of block symbol.
+     */
+    const unsigned endOfBlockSymbol = 256;
+
+    const unsigned short lengthBase[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+
+    const unsigned char lengthExtraBits[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+
+    const unsigned short distanceBase[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+        6145, 8193, 12289, 16385, 24577
+    };
+
+    const unsigned char distanceExtraBits[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    const unsigned char codeLengthOrder[numberCodeLengthSymbols] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+    };
+
+    /**
+     * Class holding lookup tables from match lengths and distances to deflate symbol indexes.
+     */
+    class SymbolTables {
+        public:
+            SymbolTables() {
+                for (unsigned index=0 ; index<29 ; ++index) {
+                    unsigned end = index < 28 ? lengthBase[index + 1] : maximumMatchLength + 1;
+                    for (unsigned length=lengthBase[index] ; length<end ; ++length) {
+                        lengthIndex[length] = static_cast<unsigned char>(index);
+                    }
+                }
+
+                for (unsigned index=0 ; index<30 ; ++index) {
+                    unsigned end = index < 29 ? distanceBase[index + 1] : windowSize + 1;
+                    for (unsigned distance=distanceBase[index] ; distance<end ; ++distance) {
+                        distanceIndex[distance] = static_cast<unsigned char>(index);
+                    }
+                }
+            }
+
+            /**
+             * Table mapping match lengths to length indexes.  Add 257 to obtain the literal/length symbol.
+             */
+            unsigned char lengthIndex[maximumMatchLength + 1];
+
+            /**
+             * Table mapping match distances to distance symbols.
+             */
+            unsigned char distanceIndex[windowSize + 1];
+    };
+
+    const SymbolTables symbolTables;
+
+    /**
+     * Structure holding a single LZ77 symbol.
+     */
+    struct Lz77Symbol {
+        /**
+         * The literal byte or the match length.
+         */
+        std::uint16_t literalOrLength;
+
+        /**
+         * The match distance.  A value of 0 indicates a literal.
+         */
+        std::uint16_t distance;
+    };
+
+    /**
+     * Structure holding one entry of a match table.
+     */
+    struct Match {
+        /**
+         * The match length.
+         */
+        std::uint16_t length;
+
+        /**
+         * The smallest distance achieving this length.
+         */
+        std::uint16_t distance;
+    };
+
+    /**
+     * Structure holding, for every position in a segment, the shortest distance for each achievable match length.
+     * Entries for a position are stored in increasing length order.
+     */
+    struct MatchTable {
+        /**
+         * Offsets into the match list for each position, plus a final sentinel.
+         */
+        std::vector<std::uint32_t> offsets;
+
+        /**
+         * The matches for all positions.
+         */
+        std::vector<Match> matches;
+    };
+
+    /**
+     * Structure holding the literal/length and distance symbol histograms for a run of LZ77 symbols.
+     */
+    struct Histogram {
+        Histogram() {
+            literalLength.fill(0);
+            distance.fill(0);
+        }
+
+        void add(const Lz77Symbol& symbol) {
+            if (symbol.distance == 0) {
+                ++literalLength[symbol.literalOrLength];
+            } else {
+                ++literalLength[257 + symbolTables.lengthIndex[symbol.literalOrLength]];
+                ++distance[symbolTables.distanceIndex[symbol.distance]];
+            }
+        }
+
+        void add(const Histogram& other) {
+            for (unsigned i=0 ; i<numberLiteralLengthSymbols ; ++i) {
+                literalLength[i] += other.literalLength[i];
+            }
+
+            for (unsigned i=0 ; i<numberDistanceSymbols ; ++i) {
+                distance[i] += other.distance[i];
+            }
+        }
+
+        void subtract(const Histogram& other) {
+            for (unsigned i=0 ; i<numberLiteralLengthSymbols ; ++i) {
+                literalLength[i] -= other.literalLength[i];
+            }
+
+            for (unsigned i=0 ; i<numberDistanceSymbols ; ++i) {
+                distance[i] -= other.distance[i];
+            }
+        }
+
+        std::array<std::uint32_t, numberLiteralLengthSymbols> literalLength;
+        std::array<std::uint32_t, numberDistanceSymbols>      distance;
+    };
+
+    /**
+     * Class that accumulates a stream of bits, least significant bit first.
+     */
+    class BitWriter {
+        public:
+            BitWriter():bitBuffer(0),bitCount(0) {}
+
+            void write(std::uint32_t value, unsigned numberBits) {
+                bitBuffer |= static_cast<std::uint64_t>(value) << bitCount;
+                bitCount  += numberBits;
+
+                while (bitCount >= 8) {
+                    bytes.push_back(static_cast<unsigned char>(bitBuffer));
+                    bitBuffer >>= 8;
+                    bitCount   -= 8;
+                }
+            }
+
+            void alignToByte() {
+                if (bitCount > 0) {
+                    write(0, 8 - bitCount);
+                }
+            }
+
+            void append(const BitWriter& other) {
+                if (bitCount == 0) {
+                    bytes.insert(bytes.end(), other.bytes.begin(), other.bytes.end());
+                } else {
+                    for (unsigned char byte : other.bytes) {
+                        write(byte, 8);
+                    }
+                }
+
+                write(static_cast<std::uint32_t>(other.bitBuffer), other.bitCount);
+            }
+
+            std::vector<unsigned char> finish() {
+                alignToByte();
+                return std::move(bytes);
+            }
+
+        private:
+            std::vector<unsigned char> bytes;
+            std::uint64_t              bitBuffer;
+            unsigned                   bitCount;
+    };
+
+    /**
+     * Structure holding a Huffman code in the bit reversed form expected by \ref BitWriter.
+     */
+    struct HuffmanCode {
+        std::vector<unsigned char> lengths;
+        std::vector<std::uint32_t> codes;
+    };
+
+    /**
+     * Function that computes length limited Huffman code lengths.  Lengths are limited by rebalancing the optimal
+     * tree as described in Annex K.3 of the JPEG specification.
+     *
+     * \param[in]  frequencies     The symbol frequencies.
+     *
+     * \param[in]  numberSymbols   The number of symbols.
+     *
+     * \param[in]  maximumLength   The maximum code length.
+     *
+     * \param[out] lengths         The resulting code lengths.  Unused symbols receive a length of 0.
+     */
+    void computeCodeLengths(
+            const std::uint32_t* frequencies,
+            unsigned             numberSymbols,
+            unsigned             maximumLength,
+            unsigned char*       lengths
+        ) {
+        std::fill(lengths, lengths + numberSymbols, 0);
+
+        std::vector<unsigned> symbols;
+        for (unsigned symbol=0 ; symbol<numberSymbols ; ++symbol) {
+            if (frequencies[symbol] > 0) {
+                symbols.push_back(symbol);
+            }
+        }
+
+        unsigned numberUsed = static_cast<unsigned>(symbols.size());
+        if (numberUsed == 1) {
+            lengths[symbols[0]] = 1;
+        } else if (numberUsed > 1) {
+            std::stable_sort(
+                symbols.begin(),
+                symbols.end(),
+                [frequencies](unsigned a, unsigned b) {
+                    return frequencies[a] < frequencies[b];
+                }
+            );
+
+            // Two queue Huffman construction.  Leaves are nodes 0 through numberUsed-1, internal nodes follow.
+            unsigned                   numberNodes = 2 * numberUsed - 1;
+            std::vector<std::uint64_t> weights(numberNodes);
+            std::vector<unsigned>      parents(numberNodes);
+            for (unsigned i=0 ; i<numberUsed ; ++i) {
+                weights[i] = frequencies[symbols[i]];
+            }
+
+            unsigned nextLeaf     = 0;
+            unsigned nextInternal = numberUsed;
+            for (unsigned node=numberUsed ; node<numberNodes ; ++node) {
+                unsigned children[2];
+                for (unsigned child=0 ; child<2 ; ++child) {
+                    if (nextLeaf < numberUsed && (nextInternal >= node || weights[nextLeaf] <= weights[nextInternal])) {
+                        children[child] = nextLeaf++;
+                    } else {
+                        children[child] = nextInternal++;
+                    }
+                }
+
+                weights[node]         = weights[children[0]] + weights[children[1]];
+                parents[children[0]]  = node;
+                parents[children[1]]  = node;
+            }
+
+            std::vector<unsigned> depths(numberNodes);
+            depths[numberNodes - 1] = 0;
+            for (unsigned node=numberNodes - 1 ; node>0 ; --node) {
+                depths[node - 1] = depths[parents[node - 1]] + 1;
+            }
+
+            std::vector<unsigned> lengthCounts(numberUsed + 1, 0);
+            unsigned              deepest = 0;
+            for (unsigned leaf=0 ; leaf<numberUsed ; ++leaf) {
+                ++lengthCounts[depths[leaf]];
+                deepest = std::max(deepest, depths[leaf]);
+            }
+
+            for (unsigned length=deepest ; length>maximumLength ; --length) {
+                while (lengthCounts[length] > 0) {
+                    unsigned shorter = length - 2;
+                    while (lengthCounts[shorter] == 0) {
+                        --shorter;
+                    }
+
+                    lengthCounts[length]      -= 2;
+                    lengthCounts[length - 1]  += 1;
+                    lengthCounts[shorter + 1] += 2;
+                    lengthCounts[shorter]     -= 1;
+                }
+            }
+
+            // Least frequent symbols receive the longest codes.
+            unsigned leaf = 0;
+            for (unsigned length=std::min(deepest, maximumLength) ; length>0 ; --length) {
+                for (unsigned count=0 ; count<lengthCounts[length] ; ++count) {
+                    lengths[symbols[leaf++]] = static_cast<unsigned char>(length);
+                }
+            }
+        }
+    }
+
+
+    /**
+     * Function that makes certain a code has at least two symbols.  Some inflate implementations reject codes with
+     * a single symbol.
+     *
+     * \param[in,out] lengths       The code lengths.
+     *
+     * \param[in]     numberSymbols The number of symbols.
+     */
+    void ensureTwoCodes(unsigned char* lengths, unsigned numberSymbols) {
+        unsigned numberUsed = 0;
+        for (unsigned symbol=0 ; symbol<numberSymbols ; ++symbol) {
+            if (lengths[symbol] != 0) {
+                ++numberUsed;
+            }
+        }
+
+        if (numberUsed < 2) {
+            unsigned added = 0;
+            for (unsigned symbol=0 ; symbol<numberSymbols && numberUsed + added<2 ; ++symbol) {
+                if (lengths[symbol] == 0) {
+                    lengths[symbol] = 1;
+                    ++added;
+                }
+            }
+
+            for (unsigned symbol=0 ; symbol<numberSymbols ; ++symbol) {
+                if (lengths[symbol] != 0) {
+                    lengths[symbol] = 1;
+                }
+            }
+        }
+    }
+
+
+    /**
+     * Function that builds canonical, bit reversed, codes from a set of code lengths.
+     *
+     * \param[in] lengths       The code lengths.
+     *
+     * \param[in] numberSymbols The number of symbols.
+     *
+     * \return Returns the code.
+     */
+    HuffmanCode buildCode(const unsigned char* lengths, unsigned numberSymbols) {
+        HuffmanCode result;
+        result.lengths.assign(lengths, lengths + numberSymbols);
+        result.codes.assign(numberSymbols, 0);
+
+        unsigned lengthCounts[16] = { 0 };
+        for (unsigned symbol=0 ; symbol<numberSymbols ; ++symbol) {
+            ++lengthCounts[lengths[symbol]];
+        }
+
+        lengthCounts[0] = 0;
+
+        std::uint32_t nextCode[16] = { 0 };
+        std::uint32_t code         = 0;
+        for (unsigned length=1 ; length<16 ; ++length) {
+            code             = (code + lengthCounts[length - 1]) << 1;
+            nextCode[length] = code;
+        }
+
+        for (unsigned symbol=0 ; symbol<numberSymbols ; ++symbol) {
+            unsigned length = lengths[symbol];
+            if (length != 0) {
+                std::uint32_t value    = nextCode[length]++;
+                std::uint32_t reversed = 0;
+                for (unsigned bit=0 ; bit<length ; ++bit) {
+                    reversed = (reversed << 1) | ((value >> bit) & 1);
+                }
+
+                result.codes[symbol] = reversed;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+     * Structure holding a run length encoded code length symbol.
+     */
+    struct CodeLengthSymbol {
+        unsigned char symbol;
+        unsigned char extra;
+    };
+
+    /**
+     * Class that holds the trees and header for a dynamic Huffman block.
+     */
+    class DynamicTrees {
+        public:
+            explicit DynamicTrees(const Histogram& histogram) {
+                std::array<std::uint32_t, numberLiteralLengthSymbols> literalLengthFrequencies = histogram.literalLength;
+                literalLengthFrequencies[endOfBlockSymbol] = 1;
+
+                computeCodeLengths(literalLengthFrequencies.data(), 286, 15, literalLengthLengths);
+                literalLengthLengths[286] = 0;
+                literalLengthLengths[287] = 0;
+                ensureTwoCodes(literalLengthLengths, 286);
+
+                computeCodeLengths(histogram.distance.data(), 30, 15, distanceLengths);
+                distanceLengths[30] = 0;
+                distanceLengths[31] = 0;
+                ensureTwoCodes(distanceLengths, 30);
+
+                numberLiteralLengthCodes = 286;
+                while (numberLiteralLengthCodes > 257 && literalLengthLengths[numberLiteralLengthCodes - 1] == 0) {
+                    --numberLiteralLengthCodes;
+                }
+
+                numberDistanceCodes = 30;
+                while (numberDistanceCodes > 1 && distanceLengths[numberDistanceCodes - 1] == 0) {
+                    --numberDistanceCodes;
+                }
+
+                std::vector<unsigned char> combined(
+                    literalLengthLengths,
+                    literalLengthLengths + numberLiteralLengthCodes
+                );
+                combined.insert(combined.end(), distanceLengths, distanceLengths + numberDistanceCodes);
+
+                std::size_t index = 0;
+                while (index < combined.size()) {
+                    unsigned char value = combined[index];
+                    std::size_t   run   = 1;
+                    while (index + run < combined.size() && combined[index + run] == value) {
+                        ++run;
+                    }
+
+                    index += run;
+
+                    if (value == 0) {
+                        while (run >= 11) {
+                            std::size_t count = std::min(run, std::size_t(138));
+                            codeLengthSymbols.push_back({ 18, static_cast<unsigned char>(count - 11) });
+                            run -= count;
+                        }
+
+                        if (run >= 3) {
+                            codeLengthSymbols.push_back({ 17, static_cast<unsigned char>(run - 3) });
+                            run = 0;
+                        }
+                    } else {
+                        codeLengthSymbols.push_back({ value, 0 });
+                        --run;
+
+                        while (run >= 3) {
+                            std::size_t count = std::min(run, std::size_t(6));
+                            codeLengthSymbols.push_back({ 16, static_cast<unsigned char>(count - 3) });
+                            run -= count;
+                        }
+                    }
+
+                    while (run > 0) {
+                        codeLengthSymbols.push_back({ value, 0 });
+                        --run;
+                    }
+                }
+
+                std::uint32_t codeLengthFrequencies[numberCodeLengthSymbols] = { 0 };
+                for (const CodeLengthSymbol& symbol : codeLengthSymbols) {
+                    ++codeLengthFrequencies[symbol.symbol];
+                }
+
+                computeCodeLengths(codeLengthFrequencies, numberCodeLengthSymbols, 7, codeLengthLengths);
+                ensureTwoCodes(codeLengthLengths, numberCodeLengthSymbols);
+
+                numberCodeLengthCodes = numberCodeLengthSymbols;
+                while (numberCodeLengthCodes > 4 && codeLengthLengths[codeLengthOrder[numberCodeLengthCodes - 1]] == 0) {
+                    --numberCodeLengthCodes;
+                }
+            }
+
+            std::uint64_t headerBits() const {
+                std::uint64_t result = 5 + 5 + 4 + 3 * numberCodeLengthCodes;
+                for (const CodeLengthSymbol& symbol : codeLengthSymbols) {
+                    result += codeLengthLengths[symbol.symbol];
+                    if (symbol.symbol == 16) {
+                        result += 2;
+                    } else if (symbol.symbol == 17) {
+                        result += 3;
+                    } else if (symbol.symbol == 18) {
+                        result += 7;
+                    }
+                }
+
+                return result;
+            }
+
+            void writeHeader(BitWriter& writer) const {
+                writer.write(numberLiteralLengthCodes - 257, 5);
+                writer.write(numberDistanceCodes - 1, 5);
+                writer.write(numberCodeLengthCodes - 4, 4);
+
+                for (unsigned i=0 ; i<numberCodeLengthCodes ; ++i) {
+                    writer.write(codeLengthLengths[codeLengthOrder[i]], 3);
+                }
+
+                HuffmanCode codeLengthCode = buildCode(codeLengthLengths, numberCodeLengthSymbols);
+                for (const CodeLengthSymbol& symbol : codeLengthSymbols) {
+                    writer.write(codeLengthCode.codes[symbol.symbol], codeLengthCode.lengths[symbol.symbol]);
+                    if (symbol.symbol == 16) {
+                        writer.write(symbol.extra, 2);
+                    } else if (symbol.symbol == 17) {
+                        writer.write(symbol.extra, 3);
+                    } else if (symbol.symbol == 18) {
+                        writer.write(symbol.extra, 7);
+                    }
+                }
+            }
+
+            unsigned char                 literalLengthLengths[numberLiteralLengthSymbols];
+            unsigned char                 distanceLengths[numberDistanceSymbols];
+            unsigned char                 codeLengthLengths[numberCodeLengthSymbols];
+            unsigned                      numberLiteralLengthCodes;
+            unsigned                      numberDistanceCodes;
+            unsigned                      numberCodeLengthCodes;
+            std::vector<CodeLengthSymbol> codeLengthSymbols;
+    };
+
+    /**
+     * Function that calculates the number of bits needed to encode a histogram's symbols, excluding the block
+     * header.
+     *
+     * \param[in] histogram            The symbol histogram.
+     *
+     * \param[in] literalLengthLengths The literal/length code lengths.
+     *
+     * \param[in] distanceLengths      The distance code lengths.
+     *
+     * \return Returns the number of bits, including the end of block symbol.
+     */
+    std::uint64_t dataBits(
+            const Histogram&     histogram,
+            const unsigned char* literalLengthLengths,
+            const unsigned char* distanceLengths
+        ) {
+        std::uint64_t result = literalLengthLengths[endOfBlockSymbol];
+
+        for (unsigned symbol=0 ; symbol<256 ; ++symbol) {
+            result += static_cast<std::uint64_t>(histogram.literalLength[symbol]) * literalLengthLengths[symbol];
+        }
+
+        for (unsigned index=0 ; index<29 ; ++index) {
+            result += (
+                  static_cast<std::uint64_t>(histogram.literalLength[257 + index])
+                * (literalLengthLengths[257 + index] + lengthExtraBits[index])
+            );
+        }
+
+        for (unsigned index=0 ; index<30 ; ++index) {
+            result += (
+                  static_cast<std::uint64_t>(histogram.distance[index])
+                * (distanceLengths[index] + distanceExtraBits[index])
+            );
+        }
+
+        return result;
+    }
+
+
+    /**
+     * Function that returns the fixed Huffman code lengths.
+     *
+     * \param[out] literalLengthLengths The fixed literal/length code lengths.
+     *
+     * \param[out] distanceLengths      The fixed distance code lengths.
+     */
+    void fixedLengths(unsigned char* literalLengthLengths, unsigned char* distanceLengths) {
+        for (unsigned symbol=0 ; symbol<numberLiteralLengthSymbols ; ++symbol) {
+            if (symbol < 144) {
+                literalLengthLengths[symbol] = 8;
+            } else if (symbol < 256) {
+                literalLengthLengths[symbol] = 9;
+            } else if (symbol < 280) {
+                literalLengthLengths[symbol] = 7;
+            } else {
+                literalLengthLengths[symbol] = 8;
+            }
+        }
+
+        std::fill(distanceLengths, distanceLengths + numberDistanceSymbols, 5);
+    }
+
+
+    /**
+     * Function that estimates the cost, in bits, of encoding a histogram as a dynamic block.
+     *
+     * \param[in] histogram The symbol histogram.
+     *
+     * \return Returns the block size, in bits.
+     */
+    std::uint64_t dynamicBlockBits(const Histogram& histogram) {
+        DynamicTrees trees(histogram);
+        return 3 + trees.headerBits() + dataBits(histogram, trees.literalLengthLengths, trees.distanceLengths);
+    }
+
+
+    /**
+     * Function that builds the match table for a segment.
+     *
+     * \param[in]  data        The buffer holding the history and the segment.
+     *
+     * \param[in]  windowStart The first byte of history the segment may reference.
+     *
+     * \param[in]  startOffset The offset of the first byte in the segment.
+     *
+     * \param[in]  endOffset   The offset just past the last byte in the segment.
+     *
+     * \param[out] matchTable  The resulting match table.
+     */
+    void findMatches(
+            const unsigned char* data,
+            std::size_t          windowStart,
+            std::size_t          startOffset,
+            std::size_t          endOffset,
+            MatchTable&          matchTable
+        ) {
+        std::size_t numberPositions = endOffset - startOffset;
+
+        matchTable.offsets.assign(numberPositions + 1, 0);
+        matchTable.matches.clear();
+        matchTable.matches.reserve(numberPositions * 2);
+
+        std::vector<std::int32_t> head(std::size_t(1) << hashBits, -1);
+        std::vector<std::int32_t> previous(endOffset - windowStart, -1);
+
+        auto hash = [data](std::size_t position) {
+            std::uint32_t value = (
+                  (static_cast<std::uint32_t>(data[position]) << 16)
+                | (static_cast<std::uint32_t>(data[position + 1]) << 8)
+                | data[position + 2]
+            );
+
+            return (value * 2654435761U) >> (32 - hashBits);
+        };
+
+        for (std::size_t position=windowStart ; position + minimumMatchLength <= startOffset ; ++position) {
+            std::uint32_t hashValue = hash(position);
+            std::int32_t  relative  = static_cast<std::int32_t>(position - windowStart);
+            previous[relative] = head[hashValue];
+            head[hashValue]    = relative;
+        }
+
+        for (std::size_t position=startOffset ; position<endOffset ; ++position) {
+            std::size_t available = endOffset - position;
+
+            if (available >= minimumMatchLength) {
+                unsigned      maximumLength = static_cast<unsigned>(std::min(available, std::size_t(maximumMatchLength)));
+                std::uint32_t hashValue     = hash(position);
+                std::int32_t  candidate     = head[hashValue];
+                unsigned      bestLength    = minimumMatchLength - 1;
+                unsigned      hits          = 0;
+
+                const unsigned char* current = data + position;
+                while (candidate >= 0 && hits < maximumChainHits) {
+                    std::size_t candidatePosition = windowStart + static_cast<std::size_t>(candidate);
+                    std::size_t distance          = position - candidatePosition;
+                    if (distance > windowSize) {
+                        break;
+                    }
+
+                    const unsigned char* reference = data + candidatePosition;
+                    if (reference[bestLength] == current[bestLength]) {
+                        unsigned length = 0;
+                        while (length < maximumLength && reference[length] == current[length]) {
+                            ++length;
+                        }
+
+                        if (length > bestLength) {
+                            matchTable.matches.push_back(
+                                { static_cast<std::uint16_t>(length), static_cast<std::uint16_t>(distance) }
+                            );
+
+                            bestLength = length;
+                            if (length == maximumLength) {
+                                break;
+                            }
+                        }
+                    }
+
+                    candidate = previous[candidate];
+                    ++hits;
+                }
+
+                std::int32_t relative = static_cast<std::int32_t>(position - windowStart);
+                previous[relative] = head[hashValue];
+                head[hashValue]    = relative;
+            }
+
+            matchTable.offsets[position - startOffset + 1] = static_cast<std::uint32_t>(matchTable.matches.size());
+        }
+    }
+
+
+    /**
+     * Function that performs a greedy parse using the longest match at each position.
+     *
+     * \param[in] data        The buffer holding the segment.
+     *
+     * \param[in] startOffset The offset of the first byte in the segment.
+     *
+     * \param[in] endOffset   The offset just past the last byte in the segment.
+     *
+     * \param[in] matchTable  The segment's match table.
+     *
+     * \return Returns the LZ77 symbols.
+     */
+    std::vector<Lz77Symbol> greedyParse(
+            const unsigned char* data,
+            std::size_t          startOffset,
+            std::size_t          endOffset,
+            const MatchTable&    matchTable
+        ) {
+        std::vector<Lz77Symbol> result;
+
+        std::size_t position = startOffset;
+        while (position < endOffset) {
+            std::size_t relative = position - startOffset;
+            std::uint32_t first  = matchTable.offsets[relative];
+            std::uint32_t last   = matchTable.offsets[relative + 1];
+
+            if (last > first) {
+                const Match& match = matchTable.matches[last - 1];
+                result.push_back({ match.length, match.distance });
+                position += match.length;
+            } else {
+                result.push_back({ data[position], 0 });
+                ++position;
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+     * Function that performs an optimal parse of a block under a cost model derived from a symbol histogram.
+     *
+     * \param[in] data           The buffer holding the segment.
+     *
+     * \param[in] segmentStart   The offset of the first byte in the segment.
+     *
+     * \param[in] blockStart     The offset of the first byte in the block.
+     *
+     * \param[in] blockEnd       The offset just past the last byte in the block.
+     *
+     * \param[in] matchTable     The segment's match table.
+     *
+     * \param[in] statistics     The histogram used to derive the cost model.
+     *
+     * \return Returns the LZ77 symbols.
+     */
+    std::vector<Lz77Symbol> optimalParse(
+            const unsigned char* data,
+            std::size_t          segmentStart,
+            std::size_t          blockStart,
+            std::size_t          blockEnd,
+            const MatchTable&    matchTable,
+            const Histogram&     statistics
+        ) {
+        float literalLengthCosts[numberLiteralLengthSymbols];
+        float distanceSymbolCosts[numberDistanceSymbols];
+
+        std::uint64_t literalLengthTotal = 1;
+        for (unsigned symbol=0 ; symbol<numberLiteralLengthSymbols ; ++symbol) {
+            literalLengthTotal += statistics.literalLength[symbol];
+        }
+
+        std::uint64_t distanceTotal = 0;
+        for (unsigned symbol=0 ; symbol<numberDistanceSymbols ; ++symbol) {
+            distanceTotal += statistics.distance[symbol];
+        }
+
+        double literalLengthLog = std::log2(static_cast<double>(literalLengthTotal));
+        for (unsigned symbol=0 ; symbol<numberLiteralLengthSymbols ; ++symbol) {
+            std::uint32_t frequency = statistics.literalLength[symbol];
+            literalLengthCosts[symbol] = static_cast<float>(
+                frequency == 0 ? literalLengthLog + 1 : literalLengthLog - std::log2(static_cast<double>(frequency))
+            );
+        }
+
+        double distanceLog = std::log2(static_cast<double>(std::max(distanceTotal, std::uint64_t(1))));
+        for (unsigned symbol=0 ; symbol<numberDistanceSymbols ; ++symbol) {
+            std::uint32_t frequency = statistics.distance[symbol];
+            distanceSymbolCosts[symbol] = static_cast<float>(
+                frequency == 0 ? distanceLog + 1 : distanceLog - std::log2(static_cast<double>(frequency))
+            );
+        }
+
+        float lengthCosts[maximumMatchLength + 1];
+        for (unsigned length=minimumMatchLength ; length<=maximumMatchLength ; ++length) {
+            unsigned index = symbolTables.lengthIndex[length];
+            lengthCosts[length] = literalLengthCosts[257 + index] + lengthExtraBits[index];
+        }
+
+        std::size_t                numberPositions = blockEnd - blockStart;
+        std::vector<float>         costs(numberPositions + 1, std::numeric_limits<float>::infinity());
+        std::vector<std::uint16_t> lengths(numberPositions + 1, 0);
+        std::vector<std::uint16_t> distances(numberPositions + 1, 0);
+
+        costs[0] = 0;
+        std::size_t skipUntil = 0;
+        for (std::size_t i=0 ; i<numberPositions ; ++i) {
+            if (i < skipUntil) {
+                continue;
+            }
+
+            float baseCost = costs[i];
+            if (baseCost == std::numeric_limits<float>::infinity()) {
+                continue;
+            }
+
+            std::size_t position    = blockStart + i;
+            float       literalCost = baseCost + literalLengthCosts[data[position]];
+            if (literalCost < costs[i + 1]) {
+                costs[i + 1]     = literalCost;
+                lengths[i + 1]   = 1;
+                distances[i + 1] = 0;
+            }
+
+            std::size_t relative  = position - segmentStart;
+            std::uint32_t first   = matchTable.offsets[relative];
+            std::uint32_t last    = matchTable.offsets[relative + 1];
+            unsigned    available = static_cast<unsigned>(std::min(numberPositions - i, std::size_t(maximumMatchLength)));
+
+            unsigned previousLength = minimumMatchLength - 1;
+            for (std::uint32_t entry=first ; entry<last && previousLength<available ; ++entry) {
+                const Match& match        = matchTable.matches[entry];
+                unsigned     matchLength  = std::min(static_cast<unsigned>(match.length), available);
+                unsigned     distanceCode = symbolTables.distanceIndex[match.distance];
+                float        distanceCost = (
+                      baseCost
+                    + distanceSymbolCosts[distanceCode]
+                    + distanceExtraBits[distanceCode]
+                );
+
+                if (matchLength == maximumMatchLength) {
+                    // Long repeats are taken greedily, exploring every length here is quadratic and rarely helps.
+                    float cost = distanceCost + lengthCosts[matchLength];
+                    if (cost < costs[i + matchLength]) {
+                        costs[i + matchLength]     = cost;
+                        lengths[i + matchLength]   = static_cast<std::uint16_t>(matchLength);
+                        distances[i + matchLength] = match.distance;
+                    }
+
+                    skipUntil = i + matchLength;
+                } else {
+                    for (unsigned length=previousLength + 1 ; length<=matchLength ; ++length) {
+                        float cost = distanceCost + lengthCosts[length];
+                        if (cost < costs[i + length]) {
+                            costs[i + length]     = cost;
+                            lengths[i + length]   = static_cast<std::uint16_t>(length);
+                            distances[i + length] = match.distance;
+                        }
+                    }
+                }
+
+                previousLength = matchLength;
+            }
+        }
+
+        std::vector<Lz77Symbol> result;
+        std::size_t             index = numberPositions;
+        while (index > 0) {
+            std::uint16_t length = lengths[index];
+            if (distances[index] == 0) {
+                result.push_back({ data[blockStart + index - 1], 0 });
+            } else {
+                result.push_back({ length, distances[index] });
+            }
+
+            index -= length;
+        }
+
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+
+    /**
+     * Function that finds block boundaries for a run of symbols.  Ranges are recursively split at the point that
+     * minimizes the estimated encoded size.
+     *
+     * \param[in] symbols The LZ77 symbols.
+     *
+     * \return Returns the symbol indexes of each split point, in increasing order.
+     */
+    std::vector<std::size_t> findSplitPoints(const std::vector<Lz77Symbol>& symbols) {
+        std::size_t numberSymbols     = symbols.size();
+        std::size_t numberCheckpoints = (numberSymbols + splitGranularity - 1) / splitGranularity + 1;
+
+        // checkpoints[i] holds the histogram of the first min(i * splitGranularity, numberSymbols) symbols.
+        std::vector<Histogram> checkpoints(numberCheckpoints);
+        Histogram              running;
+        for (std::size_t index=0 ; index<numberSymbols ; ++index) {
+            if (index % splitGranularity == 0) {
+                checkpoints[index / splitGranularity] = running;
+            }
+
+            running.add(symbols[index]);
+        }
+
+        checkpoints[numberCheckpoints - 1] = running;
+
+        auto rangeBits = [&checkpoints](std::size_t first, std::size_t last) {
+            Histogram histogram = checkpoints[last];
+            histogram.subtract(checkpoints[first]);
+            return dynamicBlockBits(histogram);
+        };
+
+        struct Range {
+            std::size_t first;
+            std::size_t last;
+            bool        done;
+        };
+
+        std::vector<Range> ranges;
+        ranges.push_back({ 0, numberCheckpoints - 1, false });
+
+        while (ranges.size() < maximumBlocksPerSegment) {
+            std::size_t selected = ranges.size();
+            for (std::size_t index=0 ; index<ranges.size() ; ++index) {
+                const Range& range = ranges[index];
+                if (!range.done && range.last - range.first >= 2) {
+                    if (selected == ranges.size()                                                   ||
+                        range.last - range.first > ranges[selected].last - ranges[selected].first    ) {
+                        selected = index;
+                    }
+                }
+            }
+
+            if (selected == ranges.size()) {
+                break;
+            }
+
+            Range         range     = ranges[selected];
+            std::uint64_t wholeBits = rangeBits(range.first, range.last);
+            std::uint64_t bestBits  = wholeBits;
+            std::size_t   bestSplit = range.first;
+            for (std::size_t split=range.first + 1 ; split<range.last ; ++split) {
+                std::uint64_t bits = rangeBits(range.first, split) + rangeBits(split, range.last);
+                if (bits < bestBits) {
+                    bestBits  = bits;
+                    bestSplit = split;
+                }
+            }
+
+            if (bestSplit == range.first) {
+                ranges[selected].done = true;
+            } else {
+                ranges[selected].last = bestSplit;
+                ranges.push_back({ bestSplit, range.last, false });
+            }
+        }
+
+        std::vector<std::size_t> result;
+        for (const Range& range : ranges) {
+            if (range.first != 0) {
+                result.push_back(std::min(range.first * splitGranularity, numberSymbols));
+            }
+        }
+
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+
+    /**
+     * Function that writes a block of symbols using the supplied code lengths.
+     *
+     * \param[in,out] writer               The writer to receive the symbols.
+     *
+     * \param[in]     symbols              The symbols to write.
+     *
+     * \param[in]     literalLengthLengths The literal/length code lengths.
+     *
+     * \param[in]     distanceLengths      The distance code lengths.
+     */
+    void writeSymbols(
+            BitWriter&                     writer,
+            const std::vector<Lz77Symbol>& symbols,
+            const unsigned char*           literalLengthLengths,
+            const unsigned char*           distanceLengths
+        ) {
+        HuffmanCode literalLengthCode = buildCode(literalLengthLengths, numberLiteralLengthSymbols);
+        HuffmanCode distanceCode      = buildCode(distanceLengths, numberDistanceSymbols);
+
+        for (const Lz77Symbol& symbol : symbols) {
+            if (symbol.distance == 0) {
+                writer.write(
+                    literalLengthCode.codes[symbol.literalOrLength],
+                    literalLengthCode.lengths[symbol.literalOrLength]
+                );
+            } else {
+                unsigned lengthIndex = symbolTables.lengthIndex[symbol.literalOrLength];
+                writer.write(literalLengthCode.codes[257 + lengthIndex], literalLengthCode.lengths[257 + lengthIndex]);
+                writer.write(symbol.literalOrLength - lengthBase[lengthIndex], lengthExtraBits[lengthIndex]);
+
+                unsigned distanceIndex = symbolTables.distanceIndex[symbol.distance];
+                writer.write(distanceCode.codes[distanceIndex], distanceCode.lengths[distanceIndex]);
+                writer.write(symbol.distance - distanceBase[distanceIndex], distanceExtraBits[distanceIndex]);
+            }
+        }
+
+        writer.write(literalLengthCode.codes[endOfBlockSymbol], literalLengthCode.lengths[endOfBlockSymbol]);
+    }
+
+
+    /**
+     * Structure holding one encoded block.  Stored blocks must be byte aligned in the final stream so they are
+     * written when the segments are joined.
+     */
+    struct EncodedBlock {
+        /**
+         * The encoded bits for a Huffman coded block.
+         */
+        BitWriter bits;
+
+        /**
+         * Flag indicating that the block should be emitted as one or more stored blocks.
+         */
+        bool stored;
+
+        /**
+         * The offset of the first byte covered by the block.
+         */
+        std::size_t startOffset;
+
+        /**
+         * The offset just past the last byte covered by the block.
+         */
+        std::size_t endOffset;
+    };
+
+    /**
+     * Function that encodes a block, choosing the smallest of the dynamic, fixed and stored representations.
+     *
+     * \param[in] symbols     The block's symbols.
+     *
+     * \param[in] isFinal     Flag indicating that this is the final block in the stream.
+     *
+     * \param[in] startOffset The offset of the first byte covered by the block.
+     *
+     * \param[in] endOffset   The offset just past the last byte covered by the block.
+     *
+     * \return Returns the encoded block.
+     */
+    EncodedBlock encodeBlock(
+            const std::vector<Lz77Symbol>& symbols,
+            bool                           isFinal,
+            std::size_t                    startOffset,
+            std::size_t                    endOffset
+        ) {
+        Histogram histogram;
+        for (const Lz77Symbol& symbol : symbols) {
+            histogram.add(symbol);
+        }
+
+        DynamicTrees  trees(histogram);
+        std::uint64_t dynamicBits = 3 + trees.headerBits() + dataBits(
+            histogram,
+            trees.literalLengthLengths,
+            trees.distanceLengths
+        );
+
+        unsigned char fixedLiteralLengthLengths[numberLiteralLengthSymbols];
+        unsigned char fixedDistanceLengths[numberDistanceSymbols];
+        fixedLengths(fixedLiteralLengthLengths, fixedDistanceLengths);
+        std::uint64_t fixedBits = 3 + dataBits(histogram, fixedLiteralLengthLengths, fixedDistanceLengths);
+
+        std::size_t   numberBytes        = endOffset - startOffset;
+        std::size_t   numberStoredBlocks = std::max(
+            std::size_t(1),
+            (numberBytes + maximumStoredBlockSize - 1) / maximumStoredBlockSize
+        );
+        std::uint64_t storedBits         = numberStoredBlocks * (3 + 7 + 32) + 8 * numberBytes;
+
+        EncodedBlock result;
+        result.startOffset = startOffset;
+        result.endOffset   = endOffset;
+        result.stored      = storedBits < dynamicBits && storedBits < fixedBits;
+
+        if (!result.stored) {
+            result.bits.write(isFinal ? 1 : 0, 1);
+            if (fixedBits <= dynamicBits) {
+                result.bits.write(1, 2);
+                writeSymbols(result.bits, symbols, fixedLiteralLengthLengths, fixedDistanceLengths);
+            } else {
+                result.bits.write(2, 2);
+                trees.writeHeader(result.bits);
+                writeSymbols(result.bits, symbols, trees.literalLengthLengths, trees.distanceLengths);
+            }
+        }
+
+        return result;
+    }
+
+
+    /**
+     * Function that writes a run of data as stored blocks.
+     *
+     * \param[in,out] writer      The writer to receive the blocks.
+     *
+     * \param[in]     data        The buffer holding the data.
+     *
+     * \param[in]     startOffset The offset of the first byte to write.
+     *
+     * \param[in]     endOffset   The offset just past the last byte to write.
+     *
+     * \param[in]     isFinal     Flag indicating that the last stored block is the final block in the stream.
+     */
+    void writeStoredBlocks(
+            BitWriter&           writer,
+            const unsigned char* data,
+            std::size_t          startOffset,
+            std::size_t          endOffset,
+            bool                 isFinal
+        ) {
+        std::size_t offset = startOffset;
+        do {
+            std::size_t numberBytes = std::min(endOffset - offset, maximumStoredBlockSize);
+            bool        lastBlock   = (offset + numberBytes == endOffset);
+
+            writer.write(isFinal && lastBlock ? 1 : 0, 1);
+            writer.write(0, 2);
+            writer.alignToByte();
+            writer.write(static_cast<std::uint32_t>(numberBytes), 16);
+            writer.write(static_cast<std::uint32_t>(~numberBytes & 0xFFFF), 16);
+
+            for (std::size_t i=0 ; i<numberBytes ; ++i) {
+                writer.write(data[offset + i], 8);
+            }
+
+            offset += numberBytes;
+        } while (offset < endOffset);
+    }
+
+
+    /**
+     * Function that compresses one segment.
+     *
+     * \param[in] data             The buffer holding the history and the segment.
+     *
+     * \param[in] historyStart     The first byte of history available to the stream.
+     *
+     * \param[in] startOffset      The offset of the first byte in the segment.
+     *
+     * \param[in] endOffset        The offset just past the last byte in the segment.
+     *
+     * \param[in] isFinal          Flag indicating that this is the last segment in the stream.
+     *
+     * \param[in] numberIterations The number of optimal parse iterations to run on each block.
+     *
+     * \return Returns the encoded blocks.
+     */
+    std::vector<EncodedBlock> compressSegment(
+            const unsigned char* data,
+            std::size_t          historyStart,
+            std::size_t          startOffset,
+            std::size_t          endOffset,
+            bool                 isFinal,
+            unsigned             numberIterations
+        ) {
+        std::size_t windowStart = startOffset - std::min(startOffset - historyStart, windowSize);
+
+        MatchTable matchTable;
+        findMatches(data, windowStart, startOffset, endOffset, matchTable);
+
+        std::vector<Lz77Symbol>  greedySymbols = greedyParse(data, startOffset, endOffset, matchTable);
+        std::vector<std::size_t> splitPoints   = findSplitPoints(greedySymbols);
+
+        // Convert the split points from symbol indexes to byte offsets, collecting the greedy statistics used to seed
+        // the cost model of each block.
+        std::vector<std::size_t> blockOffsets(1, startOffset);
+        std::vector<Histogram>   blockStatistics(1);
+        std::size_t              offset     = startOffset;
+        std::size_t              splitIndex = 0;
+        for (std::size_t index=0 ; index<greedySymbols.size() ; ++index) {
+            if (splitIndex < splitPoints.size() && splitPoints[splitIndex] == index) {
+                blockOffsets.push_back(offset);
+                blockStatistics.push_back(Histogram());
+                ++splitIndex;
+            }
+
+            const Lz77Symbol& symbol = greedySymbols[index];
+            blockStatistics.back().add(symbol);
+            offset += symbol.distance == 0 ? 1 : symbol.literalOrLength;
+        }
+
+        blockOffsets.push_back(endOffset);
+
+        std::vector<EncodedBlock> result;
+        std::size_t               numberBlocks = blockStatistics.size();
+        for (std::size_t block=0 ; block<numberBlocks ; ++block) {
+            std::size_t blockStart = blockOffsets[block];
+            std::size_t blockEnd   = blockOffsets[block + 1];
+
+            Histogram               statistics = blockStatistics[block];
+            std::vector<Lz77Symbol> bestSymbols;
+            std::uint64_t           bestBits   = std::numeric_limits<std::uint64_t>::max();
+            for (unsigned iteration=0 ; iteration<numberIterations ; ++iteration) {
+                std::vector<Lz77Symbol> symbols = optimalParse(
+                    data,
+                    startOffset,
+                    blockStart,
+                    blockEnd,
+                    matchTable,
+                    statistics
+                );
+
+                Histogram histogram;
+                for (const Lz77Symbol& symbol : symbols) {
+                    histogram.add(symbol);
+                }
+
+                std::uint64_t bits = dynamicBlockBits(histogram);
+                if (bits < bestBits) {
+                    bestBits    = bits;
+                    bestSymbols = std::move(symbols);
+                } else if (bits == bestBits) {
+                    break;
+                }
+
+                statistics = histogram;
+            }
+
+            result.push_back(encodeBlock(bestSymbols, isFinal && block + 1 == numberBlocks, blockStart, blockEnd));
+        }
+
+        return result;
+    }
+}
+
+DeflateEncoder::DeflateEncoder(unsigned numberIterations, unsigned numberThreads) {
+    setNumberIterations(numberIterations);
+    currentNumberThreads = numberThreads;
+}
+
+
+DeflateEncoder::~DeflateEncoder() {}
+
+
+void DeflateEncoder::setNumberIterations(unsigned newNumberIterations) {
+    currentNumberIterations = std::max(newNumberIterations, 1U);
+}
+
+
+unsigned DeflateEncoder::numberIterations() const {
+    return currentNumberIterations;
+}
+
+
+void DeflateEncoder::setNumberThreads(unsigned newNumberThreads) {
+    currentNumberThreads = newNumberThreads;
+}
+
+
+unsigned DeflateEncoder::numberThreads() const {
+    return currentNumberThreads;
+}
+
+
+std::vector<unsigned char> DeflateEncoder::compressDeflate(
+        const std::vector<unsigned char>& input,
+        const std::vector<unsigned char>& dictionary
+    ) const {
+    std::vector<unsigned char> result;
+
+    if (dictionary.empty()) {
+        result = compressRegion(input.data(), 0, input.size());
+    } else {
+        std::size_t                historySize = std::min(dictionary.size(), windowSize);
+        std::vector<unsigned char> buffer(dictionary.end() - historySize, dictionary.end());
+        buffer.insert(buffer.end(), input.begin(), input.end());
+
+        result = compressRegion(buffer.data(), historySize, buffer.size());
+    }
+
+    return result;
+}
+
+
+std::vector<unsigned char> DeflateEncoder::compressZlib(
+        const std::vector<unsigned char>& input,
+        const std::vector<unsigned char>& dictionary
+    ) const {
+    // CMF selects deflate with a 32 KiB window, FLEVEL in FLG advertises maximum compression.
+    unsigned compressionMethod = 0x78;
+    unsigned flags             = 0xC0 | (dictionary.empty() ? 0x00 : 0x20);
+    flags |= 31 - ((compressionMethod * 256 + flags) % 31);
+
+    std::vector<unsigned char> result;
+    result.push_back(static_cast<unsigned char>(compressionMethod));
+    result.push_back(static_cast<unsigned char>(flags));
+
+    if (!dictionary.empty()) {
+        std::uint32_t dictionaryId = adler32(dictionary.data(), dictionary.size());
+        for (int shift=24 ; shift>=0 ; shift-=8) {
+            result.push_back(static_cast<unsigned char>(dictionaryId >> shift));
+        }
+    }
+
+    std::vector<unsigned char> deflateStream = compressDeflate(input, dictionary);
+    result.insert(result.end(), deflateStream.begin(), deflateStream.end());
+
+    std::uint32_t checksum = adler32(input.data(), input.size());
+    for (int shift=24 ; shift>=0 ; shift-=8) {
+        result.push_back(static_cast<unsigned char>(checksum >> shift));
+    }
+
+    return result;
+}
+
+
+std::vector<unsigned char> DeflateEncoder::compressQt(
+        const std::vector<unsigned char>& input,
+        const std::vector<unsigned char>& dictionary
+    ) const {
+    std::vector<unsigned char> result;
+
+    std::uint32_t inputSize = static_cast<std::uint32_t>(input.size());
+    for (int shift=24 ; shift>=0 ; shift-=8) {
+        result.push_back(static_cast<unsigned char>(inputSize >> shift));
+    }
+
+    std::vector<unsigned char> zlibStream = compressZlib(input, dictionary);
+    result.insert(result.end(), zlibStream.begin(), zlibStream.end());
+
+    return result;
+}
+
+
+std::uint32_t DeflateEncoder::adler32(const unsigned char* data, std::size_t size, std::uint32_t adler) {
+    // 5552 is the largest run that cannot overflow the 32-bit sums before the modulo is applied.
+    std::uint32_t a = adler & 0xFFFF;
+    std::uint32_t b = adler >> 16;
+
+    while (size > 0) {
+        std::size_t runLength = std::min(size, std::size_t(5552));
+        for (std::size_t i=0 ; i<runLength ; ++i) {
+            a += data[i];
+            b += a;
+        }
+
+        a    %= 65521;
+        b    %= 65521;
+        data += runLength;
+        size -= runLength;
+    }
+
+    return (b << 16) | a;
+}
+
+
+std::vector<unsigned char> DeflateEncoder::compressRegion(
+        const unsigned char* data,
+        std::size_t          startOffset,
+        std::size_t          endOffset
+    ) const {
+    BitWriter writer;
+
+    if (startOffset == endOffset) {
+        // A final fixed block holding only the end of block symbol, which is 7 zero bits.
+        writer.write(1, 1);
+        writer.write(1, 2);
+        writer.write(0, 7);
+    } else {
+        std::size_t                            numberBytes    = endOffset - startOffset;
+        std::size_t                            numberSegments = (numberBytes + segmentSize - 1) / segmentSize;
+        std::vector<std::vector<EncodedBlock>> segments(numberSegments);
+        std::atomic<std::size_t>               nextSegment(0);
+        unsigned                               numberIterations = currentNumberIterations;
+
+        auto worker = [&]() {
+            std::size_t segment = nextSegment++;
+            while (segment < numberSegments) {
+                std::size_t segmentStart = startOffset + segment * segmentSize;
+                std::size_t segmentEnd   = std::min(segmentStart + segmentSize, endOffset);
+
+                segments[segment] = compressSegment(
+                    data,
+                    0,
+                    segmentStart,
+                    segmentEnd,
+                    segment + 1 == numberSegments,
+                    numberIterations
+                );
+
+                segment = nextSegment++;
+            }
+        };
+
+        unsigned numberWorkers = static_cast<unsigned>(
+            std::min(static_cast<std::size_t>(currentNumberThreads), numberSegments)
+        );
+
+        if (numberWorkers <= 1) {
+            worker();
+        } else {
+            std::vector<std::thread> threads;
+            for (unsigned i=0 ; i<numberWorkers ; ++i) {
+                threads.push_back(std::thread(worker));
+            }
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+        }
+
+        for (std::size_t segment=0 ; segment<numberSegments ; ++segment) {
+            const std::vector<EncodedBlock>& blocks = segments[segment];
+            for (std::size_t block=0 ; block<blocks.size() ; ++block) {
+                const EncodedBlock& encodedBlock = blocks[block];
+                if (encodedBlock.stored) {
+                    bool isFinal = (segment + 1 == numberSegments && block + 1 == blocks.size());
+                    writeStoredBlocks(writer, data, encodedBlock.startOffset, encodedBlock.endOffset, isFinal);
+                } else {
+                    writer.append(encodedBlock.bits);
+                }
+            }
+        }
+    }
+
+    return writer.finish();
+}
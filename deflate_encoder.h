@@ -0,0 +1,178 @@
+/*-*-c++-*-*************************************************************************************************************
+* Copyright 2016 - 2022 Inesonic, LLC.
+*
+* This file is licensed under two licenses.
+*
+* Inesonic Commercial License, Version 1:
+*   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+*   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+*   strictly prohibited.
+*
+* GNU Public License, Version 2:
+*   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+*   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+*   version.
+*
+*   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+*   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+*   details.
+*
+*   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+*   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+********************************************************************************************************************//**
+* \file
+*
+* This header defines the \ref DeflateEncoder class.
+***********************************************************************************************************************/
+
+#ifndef DEFLATE_ENCODER_H
+#define DEFLATE_ENCODER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Class that generates deflate streams using an iterative optimal parse in the spirit of zopfli.  The encoder trades
+ * a great deal of compression time for output that is typically several percent smaller than zlib at level 9 while
+ * remaining decodable by any inflate implementation.
+ *
+ * Large inputs are divided into segments that are parsed, split into blocks and encoded on separate threads.  Matches
+ * may still reference data in the preceding segment so segmenting only costs a block boundary.
+ */
+class DeflateEncoder {
+    public:
+        /**
+         * The default number of optimal parse iterations run on each block.
+         */
+        static constexpr unsigned defaultNumberIterations = 15;
+
+        /**
+         * Constructor.
+         *
+         * \param[in] numberIterations The number of optimal parse iterations to run on each block.
+         *
+         * \param[in] numberThreads    The number of worker threads to use.  A value of 0 indicates that the encoder
+         *                             should run on the calling thread.
+         */
+        DeflateEncoder(unsigned numberIterations = defaultNumberIterations, unsigned numberThreads = 0);
+
+        ~DeflateEncoder();
+
+        /**
+         * Method you can use to change the number of optimal parse iterations.
+         *
+         * \param[in] newNumberIterations The new number of iterations.  Values below 1 are treated as 1.
+         */
+        void setNumberIterations(unsigned newNumberIterations);
+
+        /**
+         * Method you can use to obtain the number of optimal parse iterations.
+         *
+         * \return Returns the number of iterations.
+         */
+        unsigned numberIterations() const;
+
+        /**
+         * Method you can use to change the number of worker threads.
+         *
+         * \param[in] newNumberThreads The new number of worker threads.  A value of 0 indicates that the encoder should
+         *                             run on the calling thread.
+         */
+        void setNumberThreads(unsigned newNumberThreads);
+
+        /**
+         * Method you can use to obtain the number of worker threads.
+         *
+         * \return Returns the number of worker threads.
+         */
+        unsigned numberThreads() const;
+
+        /**
+         * Method that compresses data into a raw deflate stream (RFC 1951).
+         *
+         * \param[in] input      The data to be compressed.
+         *
+         * \param[in] dictionary An optional preset dictionary.  Only the last 32 KiB of the dictionary is used.
+         *
+         * \return Returns the deflate stream.
+         */
+        std::vector<unsigned char> compressDeflate(
+            const std::vector<unsigned char>& input,
+            const std::vector<unsigned char>& dictionary = std::vector<unsigned char>()
+        ) const;
+
+        /**
+         * Method that compresses data into a zlib stream (RFC 1950).
+         *
+         * \param[in] input      The data to be compressed.
+         *
+         * \param[in] dictionary An optional preset dictionary.  When supplied, the stream header carries the
+         *                       dictionary's Adler-32 identifier and the consumer must call inflateSetDictionary.
+         *
+         * \return Returns the zlib stream.
+         */
+        std::vector<unsigned char> compressZlib(
+            const std::vector<unsigned char>& input,
+            const std::vector<unsigned char>& dictionary = std::vector<unsigned char>()
+        ) const;
+
+        /**
+         * Method that compresses data into the format generated by Qt's qCompress function.  The format is a 32-bit big
+         * endian uncompressed length followed by a zlib stream.
+         *
+         * \param[in] input      The data to be compressed.
+         *
+         * \param[in] dictionary An optional preset dictionary.  Note that qUncompress can not decompress streams that
+         *                       use a preset dictionary.
+         *
+         * \return Returns the compressed data.
+         */
+        std::vector<unsigned char> compressQt(
+            const std::vector<unsigned char>& input,
+            const std::vector<unsigned char>& dictionary = std::vector<unsigned char>()
+        ) const;
+
+        /**
+         * Method that calculates an Adler-32 checksum.
+         *
+         * \param[in] data  The data to be checksummed.
+         *
+         * \param[in] size  The size of the data, in bytes.
+         *
+         * \param[in] adler The running checksum.  Use 1 for a new checksum.
+         *
+         * \return Returns the updated checksum.
+         */
+        static std::uint32_t adler32(const unsigned char* data, std::size_t size, std::uint32_t adler = 1);
+
+    private:
+        /**
+         * Method that compresses a region of a buffer.  Data ahead of the region is used only as history.
+         *
+         * \param[in] data        The buffer holding the history followed by the data to be compressed.
+         *
+         * \param[in] startOffset The offset of the first byte to be compressed.
+         *
+         * \param[in] endOffset   The offset just past the last byte to be compressed.
+         *
+         * \return Returns the deflate stream.
+         */
+        std::vector<unsigned char> compressRegion(
+            const unsigned char* data,
+            std::size_t          startOffset,
+            std::size_t          endOffset
+        ) const;
+
+        /**
+         * The number of optimal parse iterations.
+         */
+        unsigned currentNumberIterations;
+
+        /**
+         * The number of worker threads.
+         */
+        unsigned currentNumberThreads;
+};
+
+#endif
@@ -0,0 +1,1324 @@
+#!/bin/bash
+##-*-shell-script-*-####################################################################################################
+# Copyright 2016 - 2022 Inesonic, LLC
+#
+# This file is licensed under two licenses.
+#
+# Inesonic Commercial License, Version 1:
+#   All rights reserved.  Inesonic, LLC retains all rights to this software, including the right to relicense the
+#   software in source or binary formats under different terms.  Unauthorized use under the terms of this license is
+#   strictly prohibited.
+#
+# GNU Public License, Version 2:
+#   This program is free software; you can redistribute it and/or modify it under the terms of the GNU General Public
+#   License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later
+#   version.
+#
+#   This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+#   warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+#   details.
+#
+#   You should have received a copy of the GNU General Public License along with this program; if not, write to the Free
+#   Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+########################################################################################################################
+#
+# Regression tests for build_payload.  Each test generates a payload with the build_payload executable and then
+# checks the generated source or compiles and runs a small consumer against it.
+#
+# Usage:
+#   tests/run_tests.sh <build_payload executable> [ <C++ compiler> ]
+#
+# Consumers using the zstd, lz4 or xz codecs are compiled with $CXXFLAGS and linked with $LDFLAGS, which must locate
+# the codec headers and libraries.  Tests for codecs build_payload was built without are skipped.
+#
+########################################################################################################################
+
+if [ $# -lt 1 ]; then
+    echo "Usage: $0 <build_payload executable> [ <C++ compiler> ]" 1>&2
+    exit 2
+fi
+
+BUILD_PAYLOAD="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+CXX="${2:-${CXX:-g++}}"
+WORK_DIRECTORY="$(mktemp -d)"
+trap 'rm -rf "$WORK_DIRECTORY"' EXIT
+
+NUMBER_FAILED=0
+
+########################################################################################################################
+# Helpers
+#
+
+# Reports the result of a single test.
+#
+# $1 - The test name.
+# $2 - The test status, 0 on success.
+report() {
+    if [ "$2" -eq 0 ]; then
+        echo "PASS: $1"
+    else
+        echo "FAIL: $1"
+        NUMBER_FAILED=$((NUMBER_FAILED + 1))
+    fi
+}
+
+# Writes a set of small, similar, input files to the work directory.
+#
+# $1 - The directory to receive the files.
+# $2 - The number of files.
+make_inputs() {
+    mkdir -p "$1"
+    for index in $(seq 1 "$2"); do
+        printf 'payload %d %0128d\n' "$index" "$index" > "$1/f$index.dat"
+    done
+}
+
+# Compiles and links consumer.cpp, in the current directory, against the generated payload.
+#
+# $@ - Additional libraries, such as -lzstd.
+compile_consumer() {
+    "$CXX" -std=c++14 $CXXFLAGS -o consumer consumer.cpp $LDFLAGS "$@" -pthread
+}
+
+# Determines if the build_payload executable was built with support for a codec.
+#
+# $1 - The codec name.
+supports_codec() {
+    printf 'probe' | "$BUILD_PAYLOAD" --codec "$1" > /dev/null 2>&1
+}
+
+# Writes consumer.cpp which decompresses the single payload "declarations" through DecompressInto and compares it with
+# a file.
+#
+# $1 - The directory to receive the consumer.
+# $2 - The name of the file holding the expected contents, relative to the directory.
+write_round_trip_consumer() {
+    cat > "$1/consumer.cpp" <<CONSUMER
+#include "payload.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+int main() {
+    std::ifstream              file("$2", std::ios::binary);
+    std::vector<unsigned char> expected((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<unsigned char> decoded(declarationsUncompressedSize);
+
+    return declarationsDecompressInto(decoded.data(), decoded.size()) && decoded == expected ? 0 : 1;
+}
+CONSUMER
+}
+
+# Writes the start of a consumer: the payload include and a load function returning the contents of a file.
+#
+# $1 - The file to receive the consumer.
+write_consumer_prologue() {
+    cat > "$1" <<'CONSUMER'
+#include "payload.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static std::vector<unsigned char> load(const char* filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+CONSUMER
+}
+
+# Writes one CHECK(<payload>, "<file>") line for each input written by make_inputs.
+#
+# $1 - The number of inputs.
+write_checks() {
+    for index in $(seq 1 "$1"); do
+        echo "    CHECK(f${index}_datdeclarations, \"f$index.dat\");"
+    done
+}
+
+########################################################################################################################
+# Tests
+#
+
+# Packed output, with and without a perfect hash, must compile and locate every payload as C++17, where the
+# std::string_view overload of Find is emitted.
+test_packed_cxx17() {
+    local directory="$WORK_DIRECTORY/packed_cxx17"
+    local status=0
+
+    make_inputs "$directory" 16
+    cat > "$directory/consumer.cpp" <<'CONSUMER'
+#include "payload.h"
+
+#include <string>
+
+int main() {
+    int failures = 0;
+    for (int index=1 ; index<=16 ; ++index) {
+        std::string                      name   = "f" + std::to_string(index) + ".dat";
+        std::string                      prefix = "payload " + std::to_string(index) + " ";
+        const BuildPayload::PackedEntry* entry  = declarationsFind(std::string_view(name));
+        std::string                      contents(entry == nullptr ? 0 : entry->uncompressedSize, '\0');
+
+        if (entry == nullptr || !declarationsDecompress(*entry, reinterpret_cast<unsigned char*>(&contents[0]))) {
+            ++failures;
+        } else if (contents.compare(0, prefix.size(), prefix) != 0) {
+            ++failures;
+        }
+    }
+
+    return failures + (declarationsFind(std::string_view("missing.dat")) == nullptr ? 0 : 1);
+}
+CONSUMER
+
+    for switch_name in --packed --perfect-hash; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" "$switch_name" --codec none --filter delta:1 -o payload.h f*.dat 2>/dev/null &&
+            "$CXX" -std=c++17 -o consumer consumer.cpp &&
+            ./consumer
+        ) || status=1
+    done
+
+    report "packed output compiles as C++17" "$status"
+}
+
+# The --zlib-max encoder must never produce a larger payload than qCompress at level 9, including on highly
+# redundant inputs where the optimal parse loses to zlib.
+test_zlib_max_never_larger() {
+    local directory="$WORK_DIRECTORY/zlib_max"
+    local status=0
+
+    mkdir -p "$directory"
+    head -c 3000000 /dev/zero > "$directory/zeros.bin"
+    for index in $(seq 1 400000); do printf 'abc'; done > "$directory/abc.bin"
+    cp "$BASH_SOURCE" "$directory/script.txt"
+
+    for input in zeros.bin abc.bin script.txt; do
+        local default_size
+        local maximum_size
+
+        default_size=$("$BUILD_PAYLOAD" -z "$directory/$input" | sed -n 's/^.*declarationsSize = \([0-9]*\);$/\1/p')
+        maximum_size=$(
+            "$BUILD_PAYLOAD" --zlib-max "$directory/$input" | sed -n 's/^.*declarationsSize = \([0-9]*\);$/\1/p'
+        )
+
+        if [ -z "$default_size" ] || [ -z "$maximum_size" ] || [ "$maximum_size" -gt "$default_size" ]; then
+            echo "    $input: --zlib-max produced ${maximum_size:-?} bytes, -z produced ${default_size:-?} bytes"
+            status=1
+        fi
+    done
+
+    report "--zlib-max is never larger than qCompress" "$status"
+}
+
+# The --zlib-max output must not depend on the number of threads, which defaults to the number of cores of the build
+# machine.  The input spans several encoder segments.
+test_zlib_max_thread_independent() {
+    local directory="$WORK_DIRECTORY/zlib_max_threads"
+    local status=0
+
+    mkdir -p "$directory"
+    seq 1 300000 > "$directory/numbers.txt"
+
+    for threads in 1 8; do
+        "$BUILD_PAYLOAD" --zlib-max --iterations 2 --threads "$threads" -o "$directory/payload$threads.h" \
+            "$directory/numbers.txt" 2>/dev/null || status=1
+    done
+
+    cmp -s "$directory/payload1.h" "$directory/payload8.h" || status=1
+
+    report "--zlib-max output does not depend on --threads" "$status"
+}
+
+# DecompressInto must inflate qt payloads, the default codec, straight into the destination without allocating and
+# without Qt or zlib.
+test_decompress_into_no_allocation() {
+    local directory="$WORK_DIRECTORY/decompress_into"
+    local status=0
+
+    mkdir -p "$directory"
+    seq 1 200000 > "$directory/numbers.txt"
+    cp "$BASH_SOURCE" "$directory/script.txt"
+    cat > "$directory/consumer.cpp" <<'CONSUMER'
+#include "payload.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <vector>
+
+static unsigned long numberAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++numberAllocations;
+    void* result = std::malloc(size > 0 ? size : 1);
+    if (result == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return result;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+static std::vector<unsigned char> load(const char* filename) {
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+int main() {
+    std::vector<unsigned char> numbers  = load("numbers.txt");
+    std::vector<unsigned char> script   = load("script.txt");
+    std::vector<unsigned char> decoded1(numbers_txtdeclarationsUncompressedSize);
+    std::vector<unsigned char> decoded2(script_txtdeclarationsUncompressedSize);
+
+    unsigned long before  = numberAllocations;
+    bool          success = (
+           numbers_txtdeclarationsDecompressInto(decoded1.data(), decoded1.size())
+        && script_txtdeclarationsDecompressInto(decoded2.data(), decoded2.size())
+    );
+    unsigned long after   = numberAllocations;
+
+    return success && after == before && decoded1 == numbers && decoded2 == script ? 0 : 1;
+}
+CONSUMER
+
+    for switches in "" "--zlib-max --iterations 1"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" $switches --decompress-into -o payload.h numbers.txt script.txt 2>/dev/null &&
+            ! grep -q "QByteArray\|zlib.h" payload.h &&
+            "$CXX" -std=c++14 -o consumer consumer.cpp &&
+            ./consumer
+        ) || status=1
+    done
+
+    report "DecompressInto inflates qt payloads without allocating" "$status"
+}
+
+# Streaming a multi-megabyte payload must decompress it incrementally, holding no more than a few hundred kilobytes,
+# for the qt and lz4 codecs, for filtered payloads and for payloads compressed against a shared dictionary.
+test_stream_bounded_memory() {
+    local directory="$WORK_DIRECTORY/stream"
+    local status=0
+
+    mkdir -p "$directory"
+    seq 1 600000 > "$directory/numbers.txt"
+    cat > "$directory/consumer.cpp" <<'CONSUMER'
+#include "payload.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <new>
+
+static std::size_t allocated     = 0;
+static std::size_t peakAllocated = 0;
+
+void* operator new(std::size_t size) {
+    std::size_t* block = static_cast<std::size_t*>(std::malloc(size + sizeof(std::max_align_t)));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    *block     = size;
+    allocated += size;
+    if (allocated > peakAllocated) {
+        peakAllocated = allocated;
+    }
+
+    return reinterpret_cast<char*>(block) + sizeof(std::max_align_t);
+}
+
+void operator delete(void* pointer) noexcept {
+    if (pointer != nullptr) {
+        std::size_t* block = reinterpret_cast<std::size_t*>(static_cast<char*>(pointer) - sizeof(std::max_align_t));
+        allocated -= *block;
+        std::free(block);
+    }
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    operator delete(pointer);
+}
+
+int main() {
+    std::FILE* file = std::fopen("numbers.txt", "rb");
+    bool       same = (file != nullptr);
+    {
+        BuildPayload::PayloadStreamBuffer buffer(declarationsOpenStream());
+        std::istream                      stream(&buffer);
+        char                              decoded[4096];
+        char                              expected[4096];
+
+        while (same && stream.read(decoded, sizeof(decoded)).gcount() > 0) {
+            std::size_t count = static_cast<std::size_t>(stream.gcount());
+            same = (
+                   std::fread(expected, 1, count, file) == count
+                && std::memcmp(decoded, expected, count) == 0
+            );
+        }
+
+        same = same && !buffer.failed() && std::fgetc(file) == EOF;
+    }
+
+    std::printf("peak %lu\n", static_cast<unsigned long>(peakAllocated));
+    return same && peakAllocated < 512 * 1024 ? 0 : 1;
+}
+CONSUMER
+
+    local settings=("--codec qt" "--codec qt --filter delta:1" "--codec qt --train-dictionary 16384")
+    if supports_codec lz4; then
+        settings+=("--codec lz4" "--codec lz4 --filter shuffle:4")
+    fi
+
+    for switches in "${settings[@]}"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" $switches --stream -o payload.h numbers.txt 2>/dev/null &&
+            "$CXX" -std=c++14 -o consumer consumer.cpp -pthread &&
+            ./consumer > /dev/null
+        ) || { echo "  $switches"; status=1; }
+    done
+
+    report "streamed payloads are decompressed in bounded memory" "$status"
+}
+
+# Filtered payloads must round trip through DecompressInto without allocating, for shuffle element sizes with and
+# without a vectorized path and for payloads spanning several shuffle blocks, whole and chunked.
+test_filters_round_trip() {
+    local directory="$WORK_DIRECTORY/filters"
+    local status=0
+
+    mkdir -p "$directory"
+    seq 1 50001 > "$directory/numbers.txt"
+    cat > "$directory/consumer.cpp" <<'CONSUMER'
+#include "payload.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <new>
+#include <vector>
+
+static unsigned long numberAllocations = 0;
+
+void* operator new(std::size_t size) {
+    ++numberAllocations;
+    void* result = std::malloc(size > 0 ? size : 1);
+    if (result == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return result;
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+int main() {
+    std::ifstream              file("numbers.txt", std::ios::binary);
+    std::vector<unsigned char> expected((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::vector<unsigned char> decoded(declarationsUncompressedSize);
+
+    unsigned long before  = numberAllocations;
+    bool          success = declarationsDecompressInto(decoded.data(), decoded.size());
+    unsigned long after   = numberAllocations;
+
+    return success && after == before && decoded == expected ? 0 : 1;
+}
+CONSUMER
+
+    local settings=(
+        "--filter shuffle:2"
+        "--filter shuffle:3"
+        "--filter shuffle:8"
+        "--filter shuffle:16"
+        "--filter shuffle:256"
+        "--filter delta:7,x86"
+        "--filter shuffle:4,delta:1"
+        "--filter shuffle:4,delta:1 --chunk-size 65536"
+    )
+
+    for switches in "${settings[@]}"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" $switches --decompress-into -o payload.h numbers.txt 2>/dev/null &&
+            "$CXX" -std=c++14 -o consumer consumer.cpp -pthread &&
+            ./consumer
+        ) || { echo "  $switches"; status=1; }
+    done
+
+    report "filtered payloads round trip through DecompressInto" "$status"
+}
+
+# Zstandard payloads, with and without long distance matching, must decompress to the original input.
+test_zstd_round_trip() {
+    local directory="$WORK_DIRECTORY/zstd"
+    local status=0
+
+    if ! supports_codec zstd; then
+        echo "SKIP: zstd payloads round trip"
+        return
+    fi
+
+    mkdir -p "$directory"
+    seq 1 100000 > "$directory/numbers.txt"
+    write_round_trip_consumer "$directory" numbers.txt
+
+    for switches in "--level 3" "--level 19" "--long 24"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" --codec zstd $switches --decompress-into -o payload.h numbers.txt 2>/dev/null &&
+            grep -q 'declarationsCodec\[\] = "zstd"' payload.h &&
+            compile_consumer -lzstd &&
+            ./consumer
+        ) || { echo "  $switches"; status=1; }
+    done
+
+    report "zstd payloads round trip" "$status"
+}
+
+# LZ4 payloads, from both the fast and the high compression encoders, must decompress to the original input through
+# the generated LZ4 decoder, which needs no library.
+test_lz4_round_trip() {
+    local directory="$WORK_DIRECTORY/lz4"
+    local status=0
+
+    if ! supports_codec lz4; then
+        echo "SKIP: lz4 payloads round trip"
+        return
+    fi
+
+    mkdir -p "$directory"
+    seq 1 100000 > "$directory/numbers.txt"
+    write_round_trip_consumer "$directory" numbers.txt
+
+    for switches in "--level 1" "--level 9" "--level 12"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" --codec lz4 $switches --decompress-into -o payload.h numbers.txt 2>/dev/null &&
+            grep -q 'declarationsCodec\[\] = "lz4"' payload.h &&
+            compile_consumer &&
+            ./consumer
+        ) || { echo "  $switches"; status=1; }
+    done
+
+    report "lz4 payloads round trip" "$status"
+}
+
+# XZ payloads, with and without a branch filter, must decompress to the original input.
+test_xz_round_trip() {
+    local directory="$WORK_DIRECTORY/xz"
+    local status=0
+
+    if ! supports_codec xz; then
+        echo "SKIP: xz payloads round trip"
+        return
+    fi
+
+    mkdir -p "$directory"
+    seq 1 100000 > "$directory/numbers.txt"
+    write_round_trip_consumer "$directory" numbers.txt
+
+    for switches in "--level 0" "--level 9" "--bcj x86"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" --codec xz $switches --decompress-into -o payload.h numbers.txt 2>/dev/null &&
+            grep -q 'declarationsCodec\[\] = "xz"' payload.h &&
+            compile_consumer -llzma &&
+            ./consumer
+        ) || { echo "  $switches"; status=1; }
+    done
+
+    report "xz payloads round trip" "$status"
+}
+
+# Payloads compressed against a trained dictionary must decompress through both DecompressInto and the accessors.
+test_dictionary_round_trip() {
+    local directory="$WORK_DIRECTORY/dictionary"
+    local status=0
+    local codecs="qt"
+
+    if supports_codec zstd; then
+        codecs="qt zstd"
+    fi
+
+    make_inputs "$directory" 24
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+#define CHECK(payload, filename)                                                                                       \\
+    {                                                                                                                  \\
+        std::vector<unsigned char> expected = load(filename);                                                          \\
+        std::vector<unsigned char> decoded(payload##UncompressedSize);                                                 \\
+        BuildPayload::Span         span     = payload##Get();                                                          \\
+        if (!payload##DecompressInto(decoded.data(), decoded.size())                         ||                        \\
+            decoded != expected                                                              ||                        \\
+            std::vector<unsigned char>(span.data, span.data + span.size) != expected            ) {                    \\
+            ++failures;                                                                                                \\
+        }                                                                                                              \\
+    }
+
+int main() {
+    int failures = 0;
+$(write_checks 24)
+    return failures == 0 ? 0 : 1;
+}
+CONSUMER
+
+    for codec in $codecs; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" --codec "$codec" --train-dictionary 4096 --accessors --decompress-into -o payload.h \
+                f*.dat 2>/dev/null &&
+            grep -q "declarationsDictionary" payload.h &&
+            compile_consumer $([ "$codec" = zstd ] && echo -lzstd) &&
+            ./consumer
+        ) || { echo "  --codec $codec"; status=1; }
+    done
+
+    report "dictionary compressed payloads round trip" "$status"
+}
+
+# A solid payload must decompress to every input, located through the entries table, including a duplicate input.
+test_solid_round_trip() {
+    local directory="$WORK_DIRECTORY/solid"
+    local status=0
+
+    make_inputs "$directory" 12
+    cp "$directory/f3.dat" "$directory/f13.dat"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<'CONSUMER'
+int main() {
+    std::vector<unsigned char> decoded(declarationsUncompressedSize);
+    bool                       success = (
+           declarationsDecompressInto(decoded.data(), decoded.size())
+        && declarationsNumberEntries == 13
+    );
+
+    for (unsigned long index=0 ; success && index<declarationsNumberEntries ; ++index) {
+        const BuildPayload::SolidEntry& entry    = declarationsEntries[index];
+        std::vector<unsigned char>      expected = load(entry.name);
+
+        success = (
+               entry.offset + entry.length <= decoded.size()
+            && std::vector<unsigned char>(
+                   decoded.begin() + entry.offset,
+                   decoded.begin() + entry.offset + entry.length
+               ) == expected
+        );
+    }
+
+    return success ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --solid --decompress-into -o payload.h f*.dat 2>/dev/null &&
+        compile_consumer &&
+        ./consumer
+    ) || status=1
+
+    report "solid payloads round trip" "$status"
+}
+
+# Ranges read from a chunked payload, including ranges that start, end or straddle chunk boundaries, must match the
+# input.
+test_chunked_random_access() {
+    local directory="$WORK_DIRECTORY/chunked"
+    local status=0
+    local codecs="qt none"
+
+    if supports_codec lz4; then
+        codecs="$codecs lz4"
+    fi
+
+    mkdir -p "$directory"
+    seq 1 20000 > "$directory/numbers.txt"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<'CONSUMER'
+int main() {
+    std::vector<unsigned char> expected = load("numbers.txt");
+    unsigned long              size     = static_cast<unsigned long>(expected.size());
+    bool                       success  = (declarationsUncompressedSize == size);
+    unsigned long              ranges[][2] = {
+        { 0, 1 }, { 0, 4096 }, { 4095, 2 }, { 4096, 4096 }, { 1000, 10000 }, { size - 1, 1 }, { 0, size }, { 5, 0 }
+    };
+
+    for (const unsigned long* range : ranges) {
+        std::vector<unsigned char> decoded(range[1]);
+        success = (
+               success
+            && declarationsRead(range[0], range[1], decoded.data())
+            && std::equal(decoded.begin(), decoded.end(), expected.begin() + range[0])
+        );
+    }
+
+    std::vector<unsigned char> decoded(1);
+    return success && !declarationsRead(size, 1, decoded.data()) ? 0 : 1;
+}
+CONSUMER
+
+    for codec in $codecs; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" --codec "$codec" --chunk-size 4096 -o payload.h numbers.txt 2>/dev/null &&
+            compile_consumer &&
+            ./consumer
+        ) || { echo "  --codec $codec"; status=1; }
+    done
+
+    report "chunked payloads support random access" "$status"
+}
+
+# Decompressing a chunked payload in parallel, on the built in thread pool or on a caller supplied executor, must
+# reproduce the input for any thread or task count.
+test_parallel_decompression() {
+    local directory="$WORK_DIRECTORY/parallel"
+    local status=0
+
+    mkdir -p "$directory"
+    seq 1 200000 > "$directory/numbers.txt"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<'CONSUMER'
+#include <functional>
+#include <thread>
+
+int main() {
+    std::vector<unsigned char> expected = load("numbers.txt");
+    bool                       success  = true;
+
+    for (unsigned numberThreads : { 0U, 1U, 3U, 64U }) {
+        std::vector<unsigned char> decoded(declarationsUncompressedSize);
+        success = success && declarationsDecompress(decoded.data(), numberThreads) && decoded == expected;
+    }
+
+    for (unsigned numberTasks : { 0U, 2U, 16U }) {
+        std::vector<unsigned char> decoded(declarationsUncompressedSize);
+        std::vector<std::thread>   threads;
+
+        bool decompressed = declarationsDecompressOn(
+            decoded.data(),
+            [&threads](std::function<void()> task) {
+                threads.emplace_back(std::move(task));
+            },
+            numberTasks
+        );
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        success = success && decompressed && threads.size() == numberTasks && decoded == expected;
+    }
+
+    return success ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --chunk-size 16384 -o payload.h numbers.txt 2>/dev/null &&
+        compile_consumer &&
+        ./consumer
+    ) || status=1
+
+    report "chunked payloads decompress in parallel" "$status"
+}
+
+# With --store-incompressible, random data must be stored while text is still compressed, and both must round trip.
+test_store_incompressible() {
+    local directory="$WORK_DIRECTORY/incompressible"
+    local status=0
+
+    mkdir -p "$directory"
+    head -c 200000 /dev/urandom > "$directory/f1.dat"
+    seq 1 50000 > "$directory/f2.dat"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+#include <cstring>
+
+#define CHECK(payload, filename)                                                                                       \\
+    {                                                                                                                  \\
+        std::vector<unsigned char> decoded(payload##UncompressedSize);                                                 \\
+        if (!payload##DecompressInto(decoded.data(), decoded.size()) || decoded != load(filename)) {                   \\
+            ++failures;                                                                                                \\
+        }                                                                                                              \\
+    }
+
+int main() {
+    int failures = 0;
+$(write_checks 2)
+    if (std::strcmp(f1_datdeclarationsCodec, "none") != 0 || std::strcmp(f2_datdeclarationsCodec, "none") == 0) {
+        ++failures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --store-incompressible --decompress-into -o payload.h f1.dat f2.dat 2>/dev/null &&
+        compile_consumer &&
+        ./consumer
+    ) || status=1
+
+    report "incompressible payloads are stored and round trip" "$status"
+}
+
+# Identical inputs must share one compressed array, through a reference, and still decompress to their contents.
+test_deduplicated_aliases() {
+    local directory="$WORK_DIRECTORY/deduplicated"
+    local status=0
+
+    make_inputs "$directory" 4
+    seq 1 20000 > "$directory/f1.dat"
+    cp "$directory/f1.dat" "$directory/f3.dat"
+    cp "$directory/f2.dat" "$directory/f4.dat"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+#define CHECK(payload, filename)                                                                                       \\
+    {                                                                                                                  \\
+        std::vector<unsigned char> decoded(payload##UncompressedSize);                                                 \\
+        if (!payload##DecompressInto(decoded.data(), decoded.size()) || decoded != load(filename)) {                   \\
+            ++failures;                                                                                                \\
+        }                                                                                                              \\
+    }
+
+int main() {
+    int failures = 0;
+$(write_checks 4)
+    if (&f3_datdeclarations[0] != &f1_datdeclarations[0] || &f4_datdeclarations[0] != &f2_datdeclarations[0]) {
+        ++failures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+CONSUMER
+
+    for switches in "" "--chunk-size 4096"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" $switches --decompress-into -o payload.h f*.dat 2>/dev/null &&
+            [ "$(grep -c "^static const unsigned char f[0-9]_datdeclarations\[" payload.h)" -eq 2 ] &&
+            compile_consumer &&
+            ./consumer
+        ) || { echo "  $switches"; status=1; }
+    done
+
+    report "duplicate inputs share their compressed data" "$status"
+}
+
+# Inputs sharing large regions must share content defined chunks in the store and reassemble, stream to a sink and
+# stream through a decoder to their original contents.
+test_cdc_reassembly() {
+    local directory="$WORK_DIRECTORY/cdc"
+    local status=0
+
+    mkdir -p "$directory"
+    seq 1 40000 > "$directory/f1.dat"
+    { seq 1 20000; echo "inserted line"; seq 20001 40000; } > "$directory/f2.dat"
+    { seq 30000 40000; seq 1 10000; } > "$directory/f3.dat"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+#include <istream>
+
+#define CHECK(payload, filename)                                                                                       \\
+    {                                                                                                                  \\
+        std::vector<unsigned char> expected = load(filename);                                                          \\
+        std::vector<unsigned char> reassembled(payload##UncompressedSize);                                             \\
+        std::vector<unsigned char> sunk;                                                                               \\
+        std::vector<unsigned char> streamed(expected.size() + 1);                                                      \\
+        bool                       sinkSuccess = payload##Stream(                                                      \\
+            [&sunk](const unsigned char* data, unsigned long length) {                                                 \\
+                sunk.insert(sunk.end(), data, data + length);                                                          \\
+                return true;                                                                                           \\
+            }                                                                                                          \\
+        );                                                                                                             \\
+                                                                                                                       \\
+        BuildPayload::PayloadStreamBuffer buffer(payload##OpenStream());                                               \\
+        std::istream                      stream(&buffer);                                                             \\
+        stream.read(reinterpret_cast<char*>(streamed.data()), static_cast<std::streamsize>(streamed.size()));          \\
+        streamed.resize(static_cast<std::size_t>(stream.gcount()));                                                    \\
+                                                                                                                       \\
+        totalChunks += payload##Chunks.numberChunks;                                                                   \\
+        if (!payload##Reassemble(reassembled.data()) || reassembled != expected ||                                     \\
+            !sinkSuccess || sunk != expected || buffer.failed() || streamed != expected) {                             \\
+            ++failures;                                                                                                \\
+        }                                                                                                              \\
+    }
+
+int main() {
+    int           failures    = 0;
+    unsigned long totalChunks = 0;
+$(write_checks 3)
+    return failures == 0 && declarationsStore.numberChunks < totalChunks ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --cdc 2048 --stream -o payload.h f1.dat f2.dat f3.dat 2>/dev/null &&
+        compile_consumer &&
+        ./consumer
+    ) || status=1
+
+    report "content defined chunks are shared and reassemble" "$status"
+}
+
+# A delta payload must rebuild the target from its baseline, and must reject a baseline with a different size or
+# contents.
+test_delta_apply() {
+    local directory="$WORK_DIRECTORY/delta"
+    local status=0
+
+    mkdir -p "$directory"
+    seq 1 50000 > "$directory/baseline.dat"
+    { seq 1 25000; echo "changed line"; seq 25002 50000; } > "$directory/target.dat"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<'CONSUMER'
+int main() {
+    std::vector<unsigned char> baseline = load("baseline.dat");
+    std::vector<unsigned char> expected = load("target.dat");
+    std::vector<unsigned char> decoded(declarationsTargetSize);
+
+    bool applied = declarationsApply(baseline.data(), static_cast<unsigned long>(baseline.size()), decoded.data());
+    bool success = applied && decoded == expected;
+
+    bool shortRejected = !declarationsApply(
+        baseline.data(),
+        static_cast<unsigned long>(baseline.size() - 1),
+        decoded.data()
+    );
+
+    baseline[baseline.size() / 2] ^= 1;
+    bool changedRejected = !declarationsApply(
+        baseline.data(),
+        static_cast<unsigned long>(baseline.size()),
+        decoded.data()
+    );
+
+    return success && shortRejected && changedRejected ? 0 : 1;
+}
+CONSUMER
+
+    for codec in qt none; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" --codec "$codec" --baseline baseline.dat -o payload.h target.dat 2>/dev/null &&
+            compile_consumer &&
+            ./consumer
+        ) || { echo "  --codec $codec"; status=1; }
+    done
+
+    report "delta payloads apply only to their baseline" "$status"
+}
+
+# Accessors must decompress each payload once, however many threads ask for it at the same time, report the payload
+# state, and link when the header is included by more than one translation unit.
+test_accessors() {
+    local directory="$WORK_DIRECTORY/accessors"
+    local status=0
+
+    make_inputs "$directory" 2
+    seq 1 100000 > "$directory/f1.dat"
+    cat > "$directory/other.cpp" <<'CONSUMER'
+#include "payload.h"
+
+unsigned long otherSize() {
+    return f2_datdeclarationsGet().size;
+}
+CONSUMER
+
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<'CONSUMER'
+#include <thread>
+
+unsigned long otherSize();
+
+int main() {
+    bool success = (f1_datdeclarationsState() == BuildPayload::LazyPayload::PENDING);
+
+    std::vector<BuildPayload::Span> spans(8);
+    std::vector<std::thread>        threads;
+    for (unsigned index=0 ; index<spans.size() ; ++index) {
+        threads.emplace_back([&spans, index]() { spans[index] = f1_datdeclarationsGet(); });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<unsigned char> expected = load("f1.dat");
+    for (const BuildPayload::Span& span : spans) {
+        success = success && span.data == spans[0].data && span.size == expected.size();
+    }
+
+    return (
+           success
+        && std::equal(expected.begin(), expected.end(), spans[0].data)
+        && f1_datdeclarationsState() == BuildPayload::LazyPayload::READY
+        && f2_datdeclarationsState() == BuildPayload::LazyPayload::PENDING
+        && otherSize() == load("f2.dat").size()
+    ) ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --accessors -o payload.h f1.dat f2.dat 2>/dev/null &&
+        "$CXX" -std=c++14 $CXXFLAGS -o consumer consumer.cpp other.cpp $LDFLAGS -pthread &&
+        ./consumer
+    ) || status=1
+
+    report "accessors decompress once and are thread safe" "$status"
+}
+
+# Prefetching must decompress every registered payload in the background, after which each accessor reports READY
+# and returns the input, and payloads abandoned by a cancelled prefetch must still decompress on first access.
+test_prefetch() {
+    local directory="$WORK_DIRECTORY/prefetch"
+    local status=0
+
+    make_inputs "$directory" 6
+    seq 1 100000 > "$directory/f4.dat"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+#define CHECK(payload, filename)                                                                                       \\
+    {                                                                                                                  \\
+        std::vector<unsigned char> expected = load(filename);                                                          \\
+        bool                       ready    = (payload##State() == BuildPayload::LazyPayload::READY);                  \\
+        BuildPayload::Span         span     = payload##Get();                                                          \\
+        if ((prefetched && !ready) || std::vector<unsigned char>(span.data, span.data + span.size) != expected) {      \\
+            ++failures;                                                                                                \\
+        }                                                                                                              \\
+    }
+
+int main(int argumentCount, char**) {
+    int  failures   = 0;
+    bool prefetched = (argumentCount == 1);
+
+    for (unsigned long index=0 ; index<declarationsNumberPayloads ; ++index) {
+        if (declarationsRegistry[index].state() != BuildPayload::LazyPayload::PENDING) {
+            ++failures;
+        }
+    }
+
+    {
+        BuildPayload::Prefetch prefetch = declarationsPrefetchAll({ "f4.dat", "unknown.dat" }, 2);
+        if (prefetched) {
+            prefetch.wait();
+            failures += prefetch.finished() ? 0 : 1;
+        } else {
+            prefetch.cancel();
+        }
+    }
+
+$(write_checks 6)
+    return failures == 0 && declarationsNumberPayloads == 6 ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --prefetch -o payload.h f*.dat 2>/dev/null &&
+        compile_consumer &&
+        ./consumer &&
+        ./consumer cancel
+    ) || status=1
+
+    report "prefetching decompresses every payload" "$status"
+}
+
+# The payload cache must stay within its budget once handles are released, must keep pinned payloads resident above
+# the budget, and must decompress evicted payloads again on their next use.
+test_cache_eviction() {
+    local directory="$WORK_DIRECTORY/cache"
+    local status=0
+
+    make_inputs "$directory" 4
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+#define CHECK(payload, filename)                                                                                       \\
+    {                                                                                                                  \\
+        std::vector<unsigned char>  expected = load(filename);                                                         \\
+        BuildPayload::PayloadHandle handle   = payload##Acquire();                                                     \\
+        if (!handle || std::vector<unsigned char>(handle.data(), handle.data() + handle.size()) != expected) {         \\
+            ++failures;                                                                                                \\
+        }                                                                                                              \\
+    }                                                                                                                  \\
+    failures += cache.resident() <= cache.budget() ? 0 : 1;
+
+int main() {
+    int                         failures = 0;
+    BuildPayload::PayloadCache& cache    = BuildPayload::PayloadCache::instance();
+    unsigned long long          size     = load("f1.dat").size();
+
+    cache.setBudget(2 * size);
+    for (int pass=0 ; pass<2 ; ++pass) {
+$(write_checks 4 | sed 's/^/    /')
+    }
+
+    {
+        BuildPayload::PayloadHandle pinned = f1_datdeclarationsAcquire();
+        BuildPayload::PayloadHandle copy   = pinned;
+        pinned = BuildPayload::PayloadHandle();
+
+        cache.setBudget(0);
+        failures += cache.resident() == size ? 0 : 1;
+        failures += std::vector<unsigned char>(copy.data(), copy.data() + copy.size()) == load("f1.dat") ? 0 : 1;
+    }
+
+    failures += cache.resident() == 0 ? 0 : 1;
+
+    cache.setBudget(size);
+$(write_checks 4)
+
+    return failures == 0 ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --cache -o payload.h f*.dat 2>/dev/null &&
+        compile_consumer &&
+        ./consumer
+    ) || status=1
+
+    report "the payload cache evicts within its budget" "$status"
+}
+
+# Aligned payloads must start on, and fill whole, 4K pages, must accept madvise hints, including dropping their pages,
+# and must still decompress afterwards.
+test_align_advise() {
+    local directory="$WORK_DIRECTORY/align"
+    local status=0
+
+    make_inputs "$directory" 3
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+#include <cstdint>
+
+#define CHECK(payload, filename)                                                                                       \\
+    {                                                                                                                  \\
+        std::vector<unsigned char> expected = load(filename);                                                          \\
+        std::vector<unsigned char> actual(payload##UncompressedSize);                                                  \\
+        if (   reinterpret_cast<std::uintptr_t>(payload) % 4096 != 0                                                   \\
+            || sizeof(payload) % 4096 != 0                                                                             \\
+            || !payload##Advise(BuildPayload::Advice::WILL_NEED)                                                       \\
+            || !payload##Advise(BuildPayload::Advice::DONT_NEED)                                                       \\
+            || !payload##DecompressInto(actual.data(), actual.size())                                                  \\
+            || actual != expected                                                                                      \\
+           ) {                                                                                                         \\
+            ++failures;                                                                                                \\
+        }                                                                                                              \\
+    }
+
+int main() {
+    int failures = 0;
+
+$(write_checks 3)
+
+    return failures == 0 ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --align 4096 --decompress-into -o payload.h f*.dat 2>/dev/null &&
+        compile_consumer &&
+        ./consumer
+    ) || status=1
+
+    report "aligned payloads accept madvise hints" "$status"
+}
+
+# With --sections, linking with --gc-sections, and without -fdata-sections, must discard payloads the program never
+# references while keeping those it uses.  The same link without --sections must keep both, showing the discard comes
+# from the generated sections.
+test_sections_gc() {
+    local directory="$WORK_DIRECTORY/sections"
+    local status=0
+
+    if ! command -v nm > /dev/null; then
+        echo "SKIP: --gc-sections discards unreferenced payload sections"
+        return
+    fi
+
+    make_inputs "$directory" 2
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<CONSUMER
+int main() {
+    std::vector<unsigned char> actual(f1_datdeclarationsUncompressedSize);
+    return f1_datdeclarationsDecompressInto(actual.data(), actual.size()) && actual == load("f1.dat") ? 0 : 1;
+}
+CONSUMER
+
+    (
+        cd "$directory" &&
+        "$BUILD_PAYLOAD" --sections --decompress-into -t "extern const unsigned char" \
+                         -T "extern const unsigned long" -o payload.h f*.dat 2>/dev/null &&
+        compile_consumer -Wl,--gc-sections 2>/dev/null &&
+        ./consumer &&
+        nm consumer | grep -qw f1_datdeclarations &&
+        ! nm consumer | grep -qw f2_datdeclarations &&
+        ! nm consumer | grep -qw f2_datdeclarationsSize &&
+        "$BUILD_PAYLOAD" --decompress-into -t "extern const unsigned char" -T "extern const unsigned long" \
+                         -o payload.h f*.dat 2>/dev/null &&
+        compile_consumer -Wl,--gc-sections 2>/dev/null &&
+        ./consumer &&
+        nm consumer | grep -qw f2_datdeclarations
+    ) || status=1
+
+    report "--gc-sections discards unreferenced payload sections" "$status"
+}
+
+# Every payload in a packed blob must be found by name and decompress to its input, and the index must hold only
+# offsets so position independent executables place it in .rodata without dynamic relocations.
+test_packed_round_trip() {
+    local directory="$WORK_DIRECTORY/packed"
+    local status=0
+
+    if ! command -v nm > /dev/null; then
+        echo "SKIP: packed payloads round trip through a relocation free index"
+        return
+    fi
+
+    make_inputs "$directory" 5
+    seq 1 50000 > "$directory/f3.dat"
+    write_consumer_prologue "$directory/consumer.cpp"
+    cat >> "$directory/consumer.cpp" <<'CONSUMER'
+int main() {
+    int failures = 0;
+    for (unsigned long index=0 ; index<declarationsNumberEntries ; ++index) {
+        const BuildPayload::PackedEntry& entry = declarationsIndex[index];
+        const char*                      name  = declarationsName(entry);
+        std::vector<unsigned char>       actual(entry.uncompressedSize);
+
+        if (   declarationsFind(name) != &entry
+            || !declarationsDecompress(entry, actual.data())
+            || actual != load(name)
+           ) {
+            ++failures;
+        }
+    }
+
+    return failures + (declarationsNumberEntries == 5 && declarationsFind("missing.dat") == nullptr ? 0 : 1);
+}
+CONSUMER
+
+    for switches in "--packed" "--packed --filter delta:1" "--packed --codec none" "--perfect-hash"; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" $switches -o payload.h f*.dat 2>/dev/null &&
+            compile_consumer -fPIE -pie &&
+            ./consumer &&
+            nm -C consumer | grep -q ' r declarationsIndex$'
+        ) || { echo "  $switches"; status=1; }
+    done
+
+    report "packed payloads round trip through a relocation free index" "$status"
+}
+
+# The --auto-codec choice and report must depend only on the input so repeated runs generate identical output.
+test_auto_codec_reproducible() {
+    local directory="$WORK_DIRECTORY/auto_codec"
+    local status=0
+
+    mkdir -p "$directory"
+    cp "$BASH_SOURCE" "$directory/script.txt"
+
+    for run in 1 2 3; do
+        "$BUILD_PAYLOAD" --auto-codec -o "$directory/payload$run.h" "$directory/script.txt" \
+            2> "$directory/report$run.txt" || status=1
+    done
+
+    for run in 2 3; do
+        cmp -s "$directory/payload1.h" "$directory/payload$run.h" || status=1
+        cmp -s "$directory/report1.txt" "$directory/report$run.txt" || status=1
+    done
+
+    report "--auto-codec is reproducible" "$status"
+}
+
+# Payloads missing from the access profile must compile when the size type is writable, with and without --sections,
+# rather than placing writable sizes and read-only arrays in the same cold section.
+test_cold_writable_sizes() {
+    local directory="$WORK_DIRECTORY/cold_sizes"
+    local status=0
+
+    make_inputs "$directory" 4
+    echo "f1_dat" > "$directory/profile.txt"
+    printf '#include "payload.h"\n\nint main() {\n    return 0;\n}\n' > "$directory/consumer.cpp"
+
+    for switch_name in "" --sections; do
+        (
+            cd "$directory" &&
+            "$BUILD_PAYLOAD" --codec none --profile profile.txt $switch_name -T "unsigned long" -o payload.h \
+                f*.dat 2>/dev/null &&
+            "$CXX" -std=c++14 -Werror -o consumer consumer.cpp 2>/dev/null &&
+            ./consumer
+        ) || status=1
+    done
+
+    report "cold payloads compile with a writable size type" "$status"
+}
+
+########################################################################################################################
+# Main
+#
+
+test_packed_cxx17
+test_zlib_max_never_larger
+test_zlib_max_thread_independent
+test_decompress_into_no_allocation
+test_stream_bounded_memory
+test_filters_round_trip
+test_zstd_round_trip
+test_lz4_round_trip
+test_xz_round_trip
+test_dictionary_round_trip
+test_solid_round_trip
+test_chunked_random_access
+test_parallel_decompression
+test_store_incompressible
+test_deduplicated_aliases
+test_cdc_reassembly
+test_delta_apply
+test_accessors
+test_prefetch
+test_cache_eviction
+test_align_advise
+test_sections_gc
+test_packed_round_trip
+test_auto_codec_reproducible
+test_cold_writable_sizes
+
+if [ "$NUMBER_FAILED" -ne 0 ]; then
+    echo "$NUMBER_FAILED test(s) failed."
+    exit 1
+fi
+
+echo "All tests passed."
+exit 0